@@ -91,6 +91,33 @@ Level = {
         { type = "font"   , id = "pico8-font-10",               file = "./assets/fonts/pico8.ttf", font_size = 10 }
     },
 
+    ----------------------------------------------------
+    -- textures of the level packed in atlas pages, remove the cache_file to pack them on every start
+    ----------------------------------------------------
+    texture_atlas = {
+        page_size = 2048,
+        cache_file = "./assets/cache/level1-atlas"
+    },
+
+    ----------------------------------------------------
+    -- animation clips of the spritesheets, frames laid out left to right from (start_x, start_y)
+    -- loop = "loop" (default), "once" or "ping_pong"
+    ----------------------------------------------------
+    animations = {
+        [0] =
+        { id = "chopper-up",    texture_asset_id = "chopper-texture", frame_width = 32, frame_height = 32, start_y = 0, num_frames = 2, fps = 10 },
+        { id = "chopper-right", texture_asset_id = "chopper-texture", frame_width = 32, frame_height = 32, start_y = 32, num_frames = 2, fps = 10 },
+        { id = "chopper-down",  texture_asset_id = "chopper-texture", frame_width = 32, frame_height = 32, start_y = 64, num_frames = 2, fps = 10 },
+        { id = "chopper-left",  texture_asset_id = "chopper-texture", frame_width = 32, frame_height = 32, start_y = 96, num_frames = 2, fps = 10 },
+        { id = "radar", texture_asset_id = "radar-texture", frame_width = 64, frame_height = 64, num_frames = 8, fps = 7 },
+        { id = "sam-tank-left", texture_asset_id = "sam-tank-left-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 2 },
+        { id = "f22", texture_asset_id = "f22-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "su27", texture_asset_id = "su27-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "bomber", texture_asset_id = "bomber-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "fw190", texture_asset_id = "fw190-texture", frame_width = 32, frame_height = 32, num_frames = 3, fps = 15 },
+        { id = "upf7", texture_asset_id = "upf7-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 }
+    },
+
     ----------------------------------------------------
     -- table to define the map config variables
     ----------------------------------------------------
@@ -100,7 +127,30 @@ Level = {
         num_rows = 40,
         num_cols = 30,
         tile_size = 32,
-        scale = 2.0
+        -- tile columns of the tileset, a tile index of the map file is row * tileset_cols + column
+        tileset_cols = 10,
+        scale = 2.0,
+        -- width and height in tiles of the chunks the map is baked in
+        chunk_tiles = 16,
+        -- tile indices (as written in the map file, e.g. { [0] = 1, 2 }) baked into the tile collision grid,
+        -- the ground vehicles turn back at the open water
+        solid_tiles = { [0] = 21 },
+        collision_layer = "obstacles"
+    },
+
+    ----------------------------------------------------
+    -- table to define the collision layers and the layer pairs that never collide
+    ----------------------------------------------------
+    collision_layers = {
+        layers = { [0] = "default", "player", "enemies", "projectiles", "obstacles", "aircraft" },
+        ignore = {
+            [0] =
+            { "enemies", "enemies" },
+            { "projectiles", "projectiles" },
+            { "obstacles", "obstacles" },
+            -- planes fly over the solid tiles
+            { "aircraft", "obstacles" }
+        }
     },
 
     ----------------------------------------------------
@@ -130,10 +180,10 @@ Level = {
                     src_rect_y = 0
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "chopper-up"
                 },
                 boxcollider = {
+                    layer = "player",
                     width = 32,
                     height = 25,
                     offset = { x = 0, y = 5 }
@@ -152,7 +202,11 @@ Level = {
                     up_velocity = { x = 0, y = -150 },
                     right_velocity = { x = 150, y = 0 },
                     down_velocity = { x = 0, y = 150 },
-                    left_velocity = { x = -150, y = 0 }
+                    left_velocity = { x = -150, y = 0 },
+                    up_clip = "chopper-up",
+                    right_clip = "chopper-right",
+                    down_clip = "chopper-down",
+                    left_clip = "chopper-left"
                 },
                 camera_follow = {
                     follow = true
@@ -208,8 +262,7 @@ Level = {
                     fixed = true
                 },
                 animation = {
-                    num_frames = 8,
-                    speed_rate = 7 -- fps
+                    clip = "radar"
                 }
             }
         },
@@ -1338,8 +1391,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -1374,8 +1426,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -1410,8 +1461,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -1446,8 +1496,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -1670,7 +1719,8 @@ Level = {
                     texture_asset_id = "tree5-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1686,7 +1736,8 @@ Level = {
                     texture_asset_id = "tree5-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1702,7 +1753,8 @@ Level = {
                     texture_asset_id = "tree6-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1718,7 +1770,8 @@ Level = {
                     texture_asset_id = "tree14-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1734,7 +1787,8 @@ Level = {
                     texture_asset_id = "tree17-texture",
                     width = 17,
                     height = 20,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1750,7 +1804,8 @@ Level = {
                     texture_asset_id = "tree17-texture",
                     width = 17,
                     height = 20,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1782,7 +1837,8 @@ Level = {
                     texture_asset_id = "tree10-texture",
                     width = 31,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -2586,10 +2642,10 @@ Level = {
                     z_index = 4
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "f22"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 20,
                     height = 25,
                     offset = { x = 5, y = 5}
@@ -2618,10 +2674,10 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 25,
                     height = 30,
                     offset = { x = 5, y = 0 }
@@ -2647,10 +2703,10 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "bomber"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 32,
                     height = 32,
                     offset = { x = 0, y = 0 }
@@ -2679,10 +2735,10 @@ Level = {
                     z_index = 6
                 },
                 animation = {
-                    num_frames = 3,
-                    speed_rate = 15 -- fps
+                    clip = "fw190"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 32,
                     height = 30,
                     offset = { x = 0, y = 0 }
@@ -2708,8 +2764,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "upf7"
                 }
             }
         },
@@ -2729,8 +2784,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "upf7"
                 }
             }
         },
@@ -2750,8 +2804,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "upf7"
                 }
             }
         },
@@ -2775,10 +2828,10 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 32,
                     height = 32
                 },
@@ -2839,10 +2892,10 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "f22"
                 },
                 boxcollider = {
+                    layer = "aircraft",
                     width = 32,
                     height = 32
                 },
@@ -78,6 +78,29 @@ Level = {
         { type = "font"   , id = "pico8-font-10",               file = "./assets/fonts/pico8.ttf", font_size = 10 }
     },
 
+    ----------------------------------------------------
+    -- textures of the level packed in atlas pages, remove the cache_file to pack them on every start
+    ----------------------------------------------------
+    texture_atlas = {
+        page_size = 2048,
+        cache_file = "./assets/cache/level2-atlas"
+    },
+
+    ----------------------------------------------------
+    -- animation clips of the spritesheets, frames laid out left to right from (start_x, start_y)
+    -- loop = "loop" (default), "once" or "ping_pong"
+    ----------------------------------------------------
+    animations = {
+        [0] =
+        { id = "radar", texture_asset_id = "radar-texture", frame_width = 64, frame_height = 64, num_frames = 8, fps = 7 },
+        { id = "sam-tank-left", texture_asset_id = "sam-tank-left-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 2 },
+        { id = "sam-tank-right", texture_asset_id = "sam-tank-right-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 2 },
+        { id = "su27", texture_asset_id = "su27-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "fw190", texture_asset_id = "fw190-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "f22", texture_asset_id = "f22-texture", frame_width = 32, frame_height = 32, num_frames = 2, fps = 10 },
+        { id = "bomber", texture_asset_id = "bomber-texture", frame_width = 32, frame_height = 24, num_frames = 2, fps = 10 }
+    },
+
     ----------------------------------------------------
     -- table to define the map config variables
     ----------------------------------------------------
@@ -87,7 +110,27 @@ Level = {
         num_rows = 30,
         num_cols = 40,
         tile_size = 32,
-        scale = 2.0
+        -- tile columns of the tileset, a tile index of the map file is row * tileset_cols + column
+        tileset_cols = 10,
+        scale = 2.0,
+        -- width and height in tiles of the chunks the map is baked in
+        chunk_tiles = 16,
+        -- tile indices (as written in the map file, e.g. { [0] = 1, 2 }) baked into the tile collision grid
+        solid_tiles = {},
+        collision_layer = "obstacles"
+    },
+
+    ----------------------------------------------------
+    -- table to define the collision layers and the layer pairs that never collide
+    ----------------------------------------------------
+    collision_layers = {
+        layers = { [0] = "default", "player", "enemies", "projectiles", "obstacles" },
+        ignore = {
+            [0] =
+            { "enemies", "enemies" },
+            { "projectiles", "projectiles" },
+            { "obstacles", "obstacles" }
+        }
     },
 
     ----------------------------------------------------
@@ -117,6 +160,7 @@ Level = {
                     src_rect_y = 0
                 },
                 boxcollider = {
+                    layer = "player",
                     width = 32,
                     height = 25,
                     offset = { x = 0, y = 5 }
@@ -207,8 +251,7 @@ Level = {
                     fixed = true
                 },
                 animation = {
-                    num_frames = 8,
-                    speed_rate = 7 -- fps
+                    clip = "radar"
                 }
             }
         },
@@ -340,8 +383,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -376,8 +418,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -412,8 +453,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -448,8 +488,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -484,8 +523,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -520,8 +558,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-left"
                 },
                 boxcollider = {
                     width = 17,
@@ -556,8 +593,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-right"
                 },
                 boxcollider = {
                     width = 17,
@@ -593,8 +629,7 @@ Level = {
                     z_index = 2
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 2 -- fps
+                    clip = "sam-tank-right"
                 },
                 boxcollider = {
                     width = 17,
@@ -1977,7 +2012,8 @@ Level = {
                     texture_asset_id = "tree14-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -1993,7 +2029,8 @@ Level = {
                     texture_asset_id = "tree14-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -2009,7 +2046,8 @@ Level = {
                     texture_asset_id = "tree10-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -2041,7 +2079,8 @@ Level = {
                     texture_asset_id = "tree10-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -2073,7 +2112,8 @@ Level = {
                     texture_asset_id = "tree10-texture",
                     width = 32,
                     height = 32,
-                    z_index = 1
+                    z_index = 1,
+                    baked = true
                 },
             }
         },
@@ -2229,8 +2269,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
                     width = 25,
@@ -2261,8 +2300,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "fw190"
                 },
                 boxcollider = {
                     width = 25,
@@ -2293,8 +2331,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "fw190"
                 },
                 boxcollider = {
                     width = 25,
@@ -2325,8 +2362,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "fw190"
                 },
                 boxcollider = {
                     width = 25,
@@ -2357,8 +2393,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "fw190"
                 },
                 boxcollider = {
                     width = 25,
@@ -2386,8 +2421,7 @@ Level = {
                     z_index = 4
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "f22"
                 },
                 boxcollider = {
                     width = 20,
@@ -2415,8 +2449,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "bomber"
                 },
                 boxcollider = {
                     width = 32,
@@ -2447,8 +2480,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
                     width = 25,
@@ -2479,8 +2511,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
                     width = 25,
@@ -2511,8 +2542,7 @@ Level = {
                     z_index = 5
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "su27"
                 },
                 boxcollider = {
                     width = 32,
@@ -2564,8 +2594,7 @@ Level = {
                     z_index = 8
                 },
                 animation = {
-                    num_frames = 2,
-                    speed_rate = 10 -- fps
+                    clip = "bomber"
                 },
                 boxcollider = {
                     width = 32,
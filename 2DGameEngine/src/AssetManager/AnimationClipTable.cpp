@@ -0,0 +1,62 @@
+#include "AnimationClipTable.h"
+#include "../Logger/Logger.h"
+
+int AnimationClipTable::AddClip(const std::string& clipID, const std::string& assetID, const std::vector<SDL_Rect>& clipFrames, float frameRate, EAnimationLoopMode loopMode)
+{
+    if (clipFrames.empty() || frameRate <= 0.0f)
+    {
+        Logger::Err("Invalid animation clip: " + clipID);
+        return INVALID_CLIP;
+    }
+
+    AnimationClip clip;
+    clip.assetID = assetID;
+    clip.firstFrame = static_cast<int>(frames.size());
+    clip.numFrames = static_cast<int>(clipFrames.size());
+    clip.frameRate = frameRate;
+    clip.loopMode = loopMode;
+    frames.insert(frames.end(), clipFrames.begin(), clipFrames.end());
+
+    // the frames of a redefined clip stay in the table, clips are only redefined while loading
+    const auto it = clipIndices.find(clipID);
+    if (it != clipIndices.end())
+    {
+        Logger::Warn("Animation clip redefined: " + clipID);
+        clips[it->second] = clip;
+        return it->second;
+    }
+
+    clips.push_back(clip);
+    clipIndices.emplace(clipID, static_cast<int>(clips.size() - 1));
+    return static_cast<int>(clips.size() - 1);
+}
+
+int AnimationClipTable::AddStripClip(const std::string& clipID, const std::string& assetID, int startX, int startY, int frameWidth, int frameHeight, int numFrames, float frameRate, EAnimationLoopMode loopMode)
+{
+    std::vector<SDL_Rect> clipFrames;
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        clipFrames.push_back(SDL_Rect{ startX + frame * frameWidth, startY, frameWidth, frameHeight });
+    }
+    return AddClip(clipID, assetID, clipFrames, frameRate, loopMode);
+}
+
+int AnimationClipTable::GetClipIndex(const std::string& clipID) const
+{
+    const auto it = clipIndices.find(clipID);
+    return it != clipIndices.end() ? it->second : INVALID_CLIP;
+}
+
+void AnimationClipTable::Clear()
+{
+    clips.clear();
+    frames.clear();
+    clipIndices.clear();
+}
+
+EAnimationLoopMode AnimationClipTable::ParseLoopMode(const std::string& name)
+{
+    if (name == "once") return ALM_Once;
+    if (name == "ping_pong") return ALM_PingPong;
+    return ALM_Loop;
+}
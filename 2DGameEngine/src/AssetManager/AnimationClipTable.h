@@ -0,0 +1,79 @@
+#ifndef ANIMATIONCLIPTABLE_H
+#define ANIMATIONCLIPTABLE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/**
+ * What a clip does once its last frame is over.
+ */
+enum EAnimationLoopMode
+{
+    ALM_Loop,       /**< Starts again from the first frame */
+    ALM_Once,       /**< Stays on the last frame */
+    ALM_PingPong    /**< Plays backwards to the first frame, then forwards again */
+};
+
+/**
+ * Sequence of frames of a spritesheet, played at a constant rate.
+ */
+struct AnimationClip
+{
+    std::string assetID;            /**< Texture the frame rectangles belong to */
+    int firstFrame = 0;             /**< Index of the first frame in the frame table */
+    int numFrames = 0;
+    float frameRate = 1.0f;         /**< Frames per second */
+    EAnimationLoopMode loopMode = ALM_Loop;
+};
+
+/**
+ * Animation clips of the level, shared by all the entities playing them.
+ *
+ * The clips are defined once per spritesheet and referenced by index from the
+ * AnimationComponent. The frame rectangles of all the clips are stored one after
+ * the other in a single table.
+ */
+class AnimationClipTable
+{
+public:
+    static constexpr int INVALID_CLIP = -1;
+
+    /**
+     * Adds a clip made of the given frames, replacing the frames of a clip with the same id.
+     *
+     * @return The index of the clip.
+     */
+    int AddClip(const std::string& clipID, const std::string& assetID, const std::vector<SDL_Rect>& frames, float frameRate, EAnimationLoopMode loopMode);
+
+    /**
+     * Adds a clip of numFrames frames of the same size laid out left to right from (startX, startY).
+     *
+     * @return The index of the clip.
+     */
+    int AddStripClip(const std::string& clipID, const std::string& assetID, int startX, int startY, int frameWidth, int frameHeight, int numFrames, float frameRate, EAnimationLoopMode loopMode);
+
+    /**
+     * @return The index of the clip, INVALID_CLIP if there is no clip with this id.
+     */
+    int GetClipIndex(const std::string& clipID) const;
+
+    const AnimationClip& GetClip(int clipIndex) const { return clips[clipIndex]; }
+    const SDL_Rect& GetFrame(int frameIndex) const { return frames[frameIndex]; }
+    int GetNumClips() const { return static_cast<int>(clips.size()); }
+
+    void Clear();
+
+    /**
+     * Reads a loop mode name: "loop", "once" or "ping_pong", anything else loops.
+     */
+    static EAnimationLoopMode ParseLoopMode(const std::string& name);
+
+private:
+    std::vector<AnimationClip> clips;
+    std::vector<SDL_Rect> frames;
+    std::unordered_map<std::string, int> clipIndices;
+};
+
+#endif
@@ -0,0 +1,347 @@
+#include "AssetArchive.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    /**
+     * Fixed part of the file, followed by the blobs
+     */
+    struct ArchiveHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numEntries;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t indexSize;
+    };
+
+    /**
+     * Fixed part of an index record, followed by the name
+     */
+    struct IndexRecord
+    {
+        uint32_t type;
+        uint32_t nameLength;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t width;
+        uint32_t height;
+        uint32_t pitch;
+        uint32_t pixelFormat;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+AssetArchive::~AssetArchive()
+{
+    Close();
+}
+
+bool AssetArchive::Open(const std::string& path)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = GetFileSizeEx(file, &fileSize) ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    fileHandle = file;
+    mappingHandle = mapping;
+    if (!view)
+    {
+        Logger::Err("Error mapping the asset archive " + path);
+        Close();
+        return false;
+    }
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<uint64_t>(fileSize.QuadPart);
+#else
+    fileDescriptor = open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStat;
+    void* view = fstat(fileDescriptor, &fileStat) == 0 && fileStat.st_size > 0 ?
+        mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0) : MAP_FAILED;
+    if (view == MAP_FAILED)
+    {
+        Logger::Err("Error mapping the asset archive " + path);
+        Close();
+        return false;
+    }
+    data = static_cast<const uint8_t*>(view);
+    dataSize = static_cast<uint64_t>(fileStat.st_size);
+#endif
+
+    ArchiveHeader header;
+    if (dataSize < sizeof(header))
+    {
+        Logger::Err("Asset archive " + path + " is truncated");
+        Close();
+        return false;
+    }
+
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION)
+    {
+        Logger::Err("Asset archive " + path + " has an unknown format or version");
+        Close();
+        return false;
+    }
+
+    if (!ReadIndex(header.indexOffset, header.indexSize, header.numEntries))
+    {
+        Logger::Err("Asset archive " + path + " has a corrupted index");
+        Close();
+        return false;
+    }
+
+    Logger::Log("Asset archive " + path + " mapped with " + std::to_string(entries.size()) + " entries");
+    return true;
+}
+
+void AssetArchive::Close()
+{
+#if defined(_WIN32)
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    if (data) munmap(const_cast<uint8_t*>(data), static_cast<size_t>(dataSize));
+    if (fileDescriptor >= 0) close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+
+    data = nullptr;
+    dataSize = 0;
+    entries.clear();
+}
+
+const ArchiveEntry* AssetArchive::Find(const std::string& filePath) const
+{
+    if (entries.empty())
+    {
+        return nullptr;
+    }
+
+    const auto it = entries.find(NormalizePath(filePath));
+    return it != entries.end() ? &it->second : nullptr;
+}
+
+SDL_Surface* AssetArchive::CreateSurface(const ArchiveEntry& entry) const
+{
+    if (entry.type != AET_Texture)
+    {
+        return nullptr;
+    }
+
+    // SDL only reads the pixels of the surface, the mapping stays read-only
+    void* pixels = const_cast<uint8_t*>(GetData(entry));
+    return SDL_CreateRGBSurfaceWithFormatFrom(pixels, static_cast<int>(entry.width), static_cast<int>(entry.height),
+        SDL_BITSPERPIXEL(entry.pixelFormat), static_cast<int>(entry.pitch), entry.pixelFormat);
+}
+
+SDL_RWops* AssetArchive::OpenStream(const ArchiveEntry& entry) const
+{
+    return SDL_RWFromConstMem(GetData(entry), static_cast<int>(entry.size));
+}
+
+std::string AssetArchive::NormalizePath(const std::string& filePath)
+{
+    std::string normalized = filePath;
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    while (normalized.compare(0, 2, "./") == 0)
+    {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
+
+/**
+ * Every record is checked against the size of the file, a truncated archive is rejected
+ * instead of being read out of the mapping.
+ */
+bool AssetArchive::ReadIndex(uint64_t indexOffset, uint64_t indexSize, uint32_t numEntries)
+{
+    if (indexOffset > dataSize || indexSize > dataSize - indexOffset)
+    {
+        return false;
+    }
+
+    const uint8_t* cursor = data + indexOffset;
+    const uint8_t* end = cursor + indexSize;
+    entries.reserve(numEntries);
+
+    for (uint32_t i = 0; i < numEntries; i++)
+    {
+        IndexRecord record;
+        if (static_cast<size_t>(end - cursor) < sizeof(record))
+        {
+            return false;
+        }
+        std::memcpy(&record, cursor, sizeof(record));
+        cursor += sizeof(record);
+
+        if (static_cast<size_t>(end - cursor) < record.nameLength ||
+            record.offset > dataSize || record.size > dataSize - record.offset)
+        {
+            return false;
+        }
+
+        ArchiveEntry entry;
+        entry.name.assign(reinterpret_cast<const char*>(cursor), record.nameLength);
+        cursor += record.nameLength;
+        entry.type = record.type;
+        entry.offset = record.offset;
+        entry.size = record.size;
+        entry.width = record.width;
+        entry.height = record.height;
+        entry.pitch = record.pitch;
+        entry.pixelFormat = record.pixelFormat;
+
+        if (entry.type == AET_Texture && static_cast<uint64_t>(entry.pitch) * entry.height > entry.size)
+        {
+            return false;
+        }
+
+        entries.emplace(entry.name, entry);
+    }
+    return true;
+}
+
+/**
+ * The rows are copied without their padding, the pitch of the entry is the row size.
+ */
+bool AssetArchiveWriter::AddTexture(const std::string& name, SDL_Surface* surface, Uint32 pixelFormat)
+{
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, pixelFormat, 0);
+    if (!converted)
+    {
+        return false;
+    }
+
+    ArchiveEntry entry;
+    entry.name = AssetArchive::NormalizePath(name);
+    entry.type = AET_Texture;
+    entry.width = static_cast<uint32_t>(converted->w);
+    entry.height = static_cast<uint32_t>(converted->h);
+    entry.pitch = static_cast<uint32_t>(converted->w * converted->format->BytesPerPixel);
+    entry.pixelFormat = pixelFormat;
+    entry.size = static_cast<uint64_t>(entry.pitch) * entry.height;
+
+    std::vector<uint8_t> pixels(entry.size);
+    SDL_LockSurface(converted);
+    for (int row = 0; row < converted->h; row++)
+    {
+        std::memcpy(pixels.data() + row * entry.pitch, static_cast<const uint8_t*>(converted->pixels) + row * converted->pitch, entry.pitch);
+    }
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+
+    entries.push_back(entry);
+    blobs.push_back(std::move(pixels));
+    return true;
+}
+
+void AssetArchiveWriter::AddBlob(const std::string& name, EArchiveEntryType type, const void* bytes, size_t size)
+{
+    ArchiveEntry entry;
+    entry.name = AssetArchive::NormalizePath(name);
+    entry.type = type;
+    entry.size = size;
+
+    const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+    entries.push_back(entry);
+    blobs.emplace_back(begin, begin + size);
+}
+
+bool AssetArchiveWriter::Save(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        Logger::Err("Error creating the asset archive " + path);
+        return false;
+    }
+
+    // blobs first, their offsets go in the index written after them
+    std::vector<uint64_t> offsets;
+    uint64_t position = AlignUp(sizeof(ArchiveHeader), AssetArchive::BLOB_ALIGNMENT);
+    for (const auto& blob : blobs)
+    {
+        offsets.push_back(position);
+        position = AlignUp(position + blob.size(), AssetArchive::BLOB_ALIGNMENT);
+    }
+
+    ArchiveHeader header = {};
+    header.magic = AssetArchive::MAGIC;
+    header.version = AssetArchive::VERSION;
+    header.numEntries = static_cast<uint32_t>(entries.size());
+    header.indexOffset = position;
+
+    std::vector<uint8_t> index;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const ArchiveEntry& entry = entries[i];
+        IndexRecord record = {};
+        record.type = entry.type;
+        record.nameLength = static_cast<uint32_t>(entry.name.size());
+        record.offset = offsets[i];
+        record.size = blobs[i].size();
+        record.width = entry.width;
+        record.height = entry.height;
+        record.pitch = entry.pitch;
+        record.pixelFormat = entry.pixelFormat;
+
+        const uint8_t* recordBytes = reinterpret_cast<const uint8_t*>(&record);
+        index.insert(index.end(), recordBytes, recordBytes + sizeof(record));
+        index.insert(index.end(), entry.name.begin(), entry.name.end());
+    }
+    header.indexSize = index.size();
+
+    const char padding[AssetArchive::BLOB_ALIGNMENT] = {};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        file.write(padding, static_cast<std::streamsize>(offsets[i] - written));
+        file.write(reinterpret_cast<const char*>(blobs[i].data()), static_cast<std::streamsize>(blobs[i].size()));
+        written = offsets[i] + blobs[i].size();
+    }
+    file.write(padding, static_cast<std::streamsize>(header.indexOffset - written));
+    file.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+    if (!file)
+    {
+        Logger::Err("Error writing the asset archive " + path);
+        return false;
+    }
+    return true;
+}
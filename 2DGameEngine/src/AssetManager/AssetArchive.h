@@ -0,0 +1,153 @@
+#ifndef ASSETARCHIVE_H
+#define ASSETARCHIVE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/**
+ * @brief Kind of data stored by an archive entry.
+ */
+enum EArchiveEntryType : uint32_t
+{
+    AET_Texture = 1,    /**< Pixels already converted to the texture format, rows of pitch bytes */
+    AET_Font = 2,       /**< Font file as it is */
+    AET_Tilemap = 3,    /**< Tilemap file as it is */
+    AET_Script = 4,     /**< Precompiled Lua chunk */
+    AET_Level = 5       /**< Compiled level as written by the level compiler */
+};
+
+/**
+ * @brief Asset stored in an archive, found by the path of its source file.
+ */
+struct ArchiveEntry
+{
+    std::string name;
+    uint32_t type = 0;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t width = 0;         /**< Textures only */
+    uint32_t height = 0;
+    uint32_t pitch = 0;
+    uint32_t pixelFormat = 0;   /**< SDL_PixelFormatEnum of the pixels */
+};
+
+/**
+ * @class AssetArchive
+ * @brief Single file holding the assets of the game, mapped in memory and read in place.
+ *
+ * Layout: a fixed header, the blobs, each aligned on 64 bytes, then the index of the entries.
+ * Textures are stored decoded, in the pixel format chosen by the packer, so a texture is created
+ * from the mapped bytes without opening nor decompressing an image file. Fonts, tilemaps and
+ * compiled levels are stored as they are, level scripts as precompiled Lua chunks.
+ *
+ * Entries are named by the path of their source file, the paths used by the levels resolve to
+ * archive entries. The archive is written by the asset packer tool (tools/AssetPacker.cpp).
+ */
+class AssetArchive
+{
+public:
+    static constexpr uint32_t MAGIC = 0x52414547;   // "GEAR"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint64_t BLOB_ALIGNMENT = 64;
+
+    AssetArchive() = default;
+    ~AssetArchive();
+
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+
+    /**
+     * @brief Maps the archive and reads its index.
+     *
+     * @return false if the file is missing or is not a valid archive, the error is logged.
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+
+    /**
+     * @brief Finds the entry of a source file path, "./assets/x.png" and "assets/x.png" are the same entry.
+     *
+     * @return nullptr if the archive does not hold the file.
+     */
+    const ArchiveEntry* Find(const std::string& filePath) const;
+
+    const uint8_t* GetData(const ArchiveEntry& entry) const { return data + entry.offset; }
+
+    /**
+     * @brief Wraps the pixels of a texture entry in a surface, without copying them.
+     *
+     * The surface reads the mapped archive and must be freed before it is closed.
+     */
+    SDL_Surface* CreateSurface(const ArchiveEntry& entry) const;
+
+    /**
+     * @brief Opens a read stream on the bytes of an entry, for the SDL loaders taking an SDL_RWops.
+     */
+    SDL_RWops* OpenStream(const ArchiveEntry& entry) const;
+
+    size_t GetNumEntries() const { return entries.size(); }
+
+    template <typename TFunc>
+    void ForEachEntry(TFunc func) const
+    {
+        for (const auto& entry : entries)
+        {
+            func(entry.second);
+        }
+    }
+
+    /**
+     * @brief Path as stored in the index, without leading "./" and with forward slashes.
+     */
+    static std::string NormalizePath(const std::string& filePath);
+
+private:
+    bool ReadIndex(uint64_t indexOffset, uint64_t indexSize, uint32_t numEntries);
+
+    const uint8_t* data = nullptr;
+    uint64_t dataSize = 0;
+
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fileDescriptor = -1;
+#endif
+
+    std::unordered_map<std::string, ArchiveEntry> entries;
+};
+
+/**
+ * @class AssetArchiveWriter
+ * @brief Builds an archive file, used by the asset packer.
+ */
+class AssetArchiveWriter
+{
+public:
+    /**
+     * @brief Adds the pixels of a surface, converted to the given format.
+     *
+     * @return false if the conversion failed.
+     */
+    bool AddTexture(const std::string& name, SDL_Surface* surface, Uint32 pixelFormat);
+
+    void AddBlob(const std::string& name, EArchiveEntryType type, const void* bytes, size_t size);
+
+    /**
+     * @brief Writes the header, the blobs and the index.
+     */
+    bool Save(const std::string& path) const;
+
+    size_t GetNumEntries() const { return entries.size(); }
+
+private:
+    std::vector<ArchiveEntry> entries;
+    std::vector<std::vector<uint8_t>> blobs;
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef ASSETHANDLE_H
+#define ASSETHANDLE_H
+
+#include <cstdint>
+
+/**
+ * @brief Compact reference to an asset of the asset manager, resolved once from its string id.
+ *
+ * The index addresses a slot of the asset table, the generation tells whether the slot still
+ * holds the same asset: clearing the assets bumps the generations, so a handle kept across
+ * a level change is detected as stale instead of pointing to another asset.
+ *
+ * The asset type only keeps texture and font handles from being mixed up.
+ */
+template <typename TAsset>
+struct AssetHandle
+{
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    /**
+     * @brief True if the handle was resolved, it may still be stale, see AssetManager::IsValid.
+     */
+    bool IsSet() const { return index != INVALID_INDEX; }
+
+    bool operator==(const AssetHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const AssetHandle& other) const { return !(*this == other); }
+};
+
+struct TextureAsset;
+struct FontAsset;
+
+using TextureHandle = AssetHandle<TextureAsset>;
+using FontHandle = AssetHandle<FontAsset>;
+
+#endif
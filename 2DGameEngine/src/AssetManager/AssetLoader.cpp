@@ -0,0 +1,214 @@
+#include "AssetLoader.h"
+#include "AssetArchive.h"
+#include "SDL2/SDL_image.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+AssetLoader::AssetLoader(int numThreads)
+{
+    if (numThreads <= 0)
+    {
+        const int numCores = static_cast<int>(std::thread::hardware_concurrency());
+        numThreads = std::min(std::max(numCores - 1, 1), 4);
+    }
+    this->numThreads = numThreads;
+}
+
+AssetLoader::~AssetLoader()
+{
+    Cancel();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void AssetLoader::LoadImage(const std::string& assetID, const std::string& filePath)
+{
+    Submit([this, assetID, filePath]()
+    {
+        LoadedAsset loadedAsset;
+        loadedAsset.type = EAT_Texture;
+        loadedAsset.assetID = assetID;
+        loadedAsset.filePath = filePath;
+        loadedAsset.surface = DecodeImage(filePath);
+        FinishTask(loadedAsset);
+    });
+}
+
+/**
+ * Only reads the font file, an archived font is already in memory. The font is opened by the asset
+ * manager on the main thread.
+ */
+void AssetLoader::LoadFont(const std::string& assetID, const std::string& filePath, int fontSize)
+{
+    Submit([this, assetID, filePath, fontSize]()
+    {
+        LoadedAsset loadedAsset;
+        loadedAsset.type = EAT_Font;
+        loadedAsset.assetID = assetID;
+        loadedAsset.filePath = filePath;
+        loadedAsset.fontSize = fontSize;
+        if (!archive || !archive->Find(filePath))
+        {
+            std::ifstream file(filePath, std::ios::binary);
+            loadedAsset.fontData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        FinishTask(loadedAsset);
+    });
+}
+
+bool AssetLoader::PopLoaded(LoadedAsset& outAsset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (loadedAssets.empty())
+    {
+        return false;
+    }
+
+    outAsset = std::move(loadedAssets.front());
+    loadedAssets.pop_front();
+    return true;
+}
+
+bool AssetLoader::WaitLoaded(LoadedAsset& outAsset)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    taskFinished.wait(lock, [this]() { return !loadedAssets.empty() || numTasks == 0; });
+    if (loadedAssets.empty())
+    {
+        return false;
+    }
+
+    outAsset = std::move(loadedAssets.front());
+    loadedAssets.pop_front();
+    return true;
+}
+
+/**
+ * Every image is its own task, the call returns once the last one is decoded. The caller keeps
+ * the ownership of the surfaces.
+ */
+void AssetLoader::DecodeImages(const std::vector<std::string>& filePaths, std::vector<SDL_Surface*>& outSurfaces)
+{
+    outSurfaces.assign(filePaths.size(), nullptr);
+    if (filePaths.empty())
+    {
+        return;
+    }
+
+    int numRemaining = static_cast<int>(filePaths.size());
+    for (size_t i = 0; i < filePaths.size(); i++)
+    {
+        SDL_Surface** surface = &outSurfaces[i];
+        const std::string* filePath = &filePaths[i];
+        Submit([this, surface, filePath, &numRemaining]()
+        {
+            *surface = DecodeImage(*filePath);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            numRemaining--;
+            numTasks--;
+            taskFinished.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    taskFinished.wait(lock, [&numRemaining]() { return numRemaining == 0; });
+}
+
+void AssetLoader::Cancel()
+{
+    std::deque<LoadedAsset> droppedAssets;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        numTasks -= static_cast<int>(tasks.size());
+        tasks.clear();
+        taskFinished.wait(lock, [this]() { return numTasks == 0; });
+        droppedAssets.swap(loadedAssets);
+    }
+
+    for (auto& loadedAsset : droppedAssets)
+    {
+        SDL_FreeSurface(loadedAsset.surface);
+    }
+}
+
+void AssetLoader::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (workers.empty())
+        {
+            StartWorkers();
+        }
+        tasks.push_back(std::move(task));
+        numTasks++;
+    }
+    taskAvailable.notify_one();
+}
+
+void AssetLoader::FinishTask(LoadedAsset& loadedAsset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    loadedAssets.push_back(std::move(loadedAsset));
+    numTasks--;
+    taskFinished.notify_all();
+}
+
+void AssetLoader::StartWorkers()
+{
+    for (int i = 0; i < numThreads; i++)
+    {
+        workers.emplace_back(&AssetLoader::WorkerLoop, this);
+    }
+    Logger::Log("Asset loader started with " + std::to_string(numThreads) + " threads");
+}
+
+void AssetLoader::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        taskAvailable.wait(lock, [this]() { return !tasks.empty() || isStopping; });
+        if (isStopping)
+        {
+            return;
+        }
+
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+/**
+ * Archived images are already decoded, their surface reads the pixels in the mapped archive
+ */
+SDL_Surface* AssetLoader::DecodeImage(const std::string& filePath) const
+{
+    const ArchiveEntry* entry = archive ? archive->Find(filePath) : nullptr;
+    if (entry && entry->type == AET_Texture)
+    {
+        return archive->CreateSurface(*entry);
+    }
+
+    SDL_Surface* surface = IMG_Load(filePath.c_str());
+    if (!surface)
+    {
+        Logger::Err("Error loading image file: " + filePath);
+    }
+    return surface;
+}
@@ -0,0 +1,122 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SDL2/SDL.h>
+
+class AssetArchive;
+
+/**
+ * Kind of asset read by the loader.
+ */
+enum EAssetType
+{
+    EAT_Texture,
+    EAT_Font
+};
+
+/**
+ * Asset read from disk by a worker, waiting to be handed to the asset manager on the main thread.
+ */
+struct LoadedAsset
+{
+    EAssetType type = EAT_Texture;
+    std::string assetID;
+    std::string filePath;
+    SDL_Surface* surface = nullptr;     /**< Decoded image of a texture, null on failure */
+    std::vector<char> fontData;         /**< File of a font, opened on the main thread, empty for an archived font or on failure */
+    int fontSize = 0;
+};
+
+/**
+ * @class AssetLoader
+ * @brief Pool of worker threads decoding images and reading font files off the main thread.
+ *
+ * Only the CPU side of loading runs on the workers: the textures still have to be created from the
+ * decoded surfaces on the thread that owns the renderer. The fonts are opened on the main thread
+ * too, SDL_ttf shares one FreeType library between all its fonts and the main thread renders text
+ * with it every frame. Finished assets are queued in completion
+ * order and popped by the asset manager, so every asset can be used as soon as it is ready.
+ *
+ * The workers are started on the first request.
+ */
+class AssetLoader
+{
+public:
+    /**
+     * @param numThreads Number of workers, 0 for one less than the number of cores (at least 1, at most 4).
+     */
+    explicit AssetLoader(int numThreads = 0);
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    void LoadImage(const std::string& assetID, const std::string& filePath);
+    void LoadFont(const std::string& assetID, const std::string& filePath, int fontSize);
+
+    /**
+     * @brief Takes the next finished asset, without waiting.
+     *
+     * @return false if no asset is finished yet.
+     */
+    bool PopLoaded(LoadedAsset& outAsset);
+
+    /**
+     * @brief Takes the next finished asset, waiting for one if some are still loading.
+     *
+     * @return false if nothing is loading nor waiting to be taken.
+     */
+    bool WaitLoaded(LoadedAsset& outAsset);
+
+    /**
+     * @brief Decodes the images on the workers and waits for all of them.
+     *
+     * @param outSurfaces One surface per file, null for the files that could not be decoded.
+     */
+    void DecodeImages(const std::vector<std::string>& filePaths, std::vector<SDL_Surface*>& outSurfaces);
+
+    /**
+     * @brief Drops the requests not started yet, waits for the running ones and frees every finished asset.
+     */
+    void Cancel();
+
+    int GetNumThreads() const { return numThreads; }
+
+    /**
+     * @brief Reads the files held by the archive from it instead of the disk, set before any request.
+     */
+    void SetArchive(const AssetArchive* archive) { this->archive = archive; }
+
+private:
+    void Submit(std::function<void()> task);
+    void FinishTask(LoadedAsset& loadedAsset);
+    void StartWorkers();
+    void WorkerLoop();
+
+    SDL_Surface* DecodeImage(const std::string& filePath) const;
+
+    int numThreads = 1;
+    const AssetArchive* archive = nullptr;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable taskFinished;
+    std::deque<std::function<void()>> tasks;
+    std::deque<LoadedAsset> loadedAssets;
+
+    /**
+     * Tasks queued or running, the loader is idle when it drops to zero
+     */
+    int numTasks = 0;
+    bool isStopping = false;
+};
+
+#endif
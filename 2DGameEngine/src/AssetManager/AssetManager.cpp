@@ -1,6 +1,22 @@
 #include "AssetManager.h"
 #include "SDL2/SDL_image.h"
 #include "../Logger/Logger.h"
+#include <algorithm>
+
+namespace
+{
+    size_t GetTextureMemoryBytes(SDL_Texture* texture)
+    {
+        Uint32 format = 0;
+        int width = 0;
+        int height = 0;
+        if (!texture || SDL_QueryTexture(texture, &format, nullptr, &width, &height) != 0)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(width) * height * SDL_BYTESPERPIXEL(format);
+    }
+}
 
 /**
  * @brief Constructs an AssetManager object and logs its creation.
@@ -27,22 +43,43 @@ AssetManager::~AssetManager()
 /**
  * @brief Clears all loaded textures and releases associated memory.
  * 
- * Iterates through the `textures` map, destroys each SDL_Texture using `SDL_DestroyTexture`,
- * and clears the map to remove all entries.
+ * Iterates through the `textures` slots, destroys each standalone SDL_Texture using `SDL_DestroyTexture`,
+ * and frees the slots, so the handles resolved so far are detected as stale.
  */
 void AssetManager::ClearAssets()
 {
-    for (auto texture : textures)
+    loader.Cancel();    // Drop the assets still loading, their textures would outlive the level.
+    loadingProgress = AssetLoadingProgress();
+
+    textures.ForEach([](TextureHandle, TextureAsset& texture)
     {
-        SDL_DestroyTexture(texture.second); // Release the SDL_Texture from memory.
-    }
-    textures.clear();   // Clear the map of all stored textures.
+        if (texture.isStandalone)
+        {
+            SDL_DestroyTexture(texture.region.texture); // Release the SDL_Texture from memory.
+        }
+    });
+    textures.Clear();   // Free the slots, the handles given so far become stale.
+    standaloneTextureBytes = 0;
+
+    textureAtlas.Clear(); // Release the atlas pages and their regions.
 
-    for (auto font : fonts)
+    for (auto page : sharedPages)
     {
-        TTF_CloseFont(font.second);
+        SDL_DestroyTexture(page);
     }
-    fonts.clear();      // Clear the map of all stored fonts
+    sharedPages.clear();
+    shareableTextures.clear();
+
+    fonts.ForEach([](FontHandle, FontAsset& font)
+    {
+        if (font.font)
+        {
+            TTF_CloseFont(font.font);
+        }
+    });
+    fonts.Clear();      // Free the font slots
+
+    animationClips.Clear(); // Forget the animation clips of the level.
 
 }
 
@@ -58,8 +95,17 @@ void AssetManager::ClearAssets()
  */
 void AssetManager::AddTexture(SDL_Renderer* renderer, const std::string &assetID, const std::string &filePath)
 {
-    // Load the image file into an SDL_Surface.
-    SDL_Surface* surface = IMG_Load(filePath.c_str());
+    // While an atlas is being built the image is only queued, it is decoded when the atlas is packed.
+    if (textureAtlas.IsBuilding())
+    {
+        textures.Get(textures.Reserve(assetID))->filePath = filePath;
+        textureAtlas.AddImage(assetID, filePath);
+        return;
+    }
+
+    // Load the image file into an SDL_Surface, archived images are read from the mapped archive as they are.
+    const ArchiveEntry* entry = archive.Find(filePath);
+    SDL_Surface* surface = entry ? archive.CreateSurface(*entry) : IMG_Load(filePath.c_str());
     if (!surface) 
     {
         Logger::Err("Error loading image file: " + filePath);
@@ -78,31 +124,610 @@ void AssetManager::AddTexture(SDL_Renderer* renderer, const std::string &assetID
     // Free the surface after creating the texture.
     SDL_FreeSurface(surface);
 
-    // Add the texture to the map with its associated asset ID.
-    textures.emplace(assetID, texture);
+    // Store the texture in the slot of its asset ID.
+    const TextureHandle handle = textures.Reserve(assetID);
+    textures.Get(handle)->filePath = filePath;
+    SetStandaloneTexture(handle, texture);
     Logger::Log("New texture added to the asset manager with ID = " + assetID);
 }
 
 /**
  * @brief Retrieves a texture by its unique asset ID.
  * 
- * Searches the `textures` map for a texture associated with the given asset ID.
- * Returns the texture if found; if the asset ID is not found, this function may exhibit undefined behavior.
+ * Resolves the handle of the asset ID and returns its texture.
+ * Packed assets return the atlas page that holds them.
  * 
  * @param assetID The unique identifier for the texture.
- * @return SDL_Texture* Pointer to the texture associated with the asset ID.
+ * @return SDL_Texture* Pointer to the texture associated with the asset ID, or nullptr if not found.
  */
 SDL_Texture* AssetManager::GetTexture(const std::string &assetID) 
 {
-    return textures[assetID]; // Access the texture from the map by its asset ID.
+    return GetTextureRegion(textures.Find(assetID)).texture;
+}
+
+/**
+ * @brief Retrieves the texture and the rectangle of an asset.
+ * 
+ * Resolves the handle of the asset, callers drawing every frame should keep the handle instead.
+ * 
+ * @param assetID The unique identifier for the texture.
+ * @return TextureRegion of the asset, with a null texture if the asset is not found.
+ */
+TextureRegion AssetManager::GetTextureRegion(const std::string &assetID)
+{
+    return GetTextureRegion(textures.Find(assetID));
+}
+
+/**
+ * @brief Retrieves the texture and the rectangle of a handle.
+ * 
+ * Packed assets return their atlas page and sub-rectangle, standalone textures the whole texture.
+ * 
+ * @param handle Handle resolved by GetTextureHandle.
+ * @return TextureRegion of the asset, with a null texture if the handle is stale or the texture not loaded.
+ */
+const TextureRegion& AssetManager::GetTextureRegion(TextureHandle handle) const
+{
+    static const TextureRegion noRegion;
+    const TextureAsset* texture = textures.Get(handle);
+    return texture ? texture->region : noRegion;
+}
+
+/**
+ * @brief Starts queuing the textures added next into a texture atlas.
+ * 
+ * @param pageSize Width and height of the atlas pages.
+ * @param cachePath Path prefix of the persisted atlas, empty to pack it on every load.
+ */
+void AssetManager::BeginTextureAtlas(int pageSize, const std::string &cachePath)
+{
+    textureAtlas.Begin(pageSize, cachePath);
+}
+
+/**
+ * @brief Packs the queued textures into atlas pages.
+ * 
+ * Images the atlas could not take are loaded through the regular AddTexture path.
+ * 
+ * @param renderer The SDL_Renderer used to create the atlas pages.
+ */
+void AssetManager::EndTextureAtlas(SDL_Renderer* renderer)
+{
+    if (!textureAtlas.IsBuilding())
+    {
+        return;
+    }
+
+    PackTextureAtlas(TextureAtlas::GetMaxTextureSize(renderer));
+    CreateTextureAtlasPages(renderer);
+}
+
+/**
+ * @brief Packs the queued textures, the images that do not fit in a page are loaded as standalone textures.
+ * 
+ * @param maxTextureSize Largest page the renderer can create, 0 for no limit.
+ */
+void AssetManager::PackTextureAtlas(int maxTextureSize)
+{
+    if (!textureAtlas.IsBuilding())
+    {
+        return;
+    }
+
+    std::vector<TextureAtlas::StandaloneImage> standaloneImages;
+    textureAtlas.Pack(maxTextureSize, standaloneImages, &loader);
+
+    for (const auto& image : standaloneImages)
+    {
+        LoadTextureAsync(image.assetID, image.filePath);
+    }
+}
+
+/**
+ * @brief Creates the packed pages and points the slots of the packed textures to their regions.
+ * 
+ * @param renderer The SDL_Renderer used to create the atlas pages.
+ */
+void AssetManager::CreateTextureAtlasPages(SDL_Renderer* renderer)
+{
+    std::vector<TextureAtlas::StandaloneImage> standaloneImages;
+    textureAtlas.CreatePages(renderer, standaloneImages);
+
+    for (const auto& region : textureAtlas.GetRegions())
+    {
+        if (TextureAsset* texture = textures.Get(textures.Reserve(region.first)))
+        {
+            texture->region = region.second;
+            texture->isStandalone = false;
+        }
+    }
+
+    for (const auto& image : standaloneImages)
+    {
+        LoadTextureAsync(image.assetID, image.filePath);
+    }
+}
+
+/**
+ * @brief Maps the archive and hands it to the loader workers.
+ * 
+ * The packer cannot know the renderer, it stores the pixels in the format most renderers use
+ * natively. When the renderer lists its formats and this one is not among them, SDL converts
+ * the pixels on every texture creation, which is worth a warning.
+ * 
+ * @param renderer The SDL_Renderer the textures are created for.
+ * @param path Path of the archive.
+ * @return true if the archive is mounted.
+ */
+bool AssetManager::MountArchive(SDL_Renderer* renderer, const std::string &path)
+{
+    if (!archive.Open(path))
+    {
+        return false;
+    }
+    loader.SetArchive(&archive);
+
+    SDL_RendererInfo rendererInfo;
+    const ArchiveEntry* entry = nullptr;
+    if (renderer && SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && rendererInfo.num_texture_formats > 0)
+    {
+        archive.ForEachEntry([&entry](const ArchiveEntry& archiveEntry)
+        {
+            if (!entry && archiveEntry.type == AET_Texture) entry = &archiveEntry;
+        });
+
+        const Uint32* formats = rendererInfo.texture_formats;
+        const Uint32* formatsEnd = formats + rendererInfo.num_texture_formats;
+        if (entry && std::find(formats, formatsEnd, entry->pixelFormat) == formatsEnd)
+        {
+            Logger::Warn("Archived textures are " + std::string(SDL_GetPixelFormatName(entry->pixelFormat)) +
+                ", not a native format of the renderer " + std::string(rendererInfo.name) + ", repack them with --format");
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Queues the image on the loader, the texture is created by UploadLoadedAssets.
+ * 
+ * @param assetID The unique identifier to associate with the texture.
+ * @param filePath The file path of the image to load as a texture.
+ */
+void AssetManager::LoadTextureAsync(const std::string &assetID, const std::string &filePath)
+{
+    TextureAsset* texture = textures.Get(textures.Reserve(assetID));
+    texture->filePath = filePath;
+    if (textureAtlas.IsBuilding())
+    {
+        textureAtlas.AddImage(assetID, filePath);
+        return;
+    }
+
+    if (ShareTexture(*texture, assetID, filePath))
+    {
+        return;
+    }
+
+    texture->isLoading = true;
+    loader.LoadImage(assetID, filePath);
+    loadingProgress.numRequested++;
+}
+
+void AssetManager::LoadFontAsync(const std::string &assetID, const std::string &filePath, int fontSize)
+{
+    fonts.Reserve(assetID);
+    loader.LoadFont(assetID, filePath, fontSize);
+    loadingProgress.numRequested++;
+}
+
+/**
+ * @brief Hands the finished assets to the maps, in the order they were finished.
+ * 
+ * Texture creation is the only part that has to run on the render thread, so the budget
+ * only bounds how many uploads a frame pays for.
+ * 
+ * @param renderer The SDL_Renderer used to create the textures.
+ * @param budgetMs Time budget in milliseconds, 0 for no limit.
+ * @return Number of assets added.
+ */
+int AssetManager::UploadLoadedAssets(SDL_Renderer* renderer, double budgetMs)
+{
+    if (!IsLoading())
+    {
+        return 0;
+    }
+
+    const Uint64 startTime = SDL_GetPerformanceCounter();
+    const double countsPerMs = static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+
+    int numAdded = 0;
+    LoadedAsset loadedAsset;
+    while (loader.PopLoaded(loadedAsset))
+    {
+        AddLoadedAsset(renderer, loadedAsset);
+        numAdded++;
+
+        if (budgetMs > 0.0 && (SDL_GetPerformanceCounter() - startTime) / countsPerMs >= budgetMs)
+        {
+            break;
+        }
+    }
+    return numAdded;
+}
+
+void AssetManager::FinishLoading(SDL_Renderer* renderer)
+{
+    LoadedAsset loadedAsset;
+    while (loader.WaitLoaded(loadedAsset))
+    {
+        AddLoadedAsset(renderer, loadedAsset);
+    }
+}
+
+void AssetManager::AddLoadedAsset(SDL_Renderer* renderer, LoadedAsset& loadedAsset)
+{
+    if (loadedAsset.type == EAT_Font)
+    {
+        // FreeType is only used on the main thread, the font reads its glyphs from the file bytes it keeps
+        const ArchiveEntry* entry = archive.Find(loadedAsset.filePath);
+        std::vector<char>& fileData = loadedAsset.fontData;
+        TTF_Font* font = nullptr;
+        if (entry)
+        {
+            font = TTF_OpenFontRW(archive.OpenStream(*entry), 1, loadedAsset.fontSize);
+        }
+        else if (!fileData.empty())
+        {
+            font = TTF_OpenFontRW(SDL_RWFromConstMem(fileData.data(), static_cast<int>(fileData.size())), 1, loadedAsset.fontSize);
+        }
+
+        if (!font)
+        {
+            Logger::Err("Error loading font file: " + loadedAsset.filePath);
+            loadingProgress.numFailed++;
+            return;
+        }
+
+        SetFont(fonts.Reserve(loadedAsset.assetID), font, std::move(fileData));
+        loadingProgress.numLoaded++;
+        return;
+    }
+
+    const TextureHandle handle = textures.Reserve(loadedAsset.assetID);
+    textures.Get(handle)->isLoading = false;
+
+    if (!loadedAsset.surface)
+    {
+        loadingProgress.numFailed++;
+        return;
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, loadedAsset.surface);
+    SDL_FreeSurface(loadedAsset.surface);
+    if (!texture)
+    {
+        Logger::Err("Error creating texture from surface: " + loadedAsset.filePath);
+        loadingProgress.numFailed++;
+        return;
+    }
+
+    SetStandaloneTexture(handle, texture);
+    loadingProgress.numLoaded++;
+    Logger::Log("New texture added to the asset manager with ID = " + loadedAsset.assetID);
+}
+
+/**
+ * @brief Stores a standalone texture in its slot, replacing the one loaded before under the same asset ID.
+ */
+void AssetManager::SetStandaloneTexture(TextureHandle handle, SDL_Texture* texture)
+{
+    TextureAsset* textureAsset = textures.Get(handle);
+    if (textureAsset->isStandalone)
+    {
+        SDL_DestroyTexture(textureAsset->region.texture);
+        standaloneTextureBytes -= textureAsset->memoryBytes;
+    }
+
+    Uint32 format = 0;
+    textureAsset->region.texture = texture;
+    textureAsset->region.rect = { 0, 0, 0, 0 };
+    SDL_QueryTexture(texture, &format, nullptr, &textureAsset->region.rect.w, &textureAsset->region.rect.h);
+    textureAsset->isStandalone = true;
+
+    textureAsset->memoryBytes = static_cast<size_t>(textureAsset->region.rect.w) * textureAsset->region.rect.h * SDL_BYTESPERPIXEL(format);
+    standaloneTextureBytes += textureAsset->memoryBytes;
+}
+
+void AssetManager::AcquireTexture(TextureHandle handle)
+{
+    if (TextureAsset* texture = textures.Get(handle))
+    {
+        texture->refCount++;
+    }
+}
+
+void AssetManager::ReleaseTexture(TextureHandle handle)
+{
+    TextureAsset* texture = textures.Get(handle);
+    if (texture && texture->refCount > 0 && --texture->refCount == 0)
+    {
+        texture->releaseFrame = residencyFrame;
+    }
+}
+
+void AssetManager::AcquireFont(FontHandle handle)
+{
+    if (FontAsset* font = fonts.Get(handle))
+    {
+        font->refCount++;
+    }
+}
+
+void AssetManager::ReleaseFont(FontHandle handle)
+{
+    FontAsset* font = fonts.Get(handle);
+    if (font && font->refCount > 0)
+    {
+        font->refCount--;
+    }
+}
+
+/**
+ * @brief Brings back the referenced textures and trims the unreferenced ones to the budget.
+ * 
+ * The slots are few, one per texture of the level, so they are scanned every frame. Eviction
+ * candidates are only gathered when the budget is exceeded.
+ */
+void AssetManager::UpdateResidency()
+{
+    residencyFrame++;
+
+    textures.ForEach([this](TextureHandle handle, TextureAsset& texture)
+    {
+        if (texture.isStandalone && !texture.region.texture && texture.refCount > 0 && !texture.isLoading)
+        {
+            Logger::Log("Loading evicted texture " + textures.GetAssetID(handle) + " again");
+            texture.isLoading = true;
+            loader.LoadImage(textures.GetAssetID(handle), texture.filePath);
+            loadingProgress.numRequested++;
+        }
+    });
+
+    if (textureBudget == 0 || standaloneTextureBytes + GetAtlasMemoryBytes() <= textureBudget)
+    {
+        return;
+    }
+
+    std::vector<TextureAsset*> candidates;
+    textures.ForEach([&candidates](TextureHandle, TextureAsset& texture)
+    {
+        if (texture.isStandalone && texture.region.texture && texture.refCount == 0)
+        {
+            candidates.push_back(&texture);
+        }
+    });
+
+    std::sort(candidates.begin(), candidates.end(), [](const TextureAsset* a, const TextureAsset* b)
+    {
+        return a->releaseFrame < b->releaseFrame;
+    });
+
+    const size_t atlasBytes = GetAtlasMemoryBytes();
+    for (auto texture : candidates)
+    {
+        if (standaloneTextureBytes + atlasBytes <= textureBudget)
+        {
+            break;
+        }
+        EvictTexture(*texture);
+    }
+}
+
+/**
+ * @brief Destroys the texture but keeps its slot, so the handles stay valid and it can be loaded again.
+ */
+void AssetManager::EvictTexture(TextureAsset& texture)
+{
+    SDL_DestroyTexture(texture.region.texture);
+    texture.region.texture = nullptr;
+    standaloneTextureBytes -= texture.memoryBytes;
+    texture.memoryBytes = 0;
+    numEvictions++;
+}
+
+AssetMemoryStats AssetManager::GetMemoryStats() const
+{
+    AssetMemoryStats stats;
+    stats.standaloneBytes = standaloneTextureBytes;
+    stats.atlasBytes = GetAtlasMemoryBytes();
+    stats.budgetBytes = textureBudget;
+    stats.numEvictions = numEvictions;
+
+    textures.ForEach([&stats](TextureHandle, const TextureAsset& texture)
+    {
+        if (texture.isStandalone && texture.region.texture)
+        {
+            stats.numResident++;
+            if (texture.refCount == 0) stats.numUnreferenced++;
+        }
+    });
+    return stats;
+}
+
+size_t AssetManager::GetAtlasMemoryBytes() const
+{
+    size_t memoryBytes = textureAtlas.GetMemoryBytes();
+    for (auto page : sharedPages)
+    {
+        memoryBytes += GetTextureMemoryBytes(page);
+    }
+    return memoryBytes;
+}
+
+void AssetManager::GetShareableTextures(std::vector<SharedTexture>& outTextures) const
+{
+    outTextures.clear();
+    textures.ForEach([this, &outTextures](TextureHandle handle, const TextureAsset& texture)
+    {
+        if (texture.region.texture && !texture.isShared && !texture.filePath.empty())
+        {
+            outTextures.push_back({ textures.GetAssetID(handle), texture.filePath, texture.region });
+        }
+    });
+}
+
+void AssetManager::SetShareableTextures(const std::vector<SharedTexture>& sharedTextures)
+{
+    shareableTextures.clear();
+    for (const auto& sharedTexture : sharedTextures)
+    {
+        shareableTextures.emplace(sharedTexture.assetID, sharedTexture);
+    }
+}
+
+/**
+ * @brief Points the slot to the texture of the other manager when it shares the same file under the same asset ID.
+ */
+bool AssetManager::ShareTexture(TextureAsset& texture, const std::string& assetID, const std::string& filePath) const
+{
+    const auto it = shareableTextures.find(assetID);
+    if (it == shareableTextures.end() || it->second.filePath != filePath)
+    {
+        return false;
+    }
+
+    texture.region = it->second.region;
+    texture.isShared = true;
+    return true;
+}
+
+void AssetManager::HoldSharedTextures(AssetManager& owner)
+{
+    // textures loaded again must not be shared again
+    shareableTextures.clear();
+
+    int numShared = 0;
+    int numReloaded = 0;
+    textures.ForEach([this, &owner, &numShared, &numReloaded](TextureHandle handle, TextureAsset& texture)
+    {
+        if (!texture.isShared)
+        {
+            return;
+        }
+
+        const TextureHandle ownerHandle = owner.textures.Find(textures.GetAssetID(handle));
+        const TextureAsset* ownerTexture = owner.textures.Get(ownerHandle);
+        if (ownerTexture && ownerTexture->region.texture == texture.region.texture)
+        {
+            owner.AcquireTexture(ownerHandle);
+            numShared++;
+            return;
+        }
+
+        texture.isShared = false;
+        texture.region = TextureRegion();
+        LoadTextureAsync(textures.GetAssetID(handle), texture.filePath);
+        numReloaded++;
+    });
+
+    Logger::Log("Sharing " + std::to_string(numShared) + " textures, " + std::to_string(numReloaded) + " evicted ones loaded again");
+}
+
+void AssetManager::TakeSharedTextures(AssetManager& owner)
+{
+    textures.ForEach([this, &owner](TextureHandle handle, TextureAsset& texture)
+    {
+        if (!texture.isShared)
+        {
+            return;
+        }
+        texture.isShared = false;
+
+        const TextureHandle ownerHandle = owner.textures.Find(textures.GetAssetID(handle));
+        TextureAsset* ownerTexture = owner.textures.Get(ownerHandle);
+        if (!ownerTexture || ownerTexture->region.texture != texture.region.texture)
+        {
+            texture.region = TextureRegion();
+            LoadTextureAsync(textures.GetAssetID(handle), texture.filePath);
+            return;
+        }
+        owner.ReleaseTexture(ownerHandle);
+
+        if (ownerTexture->isStandalone)
+        {
+            // the owner forgets the texture, so it does not destroy it
+            owner.standaloneTextureBytes -= ownerTexture->memoryBytes;
+            ownerTexture->region.texture = nullptr;
+            ownerTexture->isStandalone = false;
+            ownerTexture->memoryBytes = 0;
+            SetStandaloneTexture(handle, texture.region.texture);
+        }
+        else if (owner.textureAtlas.ReleasePage(texture.region.texture))
+        {
+            sharedPages.push_back(texture.region.texture);
+        }
+        else
+        {
+            const auto page = std::find(owner.sharedPages.begin(), owner.sharedPages.end(), texture.region.texture);
+            if (page != owner.sharedPages.end())
+            {
+                owner.sharedPages.erase(page);
+                sharedPages.push_back(texture.region.texture);
+            }
+        }
+    });
+}
+
+void AssetManager::GetTextureMemoryInfo(std::vector<AssetMemoryInfo>& outInfo) const
+{
+    outInfo.clear();
+    textures.ForEach([this, &outInfo](TextureHandle handle, const TextureAsset& texture)
+    {
+        AssetMemoryInfo info;
+        info.assetID = textures.GetAssetID(handle);
+        info.refCount = texture.refCount;
+        info.isResident = texture.region.texture != nullptr;
+        info.isPacked = !texture.isStandalone && info.isResident;
+        info.memoryBytes = info.isPacked ? static_cast<size_t>(texture.region.rect.w) * texture.region.rect.h * 4 : texture.memoryBytes;
+        outInfo.push_back(info);
+    });
+
+    std::sort(outInfo.begin(), outInfo.end(), [](const AssetMemoryInfo& a, const AssetMemoryInfo& b)
+    {
+        return a.memoryBytes > b.memoryBytes;
+    });
+}
+
+void AssetManager::SetFont(FontHandle handle, TTF_Font* font, std::vector<char>&& fileData)
+{
+    FontAsset* fontAsset = fonts.Get(handle);
+    if (fontAsset->font)
+    {
+        TTF_CloseFont(fontAsset->font);
+    }
+    fontAsset->font = font;
+    fontAsset->fileData = std::move(fileData);
 }
 
 void AssetManager::AddFont(const std::string &assetID, const std::string &filePath, int fontSize)
 {
-    fonts.emplace(assetID, TTF_OpenFont(filePath.c_str(), fontSize));
+    const ArchiveEntry* entry = archive.Find(filePath);
+    TTF_Font* font = entry ? TTF_OpenFontRW(archive.OpenStream(*entry), 1, fontSize) : TTF_OpenFont(filePath.c_str(), fontSize);
+    if (!font)
+    {
+        Logger::Err("Error loading font file: " + filePath);
+        return;
+    }
+    SetFont(fonts.Reserve(assetID), font);
 }
 
 TTF_Font* AssetManager::GetFont(const std::string &assetID)
 {
-    return fonts[assetID];  
+    return GetFont(fonts.Find(assetID));
+}
+
+TTF_Font* AssetManager::GetFont(FontHandle handle) const
+{
+    const FontAsset* font = fonts.Get(handle);
+    return font ? font->font : nullptr;
 }
@@ -1,10 +1,92 @@
 #ifndef ASSETMANAGER_H
 #define ASSETMANAGER_H
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <SDL2/SDL.h>
 #include "SDL2/SDL_ttf.h"
+#include "TextureAtlas.h"
+#include "AnimationClipTable.h"
+#include "AssetLoader.h"
+#include "AssetHandle.h"
+#include "AssetTable.h"
+#include "AssetArchive.h"
+
+/**
+ * @brief Texture slot of the asset manager, an atlas region or a standalone texture owned by the manager.
+ */
+struct TextureAsset
+{
+    TextureRegion region;
+    bool isStandalone = false;
+    std::string filePath;           /**< Image loaded again when an evicted texture is referenced again */
+    size_t memoryBytes = 0;         /**< Width x height x bytes per pixel of the resident standalone texture */
+    int refCount = 0;               /**< Live components drawing the texture */
+    uint64_t releaseFrame = 0;      /**< Residency frame the last reference was dropped, orders the eviction */
+    bool isLoading = false;
+    bool isShared = false;          /**< Owned by another asset manager until TakeSharedTextures */
+};
+
+/**
+ * @brief Resident texture of an asset manager that another manager can use without loading it again.
+ */
+struct SharedTexture
+{
+    std::string assetID;
+    std::string filePath;
+    TextureRegion region;
+};
+
+/**
+ * @brief Font slot of the asset manager.
+ */
+struct FontAsset
+{
+    TTF_Font* font = nullptr;
+    std::vector<char> fileData;     /**< File the font reads its glyphs from, kept while it is open */
+    int refCount = 0;
+};
+
+/**
+ * @brief Memory of one texture asset, reported by GetTextureMemoryInfo.
+ */
+struct AssetMemoryInfo
+{
+    std::string assetID;
+    size_t memoryBytes = 0;     /**< Resident bytes, packed assets count their region of the atlas page */
+    int refCount = 0;
+    bool isResident = false;
+    bool isPacked = false;      /**< Part of an atlas page, released with the level only */
+};
+
+/**
+ * @brief Texture memory of the asset manager against its budget.
+ */
+struct AssetMemoryStats
+{
+    size_t standaloneBytes = 0;     /**< Resident standalone textures */
+    size_t atlasBytes = 0;          /**< Atlas pages */
+    size_t budgetBytes = 0;         /**< 0 when unlimited */
+    int numResident = 0;            /**< Standalone textures in memory */
+    int numUnreferenced = 0;        /**< Resident standalone textures no component draws, first to be evicted */
+    int numEvictions = 0;           /**< Textures evicted since the start */
+
+    size_t GetTotalBytes() const { return standaloneBytes + atlasBytes; }
+};
+
+/**
+ * @brief Progress of the assets requested through the asynchronous loading functions.
+ */
+struct AssetLoadingProgress
+{
+    int numRequested = 0;   /**< Assets requested since the last ClearAssets */
+    int numLoaded = 0;      /**< Assets ready to be used */
+    int numFailed = 0;      /**< Assets that could not be loaded */
+
+    bool IsDone() const { return numLoaded + numFailed >= numRequested; }
+    float GetRatio() const { return numRequested > 0 ? static_cast<float>(numLoaded + numFailed) / numRequested : 1.0f; }
+};
 
 /**
  * @class AssetManager
@@ -17,14 +99,71 @@ class AssetManager
 {
 private:
     /**
-     * @brief Stores loaded textures mapped to their unique asset IDs.
+     * @brief Stores the textures in slots addressed by handle, the asset IDs are only used to resolve the handles.
      * 
-     * The key is a string representing the asset ID, and the value is a pointer to the corresponding SDL_Texture.
+     * A slot is reserved as soon as its texture is requested and filled once it is loaded,
+     * packed textures point to their atlas page.
+     */
+    AssetTable<TextureAsset> textures;
+
+    AssetTable<FontAsset> fonts;
+
+    /**
+     * @brief Pages of the level textures packed together, filled between BeginTextureAtlas and EndTextureAtlas.
+     */
+    TextureAtlas textureAtlas;
+
+    /**
+     * @brief Animation clips of the level spritesheets, shared by the animated entities.
+     */
+    AnimationClipTable animationClips;
+
+    /**
+     * @brief Packed assets, read in place when mounted. Declared before the loader, whose
+     * workers read it, so it is unmapped after they are stopped.
+     */
+    AssetArchive archive;
+
+    /**
+     * @brief Workers reading the asynchronous assets and decoding the atlas images.
+     */
+    AssetLoader loader;
+
+    AssetLoadingProgress loadingProgress;
+
+    /**
+     * @brief Texture memory limit in bytes, 0 for no limit.
+     */
+    size_t textureBudget = 0;
+    size_t standaloneTextureBytes = 0;
+    int numEvictions = 0;
+
+    /**
+     * @brief Advanced by every UpdateResidency, the unreferenced textures released first are evicted first.
+     */
+    uint64_t residencyFrame = 0;
+
+    /**
+     * @brief Textures of another manager used instead of loading the same files, see SetShareableTextures.
      */
-    std::map<std::string, SDL_Texture*> textures;
+    std::unordered_map<std::string, SharedTexture> shareableTextures;
 
+    /**
+     * @brief Atlas pages of another manager taken over by TakeSharedTextures.
+     */
+    std::vector<SDL_Texture*> sharedPages;
+
+    void EvictTexture(TextureAsset& texture);
+    bool ShareTexture(TextureAsset& texture, const std::string& assetID, const std::string& filePath) const;
+    size_t GetAtlasMemoryBytes() const;
+
+    /**
+     * @brief Creates the texture or stores the font of an asset finished by the loader.
+     */
+    void AddLoadedAsset(SDL_Renderer* renderer, LoadedAsset& loadedAsset);
 
-    std::map<std::string, TTF_Font*> fonts; 
+    void SetStandaloneTexture(TextureHandle handle, SDL_Texture* texture);
+    void SetFont(FontHandle handle, TTF_Font* font, std::vector<char>&& fileData = {});
 
 public:
     /**
@@ -59,6 +198,25 @@ public:
      */
     void AddTexture(SDL_Renderer* renderer, const std::string& assetID, const std::string& filePath);
 
+    /**
+     * @brief Resolves the handle of a texture, to be kept by the caller for the lookups at draw time.
+     * 
+     * The texture only has to be requested, the handle can be resolved before it is loaded.
+     * 
+     * @param assetID The unique identifier for the texture.
+     * @return TextureHandle, not set if the texture was never requested.
+     */
+    TextureHandle GetTextureHandle(const std::string& assetID) const { return textures.Find(assetID); }
+
+    /**
+     * @brief Retrieves the texture and rectangle of a handle with an array lookup.
+     * 
+     * @return TextureRegion with a null texture if the handle is stale or the texture is not loaded yet.
+     */
+    const TextureRegion& GetTextureRegion(TextureHandle handle) const;
+
+    bool IsValid(TextureHandle handle) const { return textures.IsValid(handle); }
+
     /**
      * @brief Retrieves a texture by its unique asset ID.
      * 
@@ -69,9 +227,187 @@ public:
      */
     SDL_Texture* GetTexture(const std::string& assetID);  
 
+    /**
+     * @brief Retrieves the texture holding an asset and the rectangle it covers in it.
+     * 
+     * Packed assets return their atlas page and sub-rectangle, standalone textures the whole texture.
+     * Source rectangles of the asset have to be offset by the region position.
+     * 
+     * @param assetID The unique identifier for the texture.
+     * @return TextureRegion with a null texture if the asset is not loaded.
+     */
+    TextureRegion GetTextureRegion(const std::string& assetID);
+
+    /**
+     * @brief Starts packing the textures added next into atlas pages.
+     * 
+     * Textures added until EndTextureAtlas are only queued, they can be retrieved once the atlas is built.
+     * 
+     * @param pageSize Width and height of the atlas pages.
+     * @param cachePath Path prefix to persist the packed atlas on disk and reuse it on the next start, empty to disable.
+     */
+    void BeginTextureAtlas(int pageSize, const std::string& cachePath = "");
+
+    /**
+     * @brief Packs the queued textures and uploads the atlas pages.
+     * 
+     * Textures that do not fit in a page are loaded as standalone textures.
+     * 
+     * @param renderer The SDL_Renderer to use for creating the pages.
+     */
+    void EndTextureAtlas(SDL_Renderer* renderer);
+
+    /**
+     * @brief First half of EndTextureAtlas: decodes and packs the queued textures without the renderer.
+     * 
+     * Can run on another thread than the one owning the renderer, while nothing else uses the manager.
+     * 
+     * @param maxTextureSize Largest texture the renderer can create (TextureAtlas::GetMaxTextureSize), 0 for no limit.
+     */
+    void PackTextureAtlas(int maxTextureSize);
+
+    /**
+     * @brief Second half of EndTextureAtlas: uploads the pages packed by PackTextureAtlas.
+     */
+    void CreateTextureAtlasPages(SDL_Renderer* renderer);
+
+    /**
+     * @brief Starts loading a texture on the loader workers.
+     * 
+     * GetTexture returns nullptr until UploadLoadedAssets creates the texture. While an atlas is
+     * being built the image is queued in the atlas instead, like with AddTexture.
+     * 
+     * @param assetID The unique identifier for the texture.
+     * @param filePath The path to the image file to load as a texture.
+     */
+    void LoadTextureAsync(const std::string& assetID, const std::string& filePath);
+
+    /**
+     * @brief Starts reading a font file on the loader workers, the font is opened by UploadLoadedAssets
+     * and GetFont returns nullptr until then.
+     */
+    void LoadFontAsync(const std::string& assetID, const std::string& filePath, int fontSize);
+
+    /**
+     * @brief Creates the textures of the images decoded so far, on the thread that owns the renderer.
+     * 
+     * Stops once the time budget is spent, the remaining assets are uploaded by the next call.
+     * Asset lookups must not run on other threads during the call.
+     * 
+     * @param renderer The SDL_Renderer to use for creating the textures.
+     * @param budgetMs Time budget in milliseconds, 0 to upload everything already decoded.
+     * @return Number of assets made available.
+     */
+    int UploadLoadedAssets(SDL_Renderer* renderer, double budgetMs = 0.0);
+
+    /**
+     * @brief Waits for every asynchronous asset and uploads it.
+     */
+    void FinishLoading(SDL_Renderer* renderer);
+
+    /**
+     * @brief Adds a reference to a texture, a referenced texture is never evicted.
+     * 
+     * Components drawing a texture hold one reference each, taken by the system that draws them.
+     * An evicted texture referenced again is loaded again by the next UpdateResidency.
+     * Safe on the simulation thread while the main thread does not update the residency.
+     */
+    void AcquireTexture(TextureHandle handle);
+    void ReleaseTexture(TextureHandle handle);
+
+    void AcquireFont(FontHandle handle);
+    void ReleaseFont(FontHandle handle);
+
+    /**
+     * @brief Limits the memory of the standalone textures and atlas pages, 0 for no limit.
+     * 
+     * Over the budget, unreferenced standalone textures are evicted, least recently released first.
+     * Referenced textures and atlas pages are never evicted, so the budget can be exceeded.
+     */
+    void SetTextureBudget(size_t budgetBytes) { textureBudget = budgetBytes; }
+    size_t GetTextureBudget() const { return textureBudget; }
+
+    /**
+     * @brief Loads the evicted textures referenced again and evicts unreferenced ones while over the budget.
+     * 
+     * Called once per frame on the main thread, while nothing else reads the assets.
+     */
+    void UpdateResidency();
+
+    AssetMemoryStats GetMemoryStats() const;
+
+    /**
+     * @brief Fills the resident textures another manager can share with SetShareableTextures.
+     */
+    void GetShareableTextures(std::vector<SharedTexture>& outTextures) const;
+
+    /**
+     * @brief Textures of another manager to use instead of loading them again.
+     * 
+     * A texture requested next with the asset ID and file of a shareable texture points to the
+     * texture of the other manager instead of being loaded, the other manager still owns it.
+     * Textures queued in an atlas are not shared, the pages are packed and cached with every
+     * image of the level. Used to load a level while the previous one plays, the textures both
+     * levels use are not loaded twice.
+     */
+    void SetShareableTextures(const std::vector<SharedTexture>& sharedTextures);
+
+    /**
+     * @brief Checks the shared textures are still resident in the owner and references them there, so they are not evicted.
+     * 
+     * Textures the owner evicted since SetShareableTextures are loaded again. Called on the main
+     * thread while nothing else uses the managers.
+     */
+    void HoldSharedTextures(AssetManager& owner);
+
+    /**
+     * @brief Takes the ownership of the shared textures from their owner, which is about to be destroyed.
+     * 
+     * Standalone textures move to this manager, atlas pages holding a shared region are taken whole.
+     * Called on the main thread while nothing else uses the managers.
+     */
+    void TakeSharedTextures(AssetManager& owner);
+
+    /**
+     * @brief Fills the memory of every texture asset, biggest first.
+     */
+    void GetTextureMemoryInfo(std::vector<AssetMemoryInfo>& outInfo) const;
+
+    /**
+     * @brief Maps a packed asset archive, the files it holds are then read from it.
+     * 
+     * Has to be mounted before any asset is requested.
+     * 
+     * @param renderer The renderer the textures are created for, warns when the archive pixel format needs a conversion.
+     * @param path Path of the archive written by the asset packer.
+     * @return false if the archive could not be mapped, the assets are then read from their files.
+     */
+    bool MountArchive(SDL_Renderer* renderer, const std::string& path);
+
+    /**
+     * @brief Finds a file in the mounted archive.
+     * 
+     * @return nullptr if no archive is mounted or it does not hold the file.
+     */
+    const ArchiveEntry* FindArchivedFile(const std::string& filePath) const { return archive.Find(filePath); }
+    const uint8_t* GetArchivedData(const ArchiveEntry& entry) const { return archive.GetData(entry); }
+
+    const AssetLoadingProgress& GetLoadingProgress() const { return loadingProgress; }
+    bool IsLoading() const { return !loadingProgress.IsDone(); }
+
+
+    /**
+     * @brief Retrieves the animation clips of the level, filled by the level loader.
+     */
+    AnimationClipTable& GetAnimationClips() { return animationClips; }
+    const AnimationClipTable& GetAnimationClips() const { return animationClips; }
 
     void AddFont(const std::string& assetID, const std::string& filePath, int fontSize);  
     TTF_Font* GetFont(const std::string& assetID);
+
+    FontHandle GetFontHandle(const std::string& assetID) const { return fonts.Find(assetID); }
+    TTF_Font* GetFont(FontHandle handle) const;
+    bool IsValid(FontHandle handle) const { return fonts.IsValid(handle); }
 };
 
 
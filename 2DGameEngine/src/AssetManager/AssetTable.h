@@ -0,0 +1,163 @@
+#ifndef ASSETTABLE_H
+#define ASSETTABLE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AssetHandle.h"
+
+/**
+ * @class AssetTable
+ * @brief Assets of one type stored in slots, looked up by handle in constant time.
+ *
+ * The string ids are only hashed when a handle is resolved, drawing code keeps the handle and
+ * indexes the slot array. A slot is reserved when its asset is requested, before it is loaded,
+ * so handles can be resolved while the asset is still loading and see it once it is there.
+ *
+ * Clear frees every slot for reuse with a new generation, which invalidates the handles given so far.
+ */
+template <typename TAsset>
+class AssetTable
+{
+public:
+    using Handle = AssetHandle<TAsset>;
+
+    /**
+     * @brief Finds the slot of the asset id, or takes a free one for it.
+     */
+    Handle Reserve(const std::string& assetID)
+    {
+        const auto it = indices.find(assetID);
+        if (it != indices.end())
+        {
+            return MakeHandle(it->second);
+        }
+
+        uint32_t index;
+        if (!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        Slot& slot = slots[index];
+        slot.assetID = assetID;
+        slot.asset = TAsset();
+        slot.isUsed = true;
+        indices.emplace(assetID, index);
+        return MakeHandle(index);
+    }
+
+    /**
+     * @brief Finds the slot of the asset id, without reserving one.
+     *
+     * @return A handle that is not set if the asset was never requested.
+     */
+    Handle Find(const std::string& assetID) const
+    {
+        const auto it = indices.find(assetID);
+        return it != indices.end() ? MakeHandle(it->second) : Handle();
+    }
+
+    bool IsValid(Handle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].isUsed && slots[handle.index].generation == handle.generation;
+    }
+
+    /**
+     * @return The asset of the handle, nullptr if the handle is stale.
+     */
+    TAsset* Get(Handle handle)
+    {
+        return IsValid(handle) ? &slots[handle.index].asset : nullptr;
+    }
+
+    const TAsset* Get(Handle handle) const
+    {
+        return IsValid(handle) ? &slots[handle.index].asset : nullptr;
+    }
+
+    const std::string& GetAssetID(Handle handle) const
+    {
+        static const std::string noAssetID;
+        return IsValid(handle) ? slots[handle.index].assetID : noAssetID;
+    }
+
+    /**
+     * @brief Calls func(handle, asset) for every reserved slot.
+     */
+    template <typename TFunc>
+    void ForEach(TFunc func)
+    {
+        for (uint32_t index = 0; index < slots.size(); index++)
+        {
+            if (slots[index].isUsed)
+            {
+                func(MakeHandle(index), slots[index].asset);
+            }
+        }
+    }
+
+    template <typename TFunc>
+    void ForEach(TFunc func) const
+    {
+        for (uint32_t index = 0; index < slots.size(); index++)
+        {
+            if (slots[index].isUsed)
+            {
+                func(MakeHandle(index), slots[index].asset);
+            }
+        }
+    }
+
+    /**
+     * @brief Frees every slot, the handles given so far become stale. The assets have to be released first.
+     */
+    void Clear()
+    {
+        freeSlots.clear();
+        for (uint32_t index = 0; index < slots.size(); index++)
+        {
+            Slot& slot = slots[index];
+            if (slot.isUsed)
+            {
+                slot.generation++;
+            }
+            slot.isUsed = false;
+            slot.assetID.clear();
+            slot.asset = TAsset();
+            freeSlots.push_back(index);
+        }
+        indices.clear();
+    }
+
+    size_t GetNumAssets() const { return indices.size(); }
+
+private:
+    struct Slot
+    {
+        std::string assetID;
+        TAsset asset = TAsset();
+        uint32_t generation = 0;
+        bool isUsed = false;
+    };
+
+    Handle MakeHandle(uint32_t index) const
+    {
+        Handle handle;
+        handle.index = index;
+        handle.generation = slots[index].generation;
+        return handle;
+    }
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> indices;
+};
+
+#endif
@@ -0,0 +1,485 @@
+#include "TextureAtlas.h"
+#include "AssetLoader.h"
+#include "SDL2/SDL_image.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// imgui compiles its own static copy of the packer, this one is private to the atlas builder
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+    /**
+     * Version of the atlas index file, bumped whenever its layout changes
+     */
+    constexpr int ATLAS_CACHE_VERSION = 1;
+
+    /**
+     * Size and modification time of a file, used to tell whether a cached atlas is stale
+     */
+    bool GetFileStamp(const std::string& filePath, long long& outSize, long long& outTime)
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(filePath, error);
+        if (error) return false;
+
+        const auto time = std::filesystem::last_write_time(filePath, error);
+        if (error) return false;
+
+        outSize = static_cast<long long>(size);
+        outTime = static_cast<long long>(time.time_since_epoch().count());
+        return true;
+    }
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    Clear();
+}
+
+void TextureAtlas::Begin(int pageSize, const std::string& cachePath)
+{
+    isBuilding = true;
+    this->pageSize = pageSize;
+    this->cachePath = cachePath;
+    pendingImages.clear();
+}
+
+void TextureAtlas::AddImage(const std::string& assetID, const std::string& filePath)
+{
+    PendingImage image;
+    image.assetID = assetID;
+    image.filePath = filePath;
+    GetFileStamp(filePath, image.fileSize, image.fileTime);
+    pendingImages.push_back(image);
+}
+
+void TextureAtlas::End(SDL_Renderer* renderer, std::vector<StandaloneImage>& outStandalone, AssetLoader* loader)
+{
+    Pack(GetMaxTextureSize(renderer), outStandalone, loader);
+    CreatePages(renderer, outStandalone);
+}
+
+/**
+ * @brief Packs the queued images into page images.
+ *
+ * The cached atlas is used when its index matches the queued images, otherwise every image is
+ * decoded, packed page after page with the skyline packer and blitted into an RGBA page surface.
+ * Pages are cropped to the area actually used, so a small level does not pay for a full page.
+ */
+void TextureAtlas::Pack(int maxPageSize, std::vector<StandaloneImage>& outStandalone, AssetLoader* loader)
+{
+    isBuilding = false;
+
+    if (maxPageSize > 0)
+    {
+        pageSize = std::min(pageSize, maxPageSize);
+    }
+
+    if (!cachePath.empty() && LoadCache(outStandalone))
+    {
+        Logger::Log("Texture atlas loaded from " + GetIndexPath() + " with " + std::to_string(pageSurfaces.size()) + " pages");
+        return;
+    }
+
+    // Decode the images, on the loader workers when there is one
+    if (loader)
+    {
+        std::vector<std::string> filePaths;
+        for (const auto& image : pendingImages)
+        {
+            filePaths.push_back(image.filePath);
+        }
+
+        std::vector<SDL_Surface*> surfaces;
+        loader->DecodeImages(filePaths, surfaces);
+        for (size_t i = 0; i < pendingImages.size(); i++)
+        {
+            pendingImages[i].surface = surfaces[i];
+        }
+    }
+    else
+    {
+        for (auto& image : pendingImages)
+        {
+            image.surface = IMG_Load(image.filePath.c_str());
+            if (!image.surface)
+            {
+                Logger::Err("Error loading image file: " + image.filePath);
+            }
+        }
+    }
+
+    // The images that do not fit in a page stay standalone textures
+    std::vector<stbrp_rect> packRects;
+    for (size_t i = 0; i < pendingImages.size(); i++)
+    {
+        PendingImage& image = pendingImages[i];
+        if (!image.surface)
+        {
+            continue;
+        }
+
+        const int paddedWidth = image.surface->w + IMAGE_PADDING * 2;
+        const int paddedHeight = image.surface->h + IMAGE_PADDING * 2;
+        if (paddedWidth > pageSize || paddedHeight > pageSize)
+        {
+            continue;
+        }
+
+        stbrp_rect packRect = {};
+        packRect.id = static_cast<int>(i);
+        packRect.w = static_cast<stbrp_coord>(paddedWidth);
+        packRect.h = static_cast<stbrp_coord>(paddedHeight);
+        packRects.push_back(packRect);
+    }
+
+    // Fill one page at a time, whatever did not fit goes to the next one
+    std::vector<stbrp_node> nodes(pageSize);
+    std::vector<SDL_Rect> pageAreas;
+    std::vector<stbrp_rect> remainingRects;
+
+    while (!packRects.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize, pageSize, nodes.data(), static_cast<int>(nodes.size()));
+        stbrp_pack_rects(&context, packRects.data(), static_cast<int>(packRects.size()));
+
+        const int page = static_cast<int>(pageAreas.size());
+        SDL_Rect usedArea = { 0, 0, 0, 0 };
+        remainingRects.clear();
+
+        for (auto& packRect : packRects)
+        {
+            if (!packRect.was_packed)
+            {
+                remainingRects.push_back(packRect);
+                continue;
+            }
+
+            PendingImage& image = pendingImages[packRect.id];
+            image.page = page;
+            image.rect = { packRect.x + IMAGE_PADDING, packRect.y + IMAGE_PADDING, image.surface->w, image.surface->h };
+            usedArea.w = std::max(usedArea.w, packRect.x + packRect.w);
+            usedArea.h = std::max(usedArea.h, packRect.y + packRect.h);
+        }
+
+        if (remainingRects.size() == packRects.size())
+        {
+            break;
+        }
+
+        pageAreas.push_back(usedArea);
+        packRects.swap(remainingRects);
+    }
+
+    // Blit the images into their pages
+    for (const auto& pageArea : pageAreas)
+    {
+        pageSurfaces.push_back(SDL_CreateRGBSurfaceWithFormat(0, pageArea.w, pageArea.h, 32, SDL_PIXELFORMAT_RGBA32));
+    }
+
+    size_t numPacked = 0;
+    for (auto& image : pendingImages)
+    {
+        if (image.page < 0 || !pageSurfaces[image.page])
+        {
+            outStandalone.push_back({ image.assetID, image.filePath });
+            image.page = -1;
+            continue;
+        }
+
+        // copy the pixels as they are, alpha included, instead of blending them over the empty page
+        SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+        SDL_Rect dstRect = image.rect;
+        SDL_BlitSurface(image.surface, nullptr, pageSurfaces[image.page], &dstRect);
+        numPacked++;
+    }
+
+    Logger::Log("Texture atlas packed " + std::to_string(numPacked) + " images in " + std::to_string(pageSurfaces.size()) + " pages");
+
+    if (!cachePath.empty())
+    {
+        SaveCache();
+    }
+
+    for (auto& image : pendingImages)
+    {
+        SDL_FreeSurface(image.surface);
+        image.surface = nullptr;
+    }
+}
+
+void TextureAtlas::CreatePages(SDL_Renderer* renderer, std::vector<StandaloneImage>& outStandalone)
+{
+    // pages of a previous build stay alive, the new ones are appended after them
+    const size_t firstPage = pages.size();
+    for (size_t page = 0; page < pageSurfaces.size(); page++)
+    {
+        SDL_Texture* texture = pageSurfaces[page] ? SDL_CreateTextureFromSurface(renderer, pageSurfaces[page]) : nullptr;
+        if (!texture)
+        {
+            Logger::Err("Error creating the texture of atlas page " + std::to_string(page));
+        }
+        pages.push_back(texture);
+        SDL_FreeSurface(pageSurfaces[page]);
+    }
+    pageSurfaces.clear();
+
+    for (auto& image : pendingImages)
+    {
+        if (image.page >= 0)
+        {
+            if (pages[firstPage + image.page])
+            {
+                regions[image.assetID] = { pages[firstPage + image.page], image.rect };
+            }
+            else
+            {
+                outStandalone.push_back({ image.assetID, image.filePath });
+            }
+        }
+    }
+    pendingImages.clear();
+}
+
+int TextureAtlas::GetMaxTextureSize(SDL_Renderer* renderer)
+{
+    SDL_RendererInfo rendererInfo;
+    if (!renderer || SDL_GetRendererInfo(renderer, &rendererInfo) != 0)
+    {
+        return 0;
+    }
+
+    if (rendererInfo.max_texture_width <= 0) return rendererInfo.max_texture_height;
+    if (rendererInfo.max_texture_height <= 0) return rendererInfo.max_texture_width;
+    return std::min(rendererInfo.max_texture_width, rendererInfo.max_texture_height);
+}
+
+bool TextureAtlas::ReleasePage(SDL_Texture* page)
+{
+    const auto it = std::find(pages.begin(), pages.end(), page);
+    if (!page || it == pages.end())
+    {
+        return false;
+    }
+    pages.erase(it);
+
+    for (auto region = regions.begin(); region != regions.end();)
+    {
+        region = region->second.texture == page ? regions.erase(region) : std::next(region);
+    }
+    return true;
+}
+
+bool TextureAtlas::GetRegion(const std::string& assetID, TextureRegion& outRegion) const
+{
+    const auto it = regions.find(assetID);
+    if (it == regions.end())
+    {
+        return false;
+    }
+
+    outRegion = it->second;
+    return true;
+}
+
+void TextureAtlas::Clear()
+{
+    for (auto texture : pages)
+    {
+        SDL_DestroyTexture(texture);
+    }
+    pages.clear();
+    regions.clear();
+
+    for (auto surface : pageSurfaces)
+    {
+        SDL_FreeSurface(surface);
+    }
+    pageSurfaces.clear();
+
+    for (auto& image : pendingImages)
+    {
+        SDL_FreeSurface(image.surface);
+    }
+    pendingImages.clear();
+    isBuilding = false;
+}
+
+size_t TextureAtlas::GetMemoryBytes() const
+{
+    size_t memoryBytes = 0;
+    for (auto texture : pages)
+    {
+        Uint32 format = 0;
+        int width = 0;
+        int height = 0;
+        if (texture && SDL_QueryTexture(texture, &format, nullptr, &width, &height) == 0)
+        {
+            memoryBytes += static_cast<size_t>(width) * height * SDL_BYTESPERPIXEL(format);
+        }
+    }
+    return memoryBytes;
+}
+
+std::string TextureAtlas::GetIndexPath() const
+{
+    return cachePath + ".atlas";
+}
+
+std::string TextureAtlas::GetPagePath(int page) const
+{
+    return cachePath + "-" + std::to_string(page) + ".png";
+}
+
+/**
+ * @brief Loads the atlas written by a previous SaveCache.
+ *
+ * The index has to list exactly the queued images, with the same files, sizes and modification
+ * times and the same page size, otherwise the cache is stale and the atlas is packed again.
+ */
+bool TextureAtlas::LoadCache(std::vector<StandaloneImage>& outStandalone)
+{
+    std::ifstream indexFile(GetIndexPath());
+    if (!indexFile.is_open())
+    {
+        return false;
+    }
+
+    std::string header;
+    int version = 0;
+    int cachedPageSize = 0;
+    int numPages = 0;
+    size_t numImages = 0;
+    indexFile >> header >> version >> cachedPageSize >> numPages >> numImages;
+    if (!indexFile || header != "atlas" || version != ATLAS_CACHE_VERSION || cachedPageSize != pageSize || numImages != pendingImages.size())
+    {
+        return false;
+    }
+
+    std::map<std::string, PendingImage*> imagesById;
+    for (auto& image : pendingImages)
+    {
+        imagesById.emplace(image.assetID, &image);
+    }
+
+    std::vector<std::pair<PendingImage*, std::pair<int, SDL_Rect>>> cachedRegions;
+    std::vector<StandaloneImage> cachedStandalone;
+
+    for (size_t i = 0; i < numImages; i++)
+    {
+        std::string assetID;
+        int page = -1;
+        SDL_Rect rect = { 0, 0, 0, 0 };
+        long long fileSize = 0;
+        long long fileTime = 0;
+        std::string filePath;
+
+        indexFile >> assetID >> page >> rect.x >> rect.y >> rect.w >> rect.h >> fileSize >> fileTime;
+        indexFile >> std::ws;
+        std::getline(indexFile, filePath);
+
+        const auto it = imagesById.find(assetID);
+        if (!indexFile || it == imagesById.end() || page >= numPages)
+        {
+            return false;
+        }
+
+        PendingImage& image = *it->second;
+        if (image.filePath != filePath || image.fileSize != fileSize || image.fileTime != fileTime)
+        {
+            return false;
+        }
+
+        if (page < 0)
+        {
+            cachedStandalone.push_back({ assetID, filePath });
+        }
+        else
+        {
+            cachedRegions.push_back({ &image, { page, rect } });
+        }
+    }
+
+    std::vector<SDL_Surface*> cachedPages;
+    for (int page = 0; page < numPages; page++)
+    {
+        SDL_Surface* surface = IMG_Load(GetPagePath(page).c_str());
+        if (!surface)
+        {
+            for (auto cachedPage : cachedPages)
+            {
+                SDL_FreeSurface(cachedPage);
+            }
+            return false;
+        }
+        cachedPages.push_back(surface);
+    }
+
+    // the pages are created by CreatePages, like freshly packed ones
+    for (auto& image : pendingImages)
+    {
+        image.page = -1;
+    }
+    for (const auto& cachedRegion : cachedRegions)
+    {
+        cachedRegion.first->page = cachedRegion.second.first;
+        cachedRegion.first->rect = cachedRegion.second.second;
+    }
+    pageSurfaces.insert(pageSurfaces.end(), cachedPages.begin(), cachedPages.end());
+    outStandalone.insert(outStandalone.end(), cachedStandalone.begin(), cachedStandalone.end());
+    return true;
+}
+
+/**
+ * @brief Writes the page images and the index describing them next to the cache path.
+ */
+void TextureAtlas::SaveCache() const
+{
+    std::error_code error;
+    const std::filesystem::path directory = std::filesystem::path(cachePath).parent_path();
+    if (!directory.empty())
+    {
+        std::filesystem::create_directories(directory, error);
+    }
+
+    for (size_t page = 0; page < pageSurfaces.size(); page++)
+    {
+        if (!pageSurfaces[page] || IMG_SavePNG(pageSurfaces[page], GetPagePath(static_cast<int>(page)).c_str()) != 0)
+        {
+            Logger::Err("Error saving texture atlas page: " + GetPagePath(static_cast<int>(page)));
+            return;
+        }
+    }
+
+    std::ostringstream index;
+    index << "atlas " << ATLAS_CACHE_VERSION << " " << pageSize << " " << pageSurfaces.size() << " " << pendingImages.size() << "\n";
+    for (const auto& image : pendingImages)
+    {
+        index << image.assetID << " " << image.page << " "
+              << image.rect.x << " " << image.rect.y << " " << image.rect.w << " " << image.rect.h << " "
+              << image.fileSize << " " << image.fileTime << " " << image.filePath << "\n";
+    }
+
+    std::ofstream indexFile(GetIndexPath(), std::ios::trunc);
+    if (!indexFile.is_open())
+    {
+        Logger::Err("Error saving texture atlas index: " + GetIndexPath());
+        return;
+    }
+    indexFile << index.str();
+    Logger::Log("Texture atlas saved to " + GetIndexPath());
+}
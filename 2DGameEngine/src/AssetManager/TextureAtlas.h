@@ -0,0 +1,161 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+class AssetLoader;
+
+/**
+ * @brief Location of an image, the texture that holds it and the rectangle it covers.
+ *
+ * For a standalone texture the rectangle is the whole texture, for an image packed
+ * in an atlas it is the sub-rectangle of the atlas page.
+ */
+struct TextureRegion
+{
+    SDL_Texture* texture = nullptr;
+    SDL_Rect rect = { 0, 0, 0, 0 };
+};
+
+/**
+ * @class TextureAtlas
+ * @brief Packs the images of a level into a few large texture pages.
+ *
+ * Images are queued between Begin and End. End decodes them, packs them with the
+ * stb rect packer and uploads one texture per page, so sprites sharing a page can
+ * be drawn in the same batch. When a cache path is set, the packed pages and their
+ * index are written to disk and reused on the next start as long as the source
+ * files did not change.
+ */
+class TextureAtlas
+{
+public:
+    /**
+     * @brief Image that could not be packed and has to be loaded as a standalone texture.
+     */
+    struct StandaloneImage
+    {
+        std::string assetID;
+        std::string filePath;
+    };
+
+    TextureAtlas() = default;
+    ~TextureAtlas();
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+    /**
+     * @brief Starts queuing images for a new atlas build.
+     *
+     * @param pageSize Width and height of the atlas pages, clamped to the renderer limits.
+     * @param cachePath Path prefix of the atlas files on disk, empty to always pack at load time.
+     */
+    void Begin(int pageSize, const std::string& cachePath);
+
+    /**
+     * @brief Queues an image to be packed by the next End.
+     */
+    void AddImage(const std::string& assetID, const std::string& filePath);
+
+    /**
+     * @brief Packs the queued images and creates the page textures.
+     *
+     * Images bigger than a page, or that failed to load, are reported in outStandalone.
+     *
+     * @param loader Workers decoding the images in parallel, null to decode them one after the other.
+     */
+    void End(SDL_Renderer* renderer, std::vector<StandaloneImage>& outStandalone, AssetLoader* loader = nullptr);
+
+    /**
+     * @brief First half of End: decodes and packs the queued images, or loads the cached atlas, into
+     * page images. Does not use the renderer, so it can run on another thread than CreatePages.
+     *
+     * @param maxPageSize Largest texture the renderer can create, 0 for no limit.
+     */
+    void Pack(int maxPageSize, std::vector<StandaloneImage>& outStandalone, AssetLoader* loader = nullptr);
+
+    /**
+     * @brief Second half of End: creates the page textures of the last Pack, on the thread that
+     * owns the renderer. Images whose page could not be created are reported in outStandalone.
+     */
+    void CreatePages(SDL_Renderer* renderer, std::vector<StandaloneImage>& outStandalone);
+
+    /**
+     * @brief Largest texture the renderer can create, 0 if it does not tell.
+     */
+    static int GetMaxTextureSize(SDL_Renderer* renderer);
+
+    /**
+     * @brief Gives up the ownership of a page, it is no longer destroyed by Clear and its regions are forgotten.
+     *
+     * @return false if the page is not one of this atlas.
+     */
+    bool ReleasePage(SDL_Texture* page);
+
+    bool IsBuilding() const { return isBuilding; }
+
+    /**
+     * @brief Finds the page and sub-rectangle of a packed image.
+     *
+     * @return false if the asset is not part of the atlas.
+     */
+    bool GetRegion(const std::string& assetID, TextureRegion& outRegion) const;
+
+    /**
+     * @brief Destroys the page textures and forgets every region.
+     */
+    void Clear();
+
+    int GetNumPages() const { return static_cast<int>(pages.size()); }
+
+    /**
+     * @brief Memory of the page textures, width x height x bytes per pixel.
+     */
+    size_t GetMemoryBytes() const;
+
+    /**
+     * @brief Regions of every packed image, by asset id.
+     */
+    const std::map<std::string, TextureRegion>& GetRegions() const { return regions; }
+
+private:
+    struct PendingImage
+    {
+        std::string assetID;
+        std::string filePath;
+        long long fileSize = 0;
+        long long fileTime = 0;
+        SDL_Surface* surface = nullptr;
+        SDL_Rect rect = { 0, 0, 0, 0 };
+        int page = -1;
+    };
+
+    bool LoadCache(std::vector<StandaloneImage>& outStandalone);
+    void SaveCache() const;
+    std::string GetIndexPath() const;
+    std::string GetPagePath(int page) const;
+
+    /**
+     * Padding in pixels around every packed image, keeps filtering from bleeding between neighbours
+     */
+    static constexpr int IMAGE_PADDING = 1;
+
+    bool isBuilding = false;
+    int pageSize = 0;
+    std::string cachePath;
+    std::vector<PendingImage> pendingImages;
+
+    /**
+     * Page images of the last Pack, turned into textures by CreatePages
+     */
+    std::vector<SDL_Surface*> pageSurfaces;
+
+    std::vector<SDL_Texture*> pages;
+    std::map<std::string, TextureRegion> regions;
+};
+
+#endif
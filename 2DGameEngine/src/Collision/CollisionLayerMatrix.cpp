@@ -0,0 +1,72 @@
+#include "CollisionLayerMatrix.h"
+#include "../Logger/Logger.h"
+
+CollisionLayerMatrix::CollisionLayerMatrix()
+{
+    Reset();
+}
+
+void CollisionLayerMatrix::Reset()
+{
+    layerNames.clear();
+    layerNames.push_back("default");
+
+    for (int i = 0; i < MAX_COLLISION_LAYERS; i++)
+    {
+        masks[i] = 0xFFFFFFFFu;
+    }
+}
+
+int CollisionLayerMatrix::AddLayer(const std::string& name)
+{
+    for (int i = 0; i < static_cast<int>(layerNames.size()); i++)
+    {
+        if (layerNames[i] == name) return i;
+    }
+
+    if (static_cast<int>(layerNames.size()) >= MAX_COLLISION_LAYERS)
+    {
+        Logger::Err("Too many collision layers, " + name + " is mapped to the default layer");
+        return DEFAULT_COLLISION_LAYER;
+    }
+
+    layerNames.push_back(name);
+    return static_cast<int>(layerNames.size()) - 1;
+}
+
+int CollisionLayerMatrix::GetLayer(const std::string& name) const
+{
+    for (int i = 0; i < static_cast<int>(layerNames.size()); i++)
+    {
+        if (layerNames[i] == name) return i;
+    }
+
+    return DEFAULT_COLLISION_LAYER;
+}
+
+bool CollisionLayerMatrix::HasLayer(const std::string& name) const
+{
+    for (const auto& layerName : layerNames)
+    {
+        if (layerName == name) return true;
+    }
+
+    return false;
+}
+
+void CollisionLayerMatrix::SetLayersCollide(int a, int b, bool collide)
+{
+    a = ClampLayer(a);
+    b = ClampLayer(b);
+
+    if (collide)
+    {
+        masks[a] |= GetLayerBit(b);
+        masks[b] |= GetLayerBit(a);
+    }
+    else
+    {
+        masks[a] &= ~GetLayerBit(b);
+        masks[b] &= ~GetLayerBit(a);
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef COLLISIONLAYERMATRIX_H
+#define COLLISIONLAYERMATRIX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Maximum number of collision layers, one bit per layer in the masks.
+ */
+constexpr int MAX_COLLISION_LAYERS = 32;
+
+/**
+ * Index of the layer every collider uses when none is given.
+ */
+constexpr int DEFAULT_COLLISION_LAYER = 0;
+
+/**
+ * Symmetric layer-pair matrix deciding which collision layers can collide with each other.
+ *
+ * Every layer keeps a bit mask of the layers it collides with. The broadphase checks the masks
+ * before any bounds test, so pairs of layers nobody is interested in never reach the AABB test
+ * nor the event bus. By default every layer collides with every other one.
+ */
+class CollisionLayerMatrix
+{
+public:
+    CollisionLayerMatrix();
+
+    /**
+     * Removes every layer except the default one and makes all layers collide again.
+     */
+    void Reset();
+
+    /**
+     * Registers a new layer by name.
+     *
+     * @param name The name of the layer, as used in the level Lua file.
+     * @return The index of the layer, or the existing index if the layer is already registered.
+     */
+    int AddLayer(const std::string& name);
+
+    /**
+     * Retrieves the index of a layer.
+     *
+     * @param name The name of the layer.
+     * @return The index of the layer, or DEFAULT_COLLISION_LAYER if the name is unknown.
+     */
+    int GetLayer(const std::string& name) const;
+
+    /**
+     * Checks if a layer with the given name was registered.
+     */
+    bool HasLayer(const std::string& name) const;
+
+    /**
+     * Enables or disables collisions between two layers, in both directions.
+     */
+    void SetLayersCollide(int a, int b, bool collide);
+
+    /**
+     * Checks if colliders on the two layers have to be tested against each other.
+     */
+    bool ShouldCollide(int a, int b) const
+    {
+        return (masks[ClampLayer(a)] & GetLayerBit(b)) != 0;
+    }
+
+    /**
+     * Retrieves the mask of the layers a layer collides with.
+     */
+    uint32_t GetLayerMask(int layer) const { return masks[ClampLayer(layer)]; }
+
+    /**
+     * Retrieves the single bit identifying a layer in the masks.
+     */
+    static uint32_t GetLayerBit(int layer) { return 1u << ClampLayer(layer); }
+
+    const std::vector<std::string>& GetLayerNames() const { return layerNames; }
+
+private:
+    static int ClampLayer(int layer)
+    {
+        return (layer < 0 || layer >= MAX_COLLISION_LAYERS) ? DEFAULT_COLLISION_LAYER : layer;
+    }
+
+    std::vector<std::string> layerNames;
+    uint32_t masks[MAX_COLLISION_LAYERS];
+};
+
+#endif
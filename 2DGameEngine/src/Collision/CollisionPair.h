@@ -0,0 +1,57 @@
+#ifndef COLLISIONPAIR_H
+#define COLLISIONPAIR_H
+
+#include <cstdint>
+
+/**
+ * Axis aligned bounding box in world space used by the collision broadphase.
+ */
+struct AABB
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+/**
+ * Pair of entity ids reported by the broadphase. The smaller id is always stored in `a`.
+ */
+struct CollisionPair
+{
+    int a;
+    int b;
+};
+
+/**
+ * Checks two boxes for overlap. Touching edges do not count as an overlap,
+ * which matches CheckAABBCollision in the CollisionSystem.
+ */
+inline bool AABBOverlap(const AABB& a, const AABB& b)
+{
+    return a.minX < b.maxX && a.maxX > b.minX && a.minY < b.maxY && a.maxY > b.minY;
+}
+
+/**
+ * Packs two entity ids into an order independent 64 bit key.
+ */
+inline uint64_t MakePairKey(int a, int b)
+{
+    if (a > b)
+    {
+        int tmp = a;
+        a = b;
+        b = tmp;
+    }
+    return (static_cast<uint64_t>(static_cast<uint32_t>(a)) << 32) | static_cast<uint32_t>(b);
+}
+
+/**
+ * Unpacks a key created with MakePairKey.
+ */
+inline CollisionPair UnpackPairKey(uint64_t key)
+{
+    return CollisionPair{ static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFFu) };
+}
+
+#endif
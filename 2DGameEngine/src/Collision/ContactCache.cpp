@@ -0,0 +1,67 @@
+#include "ContactCache.h"
+
+void ContactCache::BeginFrame()
+{
+    currentFrame++;
+    enteredContacts.clear();
+    stayingContacts.clear();
+    exitedContacts.clear();
+}
+
+void ContactCache::AddContact(int a, int b)
+{
+    const uint64_t key = MakePairKey(a, b);
+    auto contact = contacts.find(key);
+
+    if (contact == contacts.end())
+    {
+        contacts.emplace(key, currentFrame);
+        enteredContacts.push_back(UnpackPairKey(key));
+    }
+    else if (contact->second != currentFrame)
+    {
+        contact->second = currentFrame;
+        stayingContacts.push_back(UnpackPairKey(key));
+    }
+}
+
+void ContactCache::EndFrame()
+{
+    for (auto it = contacts.begin(); it != contacts.end();)
+    {
+        if (it->second != currentFrame)
+        {
+            exitedContacts.push_back(UnpackPairKey(it->first));
+            it = contacts.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void ContactCache::RemoveEntity(int id, std::vector<CollisionPair>& removedContacts)
+{
+    for (auto it = contacts.begin(); it != contacts.end();)
+    {
+        const CollisionPair pair = UnpackPairKey(it->first);
+        if (pair.a == id || pair.b == id)
+        {
+            removedContacts.push_back(pair);
+            it = contacts.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void ContactCache::Clear()
+{
+    contacts.clear();
+    enteredContacts.clear();
+    stayingContacts.clear();
+    exitedContacts.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef CONTACTCACHE_H
+#define CONTACTCACHE_H
+
+#include <vector>
+#include <unordered_map>
+#include "CollisionPair.h"
+
+/**
+ * Persistent cache of the contacts found by the broadphase.
+ *
+ * Contacts are keyed by the sorted entity-pair id and stamped with the frame they were last
+ * seen in. Comparing the stamps with the current frame splits the contacts in the ones that
+ * just started (enter), the ones still overlapping (stay) and the ones that ended (exit).
+ */
+class ContactCache
+{
+public:
+    ContactCache() = default;
+
+    /**
+     * Starts a new frame and clears the contact lists of the previous one.
+     */
+    void BeginFrame();
+
+    /**
+     * Reports a pair overlapping in the current frame.
+     */
+    void AddContact(int a, int b);
+
+    /**
+     * Ends the frame, every contact not reported since BeginFrame is moved to the exited list.
+     */
+    void EndFrame();
+
+    /**
+     * Drops every contact of an entity.
+     *
+     * @param id The entity id being removed.
+     * @param removedContacts Receives the contacts that were dropped.
+     */
+    void RemoveEntity(int id, std::vector<CollisionPair>& removedContacts);
+
+    /**
+     * Drops every contact without reporting them.
+     */
+    void Clear();
+
+    const std::vector<CollisionPair>& GetEnteredContacts() const { return enteredContacts; }
+    const std::vector<CollisionPair>& GetStayingContacts() const { return stayingContacts; }
+    const std::vector<CollisionPair>& GetExitedContacts() const { return exitedContacts; }
+
+    int GetContactCount() const { return static_cast<int>(contacts.size()); }
+
+private:
+    /**
+     * Pair key to the frame the contact was last seen in
+     */
+    std::unordered_map<uint64_t, uint32_t> contacts;
+    uint32_t currentFrame = 0;
+
+    std::vector<CollisionPair> enteredContacts;
+    std::vector<CollisionPair> stayingContacts;
+    std::vector<CollisionPair> exitedContacts;
+};
+
+#endif
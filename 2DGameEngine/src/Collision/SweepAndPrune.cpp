@@ -0,0 +1,191 @@
+#include "SweepAndPrune.h"
+
+namespace
+{
+    float AxisMin(const AABB& box, int axis) { return axis == 0 ? box.minX : box.minY; }
+    float AxisMax(const AABB& box, int axis) { return axis == 0 ? box.maxX : box.maxY; }
+}
+
+void SweepAndPrune::Insert(int id, const AABB& box, uint32_t layerBit, uint32_t layerMask)
+{
+    if (id < 0) return;
+
+    if (id >= static_cast<int>(proxies.size()))
+    {
+        proxies.resize(id + 1);
+    }
+
+    Proxy& proxy = proxies[id];
+    if (proxy.isActive)
+    {
+        Move(id, box);
+        return;
+    }
+
+    proxy.isActive = true;
+    proxy.box = box;
+    proxy.layerBit = layerBit;
+    proxy.layerMask = layerMask;
+
+    // New endpoints are appended at the end of the axes, as if the box came from infinity.
+    // The insertion sort on the next Update moves them in place and reports the new pairs.
+    for (int axis = 0; axis < 2; axis++)
+    {
+        auto& endpoints = axes[axis];
+
+        proxy.minIndex[axis] = static_cast<int>(endpoints.size());
+        endpoints.push_back({AxisMin(box, axis), id, true});
+
+        proxy.maxIndex[axis] = static_cast<int>(endpoints.size());
+        endpoints.push_back({AxisMax(box, axis), id, false});
+    }
+}
+
+void SweepAndPrune::Remove(int id)
+{
+    if (!Contains(id)) return;
+
+    Proxy& proxy = proxies[id];
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        auto& endpoints = axes[axis];
+        int first = proxy.minIndex[axis] < proxy.maxIndex[axis] ? proxy.minIndex[axis] : proxy.maxIndex[axis];
+        int second = proxy.minIndex[axis] < proxy.maxIndex[axis] ? proxy.maxIndex[axis] : proxy.minIndex[axis];
+
+        endpoints.erase(endpoints.begin() + second);
+        endpoints.erase(endpoints.begin() + first);
+
+        for (int i = first; i < static_cast<int>(endpoints.size()); i++)
+        {
+            SetEndpointIndex(endpoints[i], axis, i);
+        }
+    }
+
+    proxy = Proxy();
+
+    for (auto it = overlappingPairs.begin(); it != overlappingPairs.end();)
+    {
+        const CollisionPair pair = UnpackPairKey(*it);
+        if (pair.a == id || pair.b == id)
+        {
+            removedPairs.push_back(pair);
+            it = overlappingPairs.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
+void SweepAndPrune::Move(int id, const AABB& box)
+{
+    if (!Contains(id)) return;
+
+    Proxy& proxy = proxies[id];
+    proxy.box = box;
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        axes[axis][proxy.minIndex[axis]].value = AxisMin(box, axis);
+        axes[axis][proxy.maxIndex[axis]].value = AxisMax(box, axis);
+    }
+}
+
+bool SweepAndPrune::Contains(int id) const
+{
+    return id >= 0 && id < static_cast<int>(proxies.size()) && proxies[id].isActive;
+}
+
+void SweepAndPrune::Update()
+{
+    lastSwapCount = 0;
+    SortAxis(0);
+    SortAxis(1);
+}
+
+void SweepAndPrune::ClearPairChanges()
+{
+    addedPairs.clear();
+    removedPairs.clear();
+}
+
+void SweepAndPrune::SortAxis(int axis)
+{
+    auto& endpoints = axes[axis];
+
+    for (int i = 1; i < static_cast<int>(endpoints.size()); i++)
+    {
+        const Endpoint key = endpoints[i];
+        int j = i;
+
+        while (j > 0 && IsLess(key, endpoints[j - 1]))
+        {
+            const Endpoint& swapped = endpoints[j - 1];
+
+            if (swapped.id != key.id)
+            {
+                // A min endpoint moving past a max endpoint may start an overlap,
+                // a max endpoint moving past a min endpoint always ends one
+                if (key.isMin && !swapped.isMin)
+                {
+                    const Proxy& a = proxies[key.id];
+                    const Proxy& b = proxies[swapped.id];
+
+                    if (CanCollide(a, b) && AABBOverlap(a.box, b.box))
+                    {
+                        AddPair(key.id, swapped.id);
+                    }
+                }
+                else if (!key.isMin && swapped.isMin)
+                {
+                    RemovePair(key.id, swapped.id);
+                }
+            }
+
+            endpoints[j] = swapped;
+            SetEndpointIndex(endpoints[j], axis, j);
+            j--;
+            lastSwapCount++;
+        }
+
+        if (j != i)
+        {
+            endpoints[j] = key;
+            SetEndpointIndex(key, axis, j);
+        }
+    }
+}
+
+void SweepAndPrune::SetEndpointIndex(const Endpoint& endpoint, int axis, int index)
+{
+    Proxy& proxy = proxies[endpoint.id];
+
+    if (endpoint.isMin)
+    {
+        proxy.minIndex[axis] = index;
+    }
+    else
+    {
+        proxy.maxIndex[axis] = index;
+    }
+}
+
+void SweepAndPrune::AddPair(int a, int b)
+{
+    const uint64_t key = MakePairKey(a, b);
+    if (overlappingPairs.insert(key).second)
+    {
+        addedPairs.push_back(UnpackPairKey(key));
+    }
+}
+
+void SweepAndPrune::RemovePair(int a, int b)
+{
+    const uint64_t key = MakePairKey(a, b);
+    if (overlappingPairs.erase(key) > 0)
+    {
+        removedPairs.push_back(UnpackPairKey(key));
+    }
+}
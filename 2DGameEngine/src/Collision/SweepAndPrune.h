@@ -0,0 +1,119 @@
+#ifndef SWEEPANDPRUNE_H
+#define SWEEPANDPRUNE_H
+
+#include <vector>
+#include <unordered_set>
+#include "CollisionPair.h"
+
+/**
+ * Persistent sweep-and-prune broadphase.
+ *
+ * Every box is projected on the X and Y axis as a pair of min/max endpoints. The endpoint
+ * arrays stay sorted between frames and are re-sorted with an insertion sort, so for boxes
+ * that barely move the sort is close to linear. Every swap of a min and a max endpoint of two
+ * different boxes is exactly a change of their overlap on that axis, so the set of overlapping
+ * pairs is updated incrementally and the added/removed pairs are reported to the caller.
+ */
+class SweepAndPrune
+{
+public:
+    SweepAndPrune() = default;
+
+    /**
+     * Adds a box to the broadphase. Its pairs are reported on the next Update.
+     * Two boxes can only form a pair if the layer bit of each one is in the mask of the other.
+     *
+     * @param id The entity id owning the box.
+     * @param box The world space bounds of the box.
+     * @param layerBit The bit of the collision layer of the box.
+     * @param layerMask The mask of the layers the box collides with.
+     */
+    void Insert(int id, const AABB& box, uint32_t layerBit = 0xFFFFFFFFu, uint32_t layerMask = 0xFFFFFFFFu);
+
+    /**
+     * Removes a box and all of its overlapping pairs. The pairs are reported as removed.
+     *
+     * @param id The entity id owning the box.
+     */
+    void Remove(int id);
+
+    /**
+     * Updates the bounds of a box. The endpoints are re-sorted on the next Update.
+     *
+     * @param id The entity id owning the box.
+     * @param box The new world space bounds of the box.
+     */
+    void Move(int id, const AABB& box);
+
+    /**
+     * Checks if a box with the given id is tracked by the broadphase.
+     */
+    bool Contains(int id) const;
+
+    /**
+     * Re-sorts both axes and updates the overlapping pair set.
+     */
+    void Update();
+
+    /**
+     * Clears the added/removed pair lists. Call it once the changes were consumed.
+     */
+    void ClearPairChanges();
+
+    const std::unordered_set<uint64_t>& GetOverlappingPairs() const { return overlappingPairs; }
+    const std::vector<CollisionPair>& GetAddedPairs() const { return addedPairs; }
+    const std::vector<CollisionPair>& GetRemovedPairs() const { return removedPairs; }
+
+    /**
+     * Number of endpoint swaps done by the last Update, used to profile frame coherence.
+     */
+    int GetLastSwapCount() const { return lastSwapCount; }
+
+private:
+    struct Endpoint
+    {
+        float value;
+        int id;
+        bool isMin;
+    };
+
+    struct Proxy
+    {
+        AABB box = {0.0f, 0.0f, 0.0f, 0.0f};
+        int minIndex[2] = {-1, -1};
+        int maxIndex[2] = {-1, -1};
+        uint32_t layerBit = 0xFFFFFFFFu;
+        uint32_t layerMask = 0xFFFFFFFFu;
+        bool isActive = false;
+    };
+
+    void SortAxis(int axis);
+    void SetEndpointIndex(const Endpoint& endpoint, int axis, int index);
+    bool CanCollide(const Proxy& a, const Proxy& b) const
+    {
+        return (a.layerBit & b.layerMask) != 0 && (b.layerBit & a.layerMask) != 0;
+    }
+
+    void AddPair(int a, int b);
+    void RemovePair(int a, int b);
+
+    /**
+     * Endpoints ordering. On equal values max endpoints go first, so a min endpoint placed after
+     * a max endpoint of another box means that the boxes are separated on that axis.
+     */
+    static bool IsLess(const Endpoint& a, const Endpoint& b)
+    {
+        return a.value < b.value || (a.value == b.value && !a.isMin && b.isMin);
+    }
+
+    std::vector<Endpoint> axes[2];
+    std::vector<Proxy> proxies;
+
+    std::unordered_set<uint64_t> overlappingPairs;
+    std::vector<CollisionPair> addedPairs;
+    std::vector<CollisionPair> removedPairs;
+
+    int lastSwapCount = 0;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "TileCollisionGrid.h"
+#include <cmath>
+#include <algorithm>
+
+void TileCollisionGrid::Reset(int numCols, int numRows, float cellSize)
+{
+    this->numCols = numCols > 0 ? numCols : 0;
+    this->numRows = numRows > 0 ? numRows : 0;
+    this->cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+    numSolidCells = 0;
+
+    bits.assign((this->numCols * this->numRows + 63) / 64, 0);
+}
+
+void TileCollisionGrid::SetSolid(int col, int row, bool isSolid)
+{
+    if (col < 0 || row < 0 || col >= numCols || row >= numRows) return;
+    if (IsSolid(col, row) == isSolid) return;
+
+    const int index = row * numCols + col;
+    bits[index >> 6] ^= (uint64_t(1) << (index & 63));
+    numSolidCells += isSolid ? 1 : -1;
+}
+
+bool TileCollisionGrid::OverlapsSolid(const AABB& box, int& outCol, int& outRow) const
+{
+    if (IsEmpty()) return false;
+
+    // Edges touching a cell border do not count, same as the AABB test between colliders
+    const int firstCol = std::max(0, static_cast<int>(std::floor(box.minX / cellSize)));
+    const int firstRow = std::max(0, static_cast<int>(std::floor(box.minY / cellSize)));
+    const int lastCol = std::min(numCols - 1, static_cast<int>(std::ceil(box.maxX / cellSize)) - 1);
+    const int lastRow = std::min(numRows - 1, static_cast<int>(std::ceil(box.maxY / cellSize)) - 1);
+
+    for (int row = firstRow; row <= lastRow; row++)
+    {
+        for (int col = firstCol; col <= lastCol; col++)
+        {
+            if (IsSolid(col, row))
+            {
+                outCol = col;
+                outRow = row;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
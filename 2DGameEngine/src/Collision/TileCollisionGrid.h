@@ -0,0 +1,69 @@
+#ifndef TILECOLLISIONGRID_H
+#define TILECOLLISIONGRID_H
+
+#include <vector>
+#include <cstdint>
+#include "CollisionPair.h"
+
+/**
+ * Bit-packed solid/non-solid grid built from the level tilemap.
+ *
+ * Blocking terrain does not need one collider entity per tile: a box is tested against the grid
+ * by looking up only the cells it covers, so the static world costs nothing when nothing touches it.
+ */
+class TileCollisionGrid
+{
+public:
+    TileCollisionGrid() = default;
+
+    /**
+     * Resizes the grid and marks every cell as non-solid.
+     *
+     * @param numCols Number of tile columns of the map.
+     * @param numRows Number of tile rows of the map.
+     * @param cellSize Size of a tile in world units (tile size times map scale).
+     */
+    void Reset(int numCols, int numRows, float cellSize);
+
+    void SetSolid(int col, int row, bool isSolid);
+
+    /**
+     * Checks a single cell. Cells outside the map are never solid.
+     */
+    bool IsSolid(int col, int row) const
+    {
+        if (col < 0 || row < 0 || col >= numCols || row >= numRows) return false;
+
+        const int index = row * numCols + col;
+        return (bits[index >> 6] >> (index & 63)) & 1u;
+    }
+
+    /**
+     * Tests a box against the cells it covers.
+     *
+     * @param box The world space bounds to test.
+     * @param outCol Receives the column of the first solid cell found.
+     * @param outRow Receives the row of the first solid cell found.
+     * @return True if the box overlaps at least one solid cell.
+     */
+    bool OverlapsSolid(const AABB& box, int& outCol, int& outRow) const;
+
+    /**
+     * True when no cell is solid, so callers can skip the tests entirely.
+     */
+    bool IsEmpty() const { return numSolidCells == 0; }
+
+    int GetNumCols() const { return numCols; }
+    int GetNumRows() const { return numRows; }
+    float GetCellSize() const { return cellSize; }
+    int GetNumSolidCells() const { return numSolidCells; }
+
+private:
+    std::vector<uint64_t> bits;
+    int numCols = 0;
+    int numRows = 0;
+    float cellSize = 1.0f;
+    int numSolidCells = 0;
+};
+
+#endif
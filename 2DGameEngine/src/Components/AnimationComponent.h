@@ -1,26 +1,23 @@
 #ifndef ANIMATIONCOMPONENT_H
 #define ANIMATIONCOMPONENT_H
 
-#include <SDL2/SDL.h>
-
-
+/**
+ * Plays a clip of the animation clip table, the frame shown only depends on
+ * the time elapsed since startTime.
+ */
 struct AnimationComponent
 {
-    int numFrames;
-    int currentFrame;
-    int frameSpeedRate;
-    bool isLoop;
-    int startTime;
+    int clipId;
+    double startTime;       /**< Simulation time the clip started at, in seconds */
+    int rowOffset;          /**< Added to the y of the clip frames, the spritesheet row of a direction without its own clip */
 
-    AnimationComponent(int numFrames = 1, int frameSpeedRate = 1, bool isLoop = true)
+    AnimationComponent(int clipId = -1, double startTime = 0.0)
     {
-        this->numFrames = numFrames;
-        this->currentFrame = 1;
-        this->frameSpeedRate = frameSpeedRate;
-        this->isLoop = isLoop;
-        this->startTime = SDL_GetTicks();
+        this->clipId = clipId;
+        this->startTime = startTime;
+        this->rowOffset = 0;
     }
 };
 
 
-#endif
\ No newline at end of file
+#endif
@@ -8,12 +8,14 @@ struct BoxCollisionComponent
     int width;
     int height;
     glm::vec2 offset;
+    int layer;
 
-    BoxCollisionComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0))
+    BoxCollisionComponent(int width = 0, int height = 0, glm::vec2 offset = glm::vec2(0), int layer = 0)
     {
         this->width = width;
         this->height = height;
         this->offset = offset;
+        this->layer = layer;
     }
 };
 
@@ -9,13 +9,15 @@ struct CircleCollisionComponent
     int height;
     int radius;
     glm::vec2 offset;
+    int layer;
 
-    CircleCollisionComponent(int width = 0, int height, int radius, glm::vec2 offset = glm::vec2(0))
+    CircleCollisionComponent(int width = 0, int height = 0, int radius = 0, glm::vec2 offset = glm::vec2(0), int layer = 0)
     {
         this->width = width;
         this->height = height;
         this->radius = radius;
         this->offset = offset;
+        this->layer = layer;
     }
 };
 
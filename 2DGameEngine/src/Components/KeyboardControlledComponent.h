@@ -10,12 +10,25 @@ struct KeyboardControlledComponent
 	glm::vec2 downVelocity;
 	glm::vec2 leftVelocity;
 
-	KeyboardControlledComponent(glm::vec2 upVelocity = glm::vec2(0), glm::vec2 rightVelocity = glm::vec2(0), glm::vec2 downVelocity = glm::vec2(0), glm::vec2 leftVelocity = glm::vec2(0))
+	/**
+	 * Animation clip played in each direction, -1 to pick the spritesheet row instead
+	 */
+	int upClip;
+	int rightClip;
+	int downClip;
+	int leftClip;
+
+	KeyboardControlledComponent(glm::vec2 upVelocity = glm::vec2(0), glm::vec2 rightVelocity = glm::vec2(0), glm::vec2 downVelocity = glm::vec2(0), glm::vec2 leftVelocity = glm::vec2(0),
+		int upClip = -1, int rightClip = -1, int downClip = -1, int leftClip = -1)
 	{
 		this->upVelocity = upVelocity;
 		this->rightVelocity = rightVelocity;
 		this->downVelocity = downVelocity;
 		this->leftVelocity = leftVelocity;
+		this->upClip = upClip;
+		this->rightClip = rightClip;
+		this->downClip = downClip;
+		this->leftClip = leftClip;
 	}
 };
 
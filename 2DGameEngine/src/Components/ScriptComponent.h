@@ -0,0 +1,22 @@
+#ifndef SCRIPTCOMPONENT_H
+#define SCRIPTCOMPONENT_H
+
+/**
+ * Runs a Lua update function of the ScriptSystem on the entity.
+ */
+struct ScriptComponent
+{
+    static constexpr int INVALID_SCRIPT = -1;
+
+    int scriptId;               /**< Script index in the ScriptSystem, INVALID_SCRIPT once it failed */
+    double lastUpdateTime;      /**< Simulation time of the last update, in seconds, negative before the first one */
+
+    ScriptComponent(int scriptId = INVALID_SCRIPT)
+    {
+        this->scriptId = scriptId;
+        this->lastUpdateTime = -1.0;
+    }
+};
+
+
+#endif
@@ -3,12 +3,14 @@
 
 #include <string>
 #include <SDL2/SDL.h>
+#include "../AssetManager/AssetHandle.h"
 
 struct SpriteComponent
 {
     int width;
     int height;
     std::string assetID;
+    TextureHandle texture;  // resolved from assetID by the level loader or on the first render
     int zIndex;
     SDL_RendererFlip flip;
     bool isFixed;
@@ -4,12 +4,14 @@
 #include <string>
 #include <glm/glm.hpp>
 #include <SDL2/SDL.h>
+#include "../AssetManager/AssetHandle.h"
 
 struct TextRenderComponent
 {
     glm::vec2 position;
     std::string text;
     std::string assetId;
+    FontHandle font;        // resolved from assetId on the first render
     SDL_Color color;
     bool isFixed;
 
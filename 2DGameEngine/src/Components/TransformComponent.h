@@ -9,12 +9,20 @@ struct TransformComponent
 	glm::vec2 position;
 	glm::vec2 scale;
 
+	/**
+	 * State at the start of the last simulation step, rendering blends it with the current one
+	 */
+	glm::vec2 previousPosition;
+	double previousRotation;
+
 
 	TransformComponent(glm::vec2 position = glm::vec2(0, 0), glm::vec2 scale = glm::vec2(1, 1), double rotation = 0.0)
 	{
 		this->position = position;
 		this->scale = scale;
 		this->rotation = rotation;
+		this->previousPosition = position;
+		this->previousRotation = rotation;
 	}
 };
 	
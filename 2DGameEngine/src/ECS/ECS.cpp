@@ -28,7 +28,7 @@ int Entity::GetID() const
 void Entity::Kill()
 {
     registry->KillEntity(*this);
-    Logger::Log("Kill entity - " + GetName() + " id: " + std::to_string(GetID()));
+    Logger::Log("Kill entity - {} id: {}", GetName(), GetID());
 }
 
 void Entity::Tag(const std::string& tag)
@@ -98,6 +98,14 @@ const Signature& System::GetComponentSignature() const
     return componentSignature;
 }
 
+/**
+ * @brief Number of entities tracked by the system, without copying them.
+ */
+int System::GetNumEntities() const
+{
+    return static_cast<int>(entities.size());
+}
+
 /**
  * @brief Updates the registry, handling additions and removals of entities from systems.
  * 
@@ -171,7 +179,7 @@ Entity Registry::CreateEntity()
     entity.registry= this;
     entitiesToBeAdded.insert(entity);
 
-    Logger::Log("Entity created with id = " + std::to_string(entityId));
+    Logger::Log("Entity created with id = {}", entityId);
 
     return entity;
 }
@@ -296,4 +304,68 @@ void Registry::RemoveEntityFromSystems(Entity entity)
     {
         system.second->RemoveEntityFromSystem(entity);
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Turns a type_info name into the class name: drops the "class "/"struct " prefix of MSVC
+ * and the length prefix of the Itanium mangling used by GCC and Clang.
+ */
+static std::string GetReadableTypeName(const std::string& typeName)
+{
+    std::string name = typeName;
+    for (const std::string prefix : { "class ", "struct " })
+    {
+        if (name.compare(0, prefix.size(), prefix) == 0)
+        {
+            name.erase(0, prefix.size());
+        }
+    }
+
+    size_t nameStart = 0;
+    while (nameStart < name.size() && name[nameStart] >= '0' && name[nameStart] <= '9')
+    {
+        nameStart++;
+    }
+    return name.substr(nameStart);
+}
+
+int Registry::GetNumEntities() const
+{
+    return numEntities - static_cast<int>(freeIDs.size());
+}
+
+std::vector<SystemStats> Registry::GetSystemStats() const
+{
+    std::vector<SystemStats> stats;
+    for (const auto& system : systems)
+    {
+        SystemStats systemStats;
+        systemStats.name = GetReadableTypeName(system.first.name());
+        systemStats.numEntities = system.second->GetNumEntities();
+        stats.push_back(systemStats);
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const SystemStats& a, const SystemStats& b) { return a.name < b.name; });
+    return stats;
+}
+
+std::vector<PoolStats> Registry::GetPoolStats() const
+{
+    std::vector<PoolStats> stats;
+    for (size_t componentID = 0; componentID < componentPools.size(); componentID++)
+    {
+        if (!componentPools[componentID])
+        {
+            continue;
+        }
+
+        PoolStats poolStats;
+        poolStats.name = GetReadableTypeName(componentNames[componentID]);
+        poolStats.numComponents = componentPools[componentID]->GetNumComponents();
+        poolStats.capacity = componentPools[componentID]->GetCapacity();
+        stats.push_back(poolStats);
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const PoolStats& a, const PoolStats& b) { return a.name < b.name; });
+    return stats;
+}
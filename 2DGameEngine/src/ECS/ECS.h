@@ -103,7 +103,7 @@ public:
     /**
      * 
      */
-    std::string GetName() const { return Name; }
+    const std::string& GetName() const { return Name; }
 
     /**
      * 
@@ -190,9 +190,14 @@ public:
     System() = default;
     virtual ~System() = default;
 
-    void AddEntityToSystem(Entity entity);
-    void RemoveEntityFromSystem(Entity entity);
+    /**
+     * Adds/removes an entity to the system. Virtual so systems that keep their own
+     * acceleration structures can update them incrementally.
+     */
+    virtual void AddEntityToSystem(Entity entity);
+    virtual void RemoveEntityFromSystem(Entity entity);
     std::vector<Entity> GetSystemEntity() const;
+    int GetNumEntities() const;
     const Signature& GetComponentSignature() const;
 
     template<typename TComponent> 
@@ -209,6 +214,8 @@ class IPool
 public:
     virtual ~IPool() = default;
     virtual void RemoveEntityFromPool(int entityId) = 0;
+    virtual int GetNumComponents() const = 0;
+    virtual int GetCapacity() const = 0;
 
 };
 
@@ -279,6 +286,17 @@ public:
         data.resize(n); 
     }
 
+    /**
+     * Makes room for at least n objects, so the next Set calls do not grow the pool.
+     */
+    void Reserve(int n)
+    {
+        if (n > static_cast<int>(data.size()))
+        {
+            data.resize(n);
+        }
+    }
+
     /**
      * Clears all objects from the pool.
      */
@@ -361,6 +379,16 @@ public:
         }
     }
 
+    virtual int GetNumComponents() const override
+    {
+        return size;
+    }
+
+    virtual int GetCapacity() const override
+    {
+        return static_cast<int>(data.size());
+    }
+
 
     /**
      * Provides array-style access to the pool.
@@ -374,6 +402,25 @@ public:
     }
 };
 
+/**
+ * Number of entities a system processes, for the debug GUI.
+ */
+struct SystemStats
+{
+    std::string name;
+    int numEntities = 0;
+};
+
+/**
+ * Number of components stored in a pool and the number of slots allocated, for the debug GUI.
+ */
+struct PoolStats
+{
+    std::string name;
+    int numComponents = 0;
+    int capacity = 0;
+};
+
 /**
  * The Registry class manages entities, components, and systems within an ECS (Entity-Component-System) architecture.
  */
@@ -390,6 +437,11 @@ private:
      */
     std::vector<std::shared_ptr<IPool>> componentPools;
 
+    /**
+     * Type name of the component of each pool, by component id
+     */
+    std::vector<std::string> componentNames;
+
     /** 
      * Stores a signature for each entity, representing the components associated with the entity.
      */
@@ -419,6 +471,12 @@ private:
 
     std::deque<int> freeIDs;
 
+    /**
+     * Retrieves the pool of `TComponent`, creating it on first use.
+     */
+    template<typename TComponent>
+    std::shared_ptr<Pool<TComponent>> GetOrCreatePool();
+
 public:
     /**
      * Default constructor for the Registry.
@@ -472,6 +530,15 @@ public:
     template<typename TComponent,typename ...TArgs>
     void AddComponent(Entity entity, TArgs&& ...args);
 
+    /**
+     * Makes room in the pool of `TComponent` for count more components, before adding many at once.
+     *
+     * @tparam TComponent The type of component to reserve.
+     * @param count The number of components about to be added.
+     */
+    template<typename TComponent>
+    void ReserveComponents(int count);
+
     /**
      * Removes a component of type `TComponent` from the specified entity.
      *
@@ -553,6 +620,21 @@ public:
      */
     void RemoveEntityFromSystems(Entity entity);
 
+    /**
+     * Number of entities alive, including the ones added at the next Update.
+     */
+    int GetNumEntities() const;
+
+    /**
+     * Number of entities of every system, sorted by system name.
+     */
+    std::vector<SystemStats> GetSystemStats() const;
+
+    /**
+     * Size and capacity of every component pool, sorted by component name.
+     */
+    std::vector<PoolStats> GetPoolStats() const;
+
 
 
 
@@ -586,25 +668,54 @@ inline void Registry::AddComponent(Entity entity, TArgs &&...args)
     const auto componentID = Component<TComponent>::GetID();
     const auto entityID = entity.GetID();
 
+    std::shared_ptr<Pool<TComponent>> componentPool = GetOrCreatePool<TComponent>();
+
+    TComponent newComponent(std::forward<TArgs>(args)...);
+
+    componentPool->Set(entityID, newComponent);
+    entityComponentSignatures[entityID].set(componentID);
+
+    Logger::Log("Component id = {} was added to entity id {}", componentID, entityID);
+}
+
+/**
+ * Grows the pool of `TComponent` so the next count components are added without reallocating it.
+ *
+ * @tparam TComponent The type of component to reserve.
+ * @param count The number of components about to be added.
+ */
+template <typename TComponent>
+inline void Registry::ReserveComponents(int count)
+{
+    std::shared_ptr<Pool<TComponent>> componentPool = GetOrCreatePool<TComponent>();
+    componentPool->Reserve(componentPool->GetSize() + count);
+}
+
+/**
+ * Retrieves the pool of `TComponent`, creating it and registering its name on first use.
+ *
+ * @tparam TComponent The type of component of the pool.
+ * @return The pool of the component type.
+ */
+template <typename TComponent>
+inline std::shared_ptr<Pool<TComponent>> Registry::GetOrCreatePool()
+{
+    const auto componentID = Component<TComponent>::GetID();
+
     if (componentID >= static_cast<int>(componentPools.size()))
     {
         componentPools.resize(componentID + 1, nullptr);
+        componentNames.resize(componentID + 1);
     }
 
     if (!componentPools[componentID])
     {
         std::shared_ptr<Pool<TComponent>> newComponentPool = std::make_shared<Pool<TComponent>>();
         componentPools[componentID] = newComponentPool;
+        componentNames[componentID] = typeid(TComponent).name();
     }
 
-    std::shared_ptr<Pool<TComponent>> componentPool = std::static_pointer_cast<Pool<TComponent>>(componentPools[componentID]);
-
-    TComponent newComponent(std::forward<TArgs>(args)...);
-
-    componentPool->Set(entityID, newComponent);
-    entityComponentSignatures[entityID].set(componentID);
-
-    Logger::Log("Component id = " + std::to_string(componentID) + " was added to entity id " + std::to_string(entityID));
+    return std::static_pointer_cast<Pool<TComponent>>(componentPools[componentID]);
 }
 
 /**
@@ -623,7 +734,7 @@ inline void Registry::RemoveComponent(Entity entity)
     componentPool->Remove(entityID);
 
     entityComponentSignatures[entityID].set(componentID, false);
-    Logger::Log("Component id = " + std::to_string(componentID) + " was remove from entity id " + std::to_string(entityID));
+    Logger::Log("Component id = {} was remove from entity id {}", componentID, entityID);
 }
 
 /**
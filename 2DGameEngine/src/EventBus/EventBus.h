@@ -210,6 +210,21 @@ public:
 		subscribers[typeid(TEvent)]->push_back(std::move(subscriber));
 	}
 
+    /**
+     * @brief Checks if at least one handler is subscribed to an event type.
+     * 
+     * Lets producers skip building events nobody listens to.
+     * 
+     * @tparam TEvent The event type to check.
+     * @return True if the event type has subscribers, false otherwise.
+     */
+	template<typename TEvent>
+	bool HasSubscribers() const
+	{
+		const auto handlers = subscribers.find(typeid(TEvent));
+		return handlers != subscribers.end() && handlers->second && !handlers->second->empty();
+	}
+
     /**
      * @brief Emits an event and invokes all subscribed handlers.
      * 
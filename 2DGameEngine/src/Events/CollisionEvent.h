@@ -4,6 +4,11 @@
 #include "../ECS/ECS.h"
 #include "../EventBus/Event.h"
 
+/**
+ * Base class of the collision events, holds the two entities of the contact.
+ * The CollisionSystem emits one of the derived types below, subscribers pick the
+ * phase of the contact they are interested in.
+ */
 class CollisionEvent : public Event
 {
 public:
@@ -13,5 +18,33 @@ public:
 	CollisionEvent(Entity a, Entity b) : a(a), b(b) {}
 };
 
+/**
+ * Emitted once, on the first frame two colliders overlap.
+ */
+class CollisionEnterEvent : public CollisionEvent
+{
+public:
+	CollisionEnterEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+/**
+ * Emitted every following frame while the two colliders keep overlapping.
+ */
+class CollisionStayEvent : public CollisionEvent
+{
+public:
+	CollisionStayEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
+/**
+ * Emitted once, when the two colliders stop overlapping or one of them is removed.
+ * Either entity may already be killed, so handlers should not access its components.
+ */
+class CollisionExitEvent : public CollisionEvent
+{
+public:
+	CollisionExitEvent(Entity a, Entity b) : CollisionEvent(a, b) {}
+};
+
 
 #endif
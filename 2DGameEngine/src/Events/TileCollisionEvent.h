@@ -0,0 +1,21 @@
+#ifndef TILECOLLISIONEVENT_H
+#define TILECOLLISIONEVENT_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/Event.h"
+
+/**
+ * Emitted once when a moving collider starts touching a solid tile of the map.
+ */
+class TileCollisionEvent : public Event
+{
+public:
+	Entity entity;
+	int tileCol;
+	int tileRow;
+
+	TileCollisionEvent(Entity entity, int tileCol, int tileRow) : entity(entity), tileCol(tileCol), tileRow(tileRow) {}
+};
+
+
+#endif
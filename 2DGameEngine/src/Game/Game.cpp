@@ -3,6 +3,9 @@
 #include <fstream>
 #include <glm/glm.hpp>
 #include <SDL2/SDL_image.h>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
 
 #include "LevelLoader.h"
 #include "../Utilities/Utils.h"
@@ -20,7 +23,9 @@
 #include "../Systems/MovementSystem.h"
 #include "../Systems/AnimationSystem.h"
 #include "../Systems/CollisionSystem.h"
+#include "../Systems/TileCollisionSystem.h"
 #include "../Systems/RenderColliderSystem.h"
+#include "../Systems/RenderCircleColliderSystem.h"
 #include "../Systems/DamageSystem.h"
 #include "../Systems/KeyboardControlSystem.h"
 #include "../Systems/CameraMovementSystem.h"
@@ -29,6 +34,8 @@
 #include "../Systems/RenderTextSystem.h"
 #include "../Systems/RenderHealthBarSystem.h"
 #include "../Systems/RenderGUISystem.h"
+#include "../Systems/TransformInterpolationSystem.h"
+#include "../Systems/ScriptSystem.h"
 
 
 #include <imgui/imgui_impl_sdl.h>
@@ -36,24 +43,104 @@
 
 #include "../Utilities/Macro.h"
 
-constexpr int LevelNum = 1;
-
 int Game::WindowWidth;
 int Game::WindowHeight;
 int Game::MapHeight;
 int Game::MapWidth;
 
 bool Game::isEditMode = false;
+
+namespace
+{
+	/**
+	 * Sections of the frame measured by the render profiler, in the order they are registered
+	 */
+	enum ERenderSection
+	{
+		ERS_Clear,
+		ERS_Tilemap,
+		ERS_Sprites,
+		ERS_Text,
+		ERS_HealthBars,
+		ERS_Colliders,
+		ERS_SimulationWait,
+		ERS_GUI,
+		ERS_Capture,
+		ERS_Present,
+		ERS_Count
+	};
+
+	/**
+	 * Simulation systems measured by the simulation profiler
+	 */
+	enum ESimulationSection
+	{
+		ESS_Registry,
+		ESS_Script,
+		ESS_Movement,
+		ESS_Collision,
+		ESS_TileCollision,
+		ESS_ProjectileEmitter,
+		ESS_ProjectileLifeCycle,
+		ESS_ScriptGC,
+		ESS_Animation,
+		ESS_Capture,
+		ESS_Count
+	};
+
+	const char* const SimulationSectionNames[ESS_Count] =
+	{
+		"Registry",
+		"ScriptSystem",
+		"MovementSystem",
+		"CollisionSystem",
+		"TileCollisionSystem",
+		"ProjectileEmitterSystem",
+		"ProjectileLifeCycleSystem",
+		"LuaGC",
+		"AnimationSystem",
+		"SnapshotCapture"
+	};
+
+	const char* const RenderSectionNames[ERS_Count] =
+	{
+		"Clear",
+		"TilemapRenderer",
+		"RenderSystem",
+		"RenderTextSystem",
+		"RenderHealthBarSystem",
+		"RenderColliderSystem",
+		"SimulationWait",
+		"RenderGUISystem",
+		"FrameCapture",
+		"Present"
+	};
+}
+
 /**
  * 
  */
-Game::Game()
+Game::Game(const GameSettings& settings)
+	: settings(settings)
 {
 	isRunning = false;
 	isDebug = false;
+	lua = std::make_unique<sol::state>();
 	registry = std::make_unique<Registry>();
 	assetManager = std::make_unique<AssetManager>();
 	eventBus = std::make_unique<EventBus>();
+	tilemapRenderer = std::make_unique<TilemapRenderer>();
+	textRenderer = std::make_unique<TextRenderer>();
+	debugDraw = std::make_unique<DebugDraw>();
+
+	for (int section = 0; section < ERS_Count; section++)
+	{
+		renderProfiler.AddSection(RenderSectionNames[section]);
+	}
+	for (int section = 0; section < ESS_Count; section++)
+	{
+		simulationProfiler.AddSection(SimulationSectionNames[section]);
+	}
 	Logger::Log("Game costructor called");
 }
 
@@ -71,26 +158,37 @@ Game::~Game()
 void Game::Initialize()
 {
 	Logger::Log("Initialize Game engine");
-	check(SDL_Init(SDL_INIT_EVERYTHING) == 0, "Error initialize SDL.");
-	check(TTF_Init() == 0, "Error initialize SDL TTF ");
-	
-	SDL_DisplayMode displayMode;
-	SDL_GetCurrentDisplayMode(0, &displayMode);
-	WindowWidth = displayMode.w;
-	WindowHeight = displayMode.h;
 
-	window = SDL_CreateWindow(
-		NULL,
-		SDL_WINDOWPOS_CENTERED,
-		SDL_WINDOWPOS_CENTERED,
-		WindowWidth,
-		WindowHeight,
-		SDL_WINDOW_BORDERLESS);
+	if (settings.isHeadless)
+	{
+		check(InitializeHeadless(), "Error initialize headless rendering.");
+		check(TTF_Init() == 0, "Error initialize SDL TTF ");
+	}
+	else
+	{
+		check(SDL_Init(SDL_INIT_EVERYTHING) == 0, "Error initialize SDL.");
+		check(TTF_Init() == 0, "Error initialize SDL TTF ");
+		
+		SDL_DisplayMode displayMode;
+		SDL_GetCurrentDisplayMode(0, &displayMode);
+		WindowWidth = displayMode.w;
+		WindowHeight = displayMode.h;
+
+		window = SDL_CreateWindow(
+			NULL,
+			SDL_WINDOWPOS_CENTERED,
+			SDL_WINDOWPOS_CENTERED,
+			WindowWidth,
+			WindowHeight,
+			SDL_WINDOW_BORDERLESS);
 
-	check(window, "Error Creating SDL Window");
+		check(window, "Error Creating SDL Window");
 
-	renderer = SDL_CreateRenderer(window, -1, 0);
-	check(renderer, "Error Creating SDL renderer");
+		renderer = SDL_CreateRenderer(window, -1, 0);
+		check(renderer, "Error Creating SDL renderer");
+
+		SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN);
+	}
 
 	// imgui context 
 	ImGui::CreateContext();
@@ -103,26 +201,100 @@ void Game::Initialize()
 	camera.h = WindowHeight;
 	camera.w = WindowWidth;
 
-	SDL_SetWindowFullscreen(window, SDL_WINDOW_FULLSCREEN);
 	isRunning = true;
 }
 
-void Game::InitializeSystems()
+/**
+ * Headless mode needs no display nor GPU: SDL runs on the offscreen (or dummy) video driver, only
+ * for its events, and the software renderer draws into a surface of the requested size.
+ */
+bool Game::InitializeHeadless()
+{
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "offscreen");
+	if (SDL_Init(SDL_INIT_VIDEO) != 0)
+	{
+		Logger::Warn("Offscreen video driver not available, using the dummy driver");
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		if (SDL_Init(SDL_INIT_VIDEO) != 0)
+		{
+			Logger::Err(std::string("Error initialize SDL: ") + SDL_GetError());
+			return false;
+		}
+	}
+
+	WindowWidth = settings.width;
+	WindowHeight = settings.height;
+
+	headlessTarget = SDL_CreateRGBSurfaceWithFormat(0, WindowWidth, WindowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!headlessTarget)
+	{
+		Logger::Err(std::string("Error creating the headless frame: ") + SDL_GetError());
+		return false;
+	}
+
+	renderer = SDL_CreateSoftwareRenderer(headlessTarget);
+	if (!renderer)
+	{
+		Logger::Err(std::string("Error creating the software renderer: ") + SDL_GetError());
+		return false;
+	}
+
+	Logger::Log("Headless rendering " + std::to_string(WindowWidth) + "x" + std::to_string(WindowHeight));
+	return true;
+}
+
+void Game::InitializeSystems(Registry& levelRegistry)
 {
 	// registry logic 
-	registry->AddSystem<MovementSystem>();
-	registry->AddSystem<RenderSystem>();
-	registry->AddSystem<AnimationSystem>();
-	registry->AddSystem<CollisionSystem>();
-	registry->AddSystem<RenderColliderSystem>();
-	registry->AddSystem<DamageSystem>();
-	registry->AddSystem<KeyboardControlSystem>();
-	registry->AddSystem<CameraMovementSystem>();
-	registry->AddSystem<ProjectileEmitterSystem>();
-	registry->AddSystem<ProjectileLifeCycleSystem>();
-	registry->AddSystem<RenderTextSystem>();
-	registry->AddSystem<RenderHealthBarSystem>();
-	registry->AddSystem<RenderGUISystem>();
+	levelRegistry.AddSystem<MovementSystem>();
+	levelRegistry.AddSystem<RenderSystem>();
+	levelRegistry.AddSystem<AnimationSystem>();
+	levelRegistry.AddSystem<CollisionSystem>();
+	levelRegistry.AddSystem<TileCollisionSystem>();
+	levelRegistry.AddSystem<RenderColliderSystem>();
+	levelRegistry.AddSystem<RenderCircleColliderSystem>();
+	levelRegistry.AddSystem<DamageSystem>();
+	levelRegistry.AddSystem<KeyboardControlSystem>();
+	levelRegistry.AddSystem<CameraMovementSystem>();
+	levelRegistry.AddSystem<ProjectileEmitterSystem>();
+	levelRegistry.AddSystem<ProjectileLifeCycleSystem>();
+	levelRegistry.AddSystem<RenderTextSystem>();
+	levelRegistry.AddSystem<RenderHealthBarSystem>();
+	levelRegistry.AddSystem<RenderGUISystem>();
+	levelRegistry.AddSystem<TransformInterpolationSystem>();
+	levelRegistry.AddSystem<ScriptSystem>();
+}
+
+/**
+ * Budgets and archive of the assets of a level
+ */
+void Game::SetUpLevelAssets(AssetManager& levelAssets, TilemapRenderer& levelTilemap)
+{
+	levelAssets.SetTextureBudget(static_cast<size_t>(settings.textureBudgetMB) * 1024 * 1024);
+	levelTilemap.SetChunkBudget(static_cast<size_t>(settings.tilemapBudgetMB) * 1024 * 1024);
+
+	// the archive replaces the asset files when it was packed, see tools/AssetPacker.cpp
+	if (!settings.archivePath.empty() && !levelAssets.MountArchive(renderer, settings.archivePath))
+	{
+		Logger::Log("No asset archive at " + settings.archivePath + ", reading the asset files");
+	}
+}
+
+/**
+ * Empty level ready to be preloaded: its own Lua state, registry with every system, asset
+ * manager and tilemap
+ */
+LevelContext Game::CreateLevelContext()
+{
+	LevelContext level;
+	level.lua = std::make_unique<sol::state>();
+	level.lua->open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
+	level.registry = std::make_unique<Registry>();
+	InitializeSystems(*level.registry);
+	level.assetManager = std::make_unique<AssetManager>();
+	level.tilemapRenderer = std::make_unique<TilemapRenderer>();
+	SetUpLevelAssets(*level.assetManager, *level.tilemapRenderer);
+	return level;
 }
 
 /**
@@ -130,28 +302,349 @@ void Game::InitializeSystems()
  */
 void Game::Setup()
 {
-	InitializeSystems();
+	InitializeSystems(*registry);
+	SetUpLevelAssets(*assetManager, *tilemapRenderer);
 
 	LevelLoader loader;
-	lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
-	loader.LoadLevel(lua,registry,assetManager,renderer,1);
+	loader.SetScriptCacheDirectory(settings.scriptCacheDirectory);
+	levelManager.SetScriptCacheDirectory(settings.scriptCacheDirectory);
+	lua->open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
+	auto& scriptSystem = registry->GetSystem<ScriptSystem>();
+	scriptSystem.Initialize(*lua);
+	currentLevel = settings.startLevel;
+	loader.LoadLevel(*lua,registry,assetManager,tilemapRenderer,renderer,currentLevel);
+
+	// from now on the collector only runs in the steps the script system gives it
+	scriptSystem.StopAutomaticGarbageCollection();
+
+	// headless captures have to be reproducible, they start with every asset loaded
+	if (settings.isHeadless && assetManager->IsLoading())
+	{
+		assetManager->FinishLoading(renderer);
+		tilemapRenderer->Bake(renderer, *assetManager);
+	}
+	else if (settings.showLoadingScreen)
+	{
+		RunLoadingScreen();
+	}
 }
 
 /**
- * 
+ * Keeps the textures within their budget and hands the assets loaded in the background to the
+ * asset manager. The tilemap is baked once the last one arrives if the level loader could not
+ * bake it without its textures.
+ */
+void Game::UploadLoadedAssets(double budgetMs)
+{
+	assetManager->UpdateResidency();
+	if (!assetManager->IsLoading())
+	{
+		return;
+	}
+
+	assetManager->UploadLoadedAssets(renderer, budgetMs);
+	if (!assetManager->IsLoading() && !tilemapRenderer->IsBaked())
+	{
+		tilemapRenderer->Bake(renderer, *assetManager);
+	}
+}
+
+/**
+ * Starts preloading the next level once the current one is loaded, so they do not compete for
+ * the loader, uploads its textures and switches to it when asked and it is ready.
+ */
+void Game::UpdateLevels()
+{
+	if (!levelManager.IsPreloading() && !levelManager.HasFailed() && !assetManager->IsLoading())
+	{
+		const int nextLevel = LevelManager::GetNextLevel(*assetManager, currentLevel);
+		levelManager.Preload(nextLevel, CreateLevelContext(), *assetManager, TextureAtlas::GetMaxTextureSize(renderer));
+	}
+	levelManager.Update(renderer, *assetManager, ASSET_UPLOAD_BUDGET_MS);
+
+	// a scheduled switch waits for the level, the frame it happens at is the same on every run
+	if (settings.levelSwitchFrame > 0 && frameCount == settings.levelSwitchFrame)
+	{
+		isLevelSwitchRequested = true;
+		levelManager.FinishLoading(renderer, *assetManager);
+	}
+
+	if (isLevelSwitchRequested && levelManager.HasFailed())
+	{
+		Logger::Warn("The next level could not be loaded, staying on level " + std::to_string(currentLevel));
+		isLevelSwitchRequested = false;
+	}
+	else if (isLevelSwitchRequested && levelManager.IsReady())
+	{
+		SwitchLevel();
+	}
+}
+
+/**
+ * Swaps the preloaded level in, while the worker is idle. Only pointers move: the shared textures
+ * change owner and the old level is handed to the level manager, which releases the assets the
+ * new level does not use and frees the old entities in the background.
+ */
+void Game::SwitchLevel()
+{
+	const Uint64 switchStart = SDL_GetPerformanceCounter();
+	isLevelSwitchRequested = false;
+
+	LevelContext level = levelManager.TakeLevel();
+	level.assetManager->TakeSharedTextures(*assetManager);
+
+	const int previousLevel = currentLevel;
+	currentLevel = level.levelNumber;
+	MapWidth = level.mapWidth;
+	MapHeight = level.mapHeight;
+
+	std::swap(lua, level.lua);
+	std::swap(registry, level.registry);
+	std::swap(assetManager, level.assetManager);
+	std::swap(tilemapRenderer, level.tilemapRenderer);
+
+	// the systems of the old registry are still subscribed, and the cached text uses the old fonts
+	eventBus->Reset();
+	textRenderer->Clear();
+	levelManager.DestroyLevel(std::move(level));
+
+	accumulator = 0.0;
+	simulationTime = 0.0;
+
+	const double switchMs = (SDL_GetPerformanceCounter() - switchStart) * 1000.0 / SDL_GetPerformanceFrequency();
+	Logger::Log("Switched from level " + std::to_string(previousLevel) + " to level " + std::to_string(currentLevel) + " in " + std::to_string(switchMs) + " ms");
+
+	// the snapshot about to be drawn points to the textures of the old level, capture the new one
+	if (settings.isPipelined)
+	{
+		Simulate(0.0, isEditMode, isDebug, renderSnapshots[frontSnapshot]);
+	}
+}
+
+/**
+ * Draws a progress bar until every asset of the level is loaded, or the window is closed
+ */
+void Game::RunLoadingScreen()
+{
+	const int barWidth = WindowWidth / 2;
+	const int barHeight = 16;
+	const SDL_Rect barRect = { (WindowWidth - barWidth) / 2, (WindowHeight - barHeight) / 2, barWidth, barHeight };
+
+	while (isRunning && assetManager->IsLoading())
+	{
+		SDL_Event event;
+		while (SDL_PollEvent(&event))
+		{
+			if (event.type == SDL_QUIT || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE))
+			{
+				isRunning = false;
+			}
+		}
+
+		UploadLoadedAssets(1000.0 / FPS);
+
+		const float ratio = assetManager->GetLoadingProgress().GetRatio();
+		const SDL_Rect fillRect = { barRect.x, barRect.y, static_cast<int>(barRect.w * ratio), barRect.h };
+
+		SDL_SetRenderDrawColor(renderer, 21, 21, 21, 255);
+		SDL_RenderClear(renderer);
+		SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+		SDL_RenderFillRect(renderer, &fillRect);
+		SDL_RenderDrawRect(renderer, &barRect);
+		SDL_RenderPresent(renderer);
+
+		// leave the workers the core when nothing is ready yet
+		SDL_Delay(1);
+	}
+}
+
+/**
+ * Fixed-timestep loop: the frame time, measured with the performance counter, is accumulated
+ * and consumed in steps of 1 / simulationRate seconds, so the simulation does not depend on
+ * the frame rate. The transforms are then rendered interpolated between the last two steps.
+ *
+ * When pipelined, the worker thread simulates frame N + 1 and captures its snapshot while the
+ * main thread renders the snapshot of frame N, adding one frame of latency. Input is polled on
+ * the main thread and handed to the next simulation.
  */
 void Game::Run()
 {
 	Setup();
 
+	if (settings.isPipelined)
+	{
+		simulationThread.Start([this]()
+		{
+			Simulate(simulationFrameTime, isSimulationEditMode, isSimulationDebug, renderSnapshots[1 - frontSnapshot]);
+		});
+
+		// the first frame shows the level as loaded
+		Simulate(0.0, isEditMode, isDebug, renderSnapshots[frontSnapshot]);
+	}
+
+	const double fixedDeltaTime = 1.0 / settings.simulationRate;
+	const double counterFrequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	Uint64 previousCounter = SDL_GetPerformanceCounter();
+
 	while(isRunning)
 	{
+		const Uint64 frameStart = SDL_GetPerformanceCounter();
+		double frameTime = (frameStart - previousCounter) / counterFrequency;
+		previousCounter = frameStart;
+
+		// headless runs simulate exactly one step per frame, so runs are reproducible
+		if (settings.isHeadless) frameTime = fixedDeltaTime;
+		if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+
 		ProcessInput();
-		if (!isEditMode) Update();
-		
-		Render();
-		if (isEditMode) registry->GetSystem<RenderGUISystem>().Update(registry);
 
+		// the worker is idle here, the input of the frame can be handed over
+		simulationKeyPresses.swap(pendingKeyPresses);
+		pendingKeyPresses.clear();
+
+		// and the asset maps the snapshot capture reads can be filled, or the level swapped
+		UploadLoadedAssets(ASSET_UPLOAD_BUDGET_MS);
+		UpdateLevels();
+
+		if (settings.isPipelined)
+		{
+			simulationFrameTime = frameTime;
+			isSimulationEditMode = isEditMode;
+			isSimulationDebug = isDebug;
+			simulationThread.Kick();
+
+			Render(renderSnapshots[frontSnapshot]);
+			frontSnapshot = 1 - frontSnapshot;
+		}
+		else
+		{
+			Simulate(frameTime, isEditMode, isDebug, renderSnapshots[frontSnapshot]);
+			Render(renderSnapshots[frontSnapshot]);
+		}
+
+		if (isEditMode) UpdateGUI();
+
+		frameCount++;
+		if (settings.numFrames > 0 && frameCount >= settings.numFrames)
+		{
+			isRunning = false;
+		}
+
+		lastFrameWorkMs = (SDL_GetPerformanceCounter() - frameStart) * 1000.0 / counterFrequency;
+
+		if (!settings.isHeadless)
+		{
+			WaitForNextFrame(frameStart);
+		}
+		lastFrameMs = (SDL_GetPerformanceCounter() - frameStart) * 1000.0 / counterFrequency;
+	}
+
+	simulationThread.Stop();
+}
+
+/**
+ * Runs the fixed steps the frame time pays for, then captures the interpolated state of the
+ * frame into the snapshot. Touches the registry, never the renderer.
+ */
+void Game::Simulate(double frameTime, bool isEditModeFrame, bool isDebugFrame, RenderSnapshot& snapshot)
+{
+	const double fixedDeltaTime = 1.0 / settings.simulationRate;
+	auto& interpolationSystem = registry->GetSystem<TransformInterpolationSystem>();
+	auto& scriptSystem = registry->GetSystem<ScriptSystem>();
+	scriptSystem.BeginFrame(settings.scriptBudgetMs);
+
+	for (const SDL_Keycode key : simulationKeyPresses)
+	{
+		eventBus->EmitEvent<KeyPressedEvent>(key);
+	}
+	simulationKeyPresses.clear();
+
+	if (!isEditModeFrame)
+	{
+		accumulator += frameTime;
+
+		int steps = 0;
+		while (accumulator >= fixedDeltaTime && steps < MAX_STEPS_PER_FRAME)
+		{
+			interpolationSystem.StoreStates();
+			Update(fixedDeltaTime);
+			accumulator -= fixedDeltaTime;
+			steps++;
+		}
+
+		// too far behind, drop the backlog instead of spiraling into ever longer frames
+		if (steps == MAX_STEPS_PER_FRAME && accumulator >= fixedDeltaTime)
+		{
+			accumulator = 0.0;
+		}
+	}
+	else
+	{
+		accumulator = 0.0;
+	}
+
+	// the Lua collector gets what the scripts left of their budget
+	simulationProfiler.BeginSection(ESS_ScriptGC);
+	scriptSystem.CollectGarbage();
+	simulationProfiler.EndSection(ESS_ScriptGC);
+
+	interpolationSystem.Interpolate(accumulator / fixedDeltaTime);
+	registry->GetSystem<CameraMovementSystem>().Update(camera);
+
+	// animations only change what is drawn, they are evaluated once per frame, not per step
+	simulationProfiler.BeginSection(ESS_Animation);
+	registry->GetSystem<AnimationSystem>().Update(assetManager->GetAnimationClips(), simulationTime, camera);
+	simulationProfiler.EndSection(ESS_Animation);
+
+	simulationProfiler.BeginSection(ESS_Capture);
+	CaptureSnapshot(snapshot, isDebugFrame);
+	simulationProfiler.EndSection(ESS_Capture);
+	interpolationSystem.Restore();
+}
+
+/**
+ * Copies the render data of the current state of the registry into the snapshot
+ */
+void Game::CaptureSnapshot(RenderSnapshot& snapshot, bool isDebugFrame)
+{
+	snapshot.Clear();
+	snapshot.camera = camera;
+
+	registry->GetSystem<RenderSystem>().Capture(assetManager, snapshot);
+	registry->GetSystem<RenderTextSystem>().Capture(assetManager, snapshot);
+	registry->GetSystem<RenderHealthBarSystem>().Capture(assetManager, snapshot);
+
+	if (isDebugFrame)
+	{
+		registry->GetSystem<RenderColliderSystem>().Capture(snapshot);
+		registry->GetSystem<RenderCircleColliderSystem>().Capture(snapshot);
+	}
+}
+
+/**
+ * Caps the frame rate: sleeps while the remaining time is above the scheduler granularity,
+ * then spins on the performance counter, SDL_Delay alone may oversleep by a few milliseconds.
+ */
+void Game::WaitForNextFrame(Uint64 frameStart)
+{
+	if (settings.frameRate <= 0)
+	{
+		return;
+	}
+
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	const Uint64 frameEnd = frameStart + frequency / settings.frameRate;
+	const Uint64 sleepMargin = frequency * 2 / 1000;
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	while (now + sleepMargin < frameEnd)
+	{
+		SDL_Delay(1);
+		now = SDL_GetPerformanceCounter();
+	}
+	while (now < frameEnd)
+	{
+		now = SDL_GetPerformanceCounter();
 	}
 }
 
@@ -195,8 +688,20 @@ void Game::ProcessInput()
 				{
 					isEditMode = !isEditMode;
 				}
+				if (event.key.keysym.sym == SDLK_n)
+				{
+					isLevelSwitchRequested = true;
+				}
 
-				eventBus->EmitEvent<KeyPressedEvent>(event.key.keysym.sym);
+				pendingKeyPresses.push_back(event.key.keysym.sym);
+				break;
+			}
+
+			// the content of the render targets is lost, bake the tilemap chunks again
+			case SDL_RENDER_TARGETS_RESET:
+			case SDL_RENDER_DEVICE_RESET:
+			{
+				tilemapRenderer->Bake(renderer, *assetManager);
 				break;
 			}
 					
@@ -204,21 +709,12 @@ void Game::ProcessInput()
 	}
 }
 
-void Game::Update()
+/**
+ * Advances the simulation by one fixed step
+ */
+void Game::Update(double deltaTime)
 {
-    // If we are too fast, waste some time until we reach the MILLISECS_PER_FRAME
-    int timeToWait = MILLISECS_PER_FRAME - (SDL_GetTicks() - millisecsPreviousFrame);
-
-    if (timeToWait > 0 && timeToWait <= MILLISECS_PER_FRAME) 
-	{
-        SDL_Delay(timeToWait);
-    }
-
-    // The difference in ticks since the last frame, converted to seconds
-    double deltaTime = (SDL_GetTicks() - millisecsPreviousFrame) / 1000.0;
-
-    // Store the "previous" frame time
-    millisecsPreviousFrame = SDL_GetTicks();
+	simulationTime += deltaTime;
 
 	eventBus->Reset();
 
@@ -228,39 +724,149 @@ void Game::Update()
 	registry->GetSystem<KeyboardControlSystem>().SubscribeToEvents(eventBus);
 	registry->GetSystem<ProjectileEmitterSystem>().SubscribeToEvents(eventBus);
 
+	simulationProfiler.BeginSection(ESS_Registry);
 	registry->Update();
+	simulationProfiler.EndSection(ESS_Registry);
+
+	// scripts steer their entities before they move
+	simulationProfiler.BeginSection(ESS_Script);
+	registry->GetSystem<ScriptSystem>().Update(deltaTime, simulationTime);
+	simulationProfiler.EndSection(ESS_Script);
 
 	// update allways system 
+	simulationProfiler.BeginSection(ESS_Movement);
 	registry->GetSystem<MovementSystem>().Update(deltaTime);
-	registry->GetSystem<AnimationSystem>().Update();
+	simulationProfiler.EndSection(ESS_Movement);
+
+	simulationProfiler.BeginSection(ESS_Collision);
 	registry->GetSystem<CollisionSystem>().Update(eventBus);
-	registry->GetSystem<CameraMovementSystem>().Update(camera);
+	simulationProfiler.EndSection(ESS_Collision);
+
+	simulationProfiler.BeginSection(ESS_TileCollision);
+	registry->GetSystem<TileCollisionSystem>().Update(eventBus);
+	simulationProfiler.EndSection(ESS_TileCollision);
+
+	simulationProfiler.BeginSection(ESS_ProjectileEmitter);
 	registry->GetSystem<ProjectileEmitterSystem>().Update(registry);
+	simulationProfiler.EndSection(ESS_ProjectileEmitter);
+
+	simulationProfiler.BeginSection(ESS_ProjectileLifeCycle);
 	registry->GetSystem<ProjectileLifeCycleSystem>().Update();
+	simulationProfiler.EndSection(ESS_ProjectileLifeCycle);
 
 }
 
 /**
- * Render frame function 
+ * Render frame function, draws a snapshot without reading the registry. The registry is only
+ * touched by the debug GUI, once the simulation running on the worker is over.
  */
-void Game::Render()
+void Game::Render(const RenderSnapshot& snapshot)
 {
+	renderProfiler.BeginSection(ERS_Clear);
 	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
 	SDL_RenderClear(renderer);
+	renderProfiler.EndSection(ERS_Clear);
+
+	renderProfiler.BeginSection(ERS_Tilemap);
+	tilemapRenderer->UpdateStreaming(renderer, snapshot.camera);
+	tilemapRenderer->Render(renderer, snapshot.camera);
+	renderProfiler.EndSection(ERS_Tilemap);
 
-	registry->GetSystem<RenderSystem>().Update(renderer,assetManager, camera);
-	registry->GetSystem<RenderTextSystem>().Update(renderer, assetManager, camera);
-	registry->GetSystem<RenderHealthBarSystem>().Update(renderer, assetManager, camera);
+	renderProfiler.BeginSection(ERS_Sprites);
+	registry->GetSystem<RenderSystem>().Render(renderer, snapshot);
+	renderProfiler.EndSection(ERS_Sprites);
+
+	renderProfiler.BeginSection(ERS_Text);
+	registry->GetSystem<RenderTextSystem>().Render(renderer, textRenderer, snapshot);
+	renderProfiler.EndSection(ERS_Text);
+
+	renderProfiler.BeginSection(ERS_HealthBars);
+	registry->GetSystem<RenderHealthBarSystem>().Render(renderer, textRenderer, debugDraw, snapshot);
+	renderProfiler.EndSection(ERS_HealthBars);
 	
 	/** debug box collision from entity */
 	if (isDebug)
 	{
-		registry->GetSystem<RenderColliderSystem>().Update(renderer, camera);
-		registry->GetSystem<RenderGUISystem>().Update(registry);
+		renderProfiler.BeginSection(ERS_Colliders);
+		registry->GetSystem<RenderColliderSystem>().Render(debugDraw, snapshot);
+		registry->GetSystem<RenderCircleColliderSystem>().Render(debugDraw, snapshot);
+		debugDraw->Flush(renderer);
+		renderProfiler.EndSection(ERS_Colliders);
+	}
+
+	// time the main thread is blocked on the simulation, zero when the simulation is the shorter one
+	renderProfiler.BeginSection(ERS_SimulationWait);
+	simulationThread.Wait();
+	renderProfiler.EndSection(ERS_SimulationWait);
+
+	if (isDebug)
+	{
+		renderProfiler.BeginSection(ERS_GUI);
+		UpdateGUI();
+		renderProfiler.EndSection(ERS_GUI);
 	}
 
+	// the frame is read back before it is presented, the back buffer is undefined afterwards
+	if (settings.ShouldCaptureFrame(frameCount))
+	{
+		renderProfiler.BeginSection(ERS_Capture);
+		CaptureFrame(frameCount);
+		renderProfiler.EndSection(ERS_Capture);
+	}
+
+	renderProfiler.BeginSection(ERS_Present);
 	SDL_RenderPresent(renderer);
+	renderProfiler.EndSection(ERS_Present);
+
+}
+
+/**
+ * Draws the debug GUI, the simulation has to be idle since the GUI can spawn entities
+ */
+void Game::UpdateGUI()
+{
+	GUIFrameStats frameStats;
+	frameStats.frameMs = lastFrameMs;
+	frameStats.frameWorkMs = lastFrameWorkMs;
+	frameStats.camera = camera;
+	frameStats.renderProfiler = &renderProfiler;
+	frameStats.simulationProfiler = &simulationProfiler;
+	frameStats.assetManager = assetManager.get();
+	frameStats.tilemapRenderer = tilemapRenderer.get();
+	frameStats.scriptStats = &registry->GetSystem<ScriptSystem>().GetStats();
+
+	registry->GetSystem<RenderGUISystem>().Update(registry, frameStats);
+}
+
+/**
+ * Saves the current frame as PNG in the capture directory
+ */
+void Game::CaptureFrame(int frame)
+{
+	std::error_code error;
+	std::filesystem::create_directories(settings.captureDirectory, error);
+
+	SDL_Surface* capture = SDL_CreateRGBSurfaceWithFormat(0, WindowWidth, WindowHeight, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!capture)
+	{
+		Logger::Err("Error creating the capture surface");
+		return;
+	}
+
+	std::ostringstream filePath;
+	filePath << settings.captureDirectory << "/frame_" << std::setw(6) << std::setfill('0') << frame << ".png";
+
+	if (SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGBA32, capture->pixels, capture->pitch) != 0 ||
+		IMG_SavePNG(capture, filePath.str().c_str()) != 0)
+	{
+		Logger::Err("Error capturing frame " + filePath.str());
+	}
+	else
+	{
+		Logger::Log("Frame captured to " + filePath.str());
+	}
 
+	SDL_FreeSurface(capture);
 }
 
 /**
@@ -268,11 +874,29 @@ void Game::Render()
  */
 void Game::Destroy()
 {
+	if (settings.isHeadless || !settings.timingsFile.empty())
+	{
+		renderProfiler.LogReport();
+	}
+	if (!settings.timingsFile.empty())
+	{
+		renderProfiler.WriteReport(settings.timingsFile);
+	}
+
+	simulationThread.Stop();
+	levelManager.Clear();
 	Logger::SaveLogToFile();
+	tilemapRenderer->Clear();
+	textRenderer->Clear();
+	assetManager->ClearAssets();
 	ImGuiSDL::Deinitialize();
 	ImGui::DestroyContext();
 	SDL_DestroyRenderer(renderer);
-	SDL_DestroyWindow(window);
+	if (window)
+	{
+		SDL_DestroyWindow(window);
+	}
+	SDL_FreeSurface(headlessTarget);
 	SDL_Quit();
 }
 
@@ -5,31 +5,124 @@
 #include "../ECS/ECS.h"
 #include "../AssetManager/AssetManager.h"
 #include "../EventBus/EventBus.h"
+#include "../Renderer/TilemapRenderer.h"
+#include "../Renderer/TextRenderer.h"
+#include "../Renderer/DebugDraw.h"
+#include "../Renderer/RenderProfiler.h"
+#include "../Renderer/RenderSnapshot.h"
+#include "GameSettings.h"
+#include "LevelManager.h"
+#include "SimulationThread.h"
+#include <vector>
 #include <sol/sol.hpp>
 
 
 const int FPS = 60;
-const int MILLISECS_PER_FRAME = 1000 / FPS;
+
+/**
+ * Longest frame time fed to the simulation, in seconds, longer frames (breakpoints, window drags) are clamped
+ */
+const double MAX_FRAME_TIME = 0.25;
+
+/**
+ * Most simulation steps run in one frame, the time left over is dropped so a slow simulation cannot fall further behind
+ */
+const int MAX_STEPS_PER_FRAME = 5;
+
+/**
+ * Time a frame spends creating the textures of the assets loaded in the background, in milliseconds
+ */
+const double ASSET_UPLOAD_BUDGET_MS = 2.0;
 
 class Game
 {
 	
 	bool isRunning = false;
 	bool isDebug = false;
-	int millisecsPreviousFrame = 0;
 
 	SDL_Window* window = nullptr;
 	SDL_Renderer* renderer = nullptr;
 	SDL_Rect camera;
 
-	sol::state lua;
+	/**
+	 * Lua state of the current level, each level runs its scripts in its own state
+	 */
+	std::unique_ptr<sol::state> lua = nullptr;
 
 	std::unique_ptr<Registry> registry = nullptr;
 	std::unique_ptr<AssetManager> assetManager = nullptr;
 	std::unique_ptr<EventBus> eventBus = nullptr;
+	std::unique_ptr<TilemapRenderer> tilemapRenderer = nullptr;
+	std::unique_ptr<TextRenderer> textRenderer = nullptr;
+	std::unique_ptr<DebugDraw> debugDraw = nullptr;
+
+	GameSettings settings;
+	int frameCount = 0;
+
+	/**
+	 * Loads the next level in the background, swapped in by SwitchLevel
+	 */
+	LevelManager levelManager;
+	int currentLevel = 0;
+	bool isLevelSwitchRequested = false;
+
+	/**
+	 * Frame the software renderer draws into in headless mode
+	 */
+	SDL_Surface* headlessTarget = nullptr;
+
+	/**
+	 * Time spent in every render system, reported on exit
+	 */
+	RenderProfiler renderProfiler;
+
+	/**
+	 * Time spent in every simulation system, shown live by the debug GUI
+	 */
+	RenderProfiler simulationProfiler;
+
+	/**
+	 * Duration of the last frame, with and without the frame cap wait, in milliseconds
+	 */
+	double lastFrameMs = 0.0;
+	double lastFrameWorkMs = 0.0;
+
+	/**
+	 * Fixed-timestep time not simulated yet, in seconds
+	 */
+	double accumulator = 0.0;
+
+	/**
+	 * Time simulated since the level was loaded, in seconds
+	 */
+	double simulationTime = 0.0;
+
+	/**
+	 * The renderer draws the front snapshot while the simulation fills the other one
+	 */
+	RenderSnapshot renderSnapshots[2];
+	int frontSnapshot = 0;
+
+	/**
+	 * Keys pressed since the last simulation, handed to it when it starts
+	 */
+	std::vector<SDL_Keycode> pendingKeyPresses;
+	std::vector<SDL_Keycode> simulationKeyPresses;
+
+	/**
+	 * Parameters of the simulation run on the worker, written while it is idle
+	 */
+	double simulationFrameTime = 0.0;
+	bool isSimulationEditMode = false;
+	bool isSimulationDebug = false;
+
+	/**
+	 * Declared last so the worker is joined before the registry it simulates is destroyed
+	 */
+	SimulationThread simulationThread;
 
 public:
-	Game();
+	Game(const GameSettings& settings = GameSettings());
 	~Game();
 
 	void LoadLevel(int level);
@@ -38,8 +131,9 @@ public:
 	void Setup();	
 	void Run();
 	void ProcessInput();
-	void Update();
-	void Render();
+	void Update(double deltaTime);
+	void Simulate(double frameTime, bool isEditModeFrame, bool isDebugFrame, RenderSnapshot& snapshot);
+	void Render(const RenderSnapshot& snapshot);
 	void Destroy();
 
 	static int MapWidth;
@@ -47,7 +141,18 @@ public:
 	static int WindowHeight;
 	static int WindowWidth;
 private:
-	void InitializeSystems();
+	void InitializeSystems(Registry& levelRegistry);
+	void SetUpLevelAssets(AssetManager& levelAssets, TilemapRenderer& levelTilemap);
+	LevelContext CreateLevelContext();
+	void UpdateLevels();
+	void SwitchLevel();
+	bool InitializeHeadless();
+	void CaptureFrame(int frame);
+	void WaitForNextFrame(Uint64 frameStart);
+	void CaptureSnapshot(RenderSnapshot& snapshot, bool isDebugFrame);
+	void UpdateGUI();
+	void UploadLoadedAssets(double budgetMs);
+	void RunLoadingScreen();
 	
 	static bool isEditMode;
 
@@ -0,0 +1,187 @@
+#include "GameSettings.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    bool ParseInt(const std::string& text, int& outValue)
+    {
+        std::istringstream stream(text);
+        int value = 0;
+        if (!(stream >> value) || !stream.eof())
+        {
+            return false;
+        }
+        outValue = value;
+        return true;
+    }
+
+    bool ParseDouble(const std::string& text, double& outValue)
+    {
+        std::istringstream stream(text);
+        double value = 0.0;
+        if (!(stream >> value) || !stream.eof())
+        {
+            return false;
+        }
+        outValue = value;
+        return true;
+    }
+}
+
+bool GameSettings::ParseCommandLine(int argc, char* argv[], GameSettings& outSettings)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--headless")
+        {
+            outSettings.isHeadless = true;
+        }
+        else if (argument == "--no-pipeline")
+        {
+            outSettings.isPipelined = false;
+        }
+        else if (argument == "--loading-screen")
+        {
+            outSettings.showLoadingScreen = true;
+        }
+        else if (argument == "--size" && hasValue)
+        {
+            const std::string size = argv[++i];
+            const size_t separator = size.find('x');
+            if (separator == std::string::npos ||
+                !ParseInt(size.substr(0, separator), outSettings.width) ||
+                !ParseInt(size.substr(separator + 1), outSettings.height) ||
+                outSettings.width <= 0 || outSettings.height <= 0)
+            {
+                Logger::Err("Invalid frame size: " + size);
+                return false;
+            }
+        }
+        else if (argument == "--frames" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.numFrames) || outSettings.numFrames < 0)
+            {
+                Logger::Err("Invalid number of frames: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--capture" && hasValue)
+        {
+            std::istringstream frames(argv[++i]);
+            std::string frame;
+            while (std::getline(frames, frame, ','))
+            {
+                int captureFrame = 0;
+                if (!ParseInt(frame, captureFrame))
+                {
+                    Logger::Err("Invalid capture frame: " + frame);
+                    return false;
+                }
+                outSettings.captureFrames.push_back(captureFrame);
+            }
+            std::sort(outSettings.captureFrames.begin(), outSettings.captureFrames.end());
+        }
+        else if (argument == "--capture-every" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.captureInterval) || outSettings.captureInterval < 0)
+            {
+                Logger::Err("Invalid capture interval: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--capture-dir" && hasValue)
+        {
+            outSettings.captureDirectory = argv[++i];
+        }
+        else if (argument == "--timings" && hasValue)
+        {
+            outSettings.timingsFile = argv[++i];
+        }
+        else if (argument == "--sim-rate" && hasValue)
+        {
+            int simulationRate = 0;
+            if (!ParseInt(argv[++i], simulationRate) || simulationRate <= 0)
+            {
+                Logger::Err("Invalid simulation rate: " + std::string(argv[i]));
+                return false;
+            }
+            outSettings.simulationRate = simulationRate;
+        }
+        else if (argument == "--archive" && hasValue)
+        {
+            outSettings.archivePath = argv[++i];
+        }
+        else if (argument == "--script-cache" && hasValue)
+        {
+            outSettings.scriptCacheDirectory = argv[++i];
+        }
+        else if (argument == "--texture-budget" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.textureBudgetMB) || outSettings.textureBudgetMB < 0)
+            {
+                Logger::Err("Invalid texture budget: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--tilemap-budget" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.tilemapBudgetMB) || outSettings.tilemapBudgetMB < 0)
+            {
+                Logger::Err("Invalid tilemap budget: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--script-budget" && hasValue)
+        {
+            if (!ParseDouble(argv[++i], outSettings.scriptBudgetMs) || outSettings.scriptBudgetMs < 0.0)
+            {
+                Logger::Err("Invalid script budget: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--level" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.startLevel) || outSettings.startLevel <= 0)
+            {
+                Logger::Err("Invalid level: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--switch-level" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.levelSwitchFrame) || outSettings.levelSwitchFrame < 0)
+            {
+                Logger::Err("Invalid level switch frame: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else if (argument == "--fps" && hasValue)
+        {
+            if (!ParseInt(argv[++i], outSettings.frameRate) || outSettings.frameRate < 0)
+            {
+                Logger::Err("Invalid frame rate: " + std::string(argv[i]));
+                return false;
+            }
+        }
+        else
+        {
+            Logger::Err("Unknown or incomplete argument: " + argument);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GameSettings::ShouldCaptureFrame(int frame) const
+{
+    if (captureInterval > 0 && frame % captureInterval == 0)
+    {
+        return true;
+    }
+    return std::binary_search(captureFrames.begin(), captureFrames.end(), frame);
+}
@@ -0,0 +1,69 @@
+#ifndef GAMESETTINGS_H
+#define GAMESETTINGS_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Start-up options of the game, read from the command line.
+ *
+ *   --headless              render offscreen with the software renderer, no display or GPU needed
+ *   --size WIDTHxHEIGHT     size of the offscreen frame (headless only, default 1280x720)
+ *   --frames N              quit after N frames, 0 runs until the window is closed
+ *   --capture F1,F2,...     frames saved as PNG
+ *   --capture-every N       save one frame every N frames
+ *   --capture-dir PATH      directory of the captured frames (default ./captures)
+ *   --timings PATH          write the render timings of every system to a CSV file on exit
+ *   --sim-rate HZ           simulation steps per second, independent of the frame rate (default 60)
+ *   --fps N                 maximum frames per second, 0 renders as fast as possible (default 60)
+ *   --no-pipeline           simulate and render on the main thread, one after the other
+ *   --loading-screen        show a progress bar until the level assets are loaded, instead of
+ *                           starting right away and showing the assets as they arrive
+ *   --archive PATH          packed asset archive read instead of the asset files, e.g. ./assets.pak written by
+ *                           make pack (default none, the asset files are read so that edits show up at once)
+ *   --texture-budget MB     texture memory above which unreferenced textures are evicted, 0 for no limit (default 0)
+ *   --tilemap-budget MB     memory of the baked tilemap chunks above which the map is streamed around the camera,
+ *                           0 for no limit (default 128)
+ *   --script-budget MS      time the entity scripts and the Lua collector may take per frame, the entities left
+ *                           over are updated the next frame (default 2)
+ *   --script-cache PATH     directory of the compiled Lua scripts (default ./assets/cache/scripts), an empty path
+ *                           compiles the scripts on every start
+ *   --level N               level played first (default 1), the next levels are loaded in the background
+ *   --switch-level FRAME    switch to the next level at this frame, waiting for it to be loaded, like pressing N
+ */
+struct GameSettings
+{
+    bool isHeadless = false;
+    int width = 1280;
+    int height = 720;
+    int numFrames = 0;
+    std::vector<int> captureFrames;
+    int captureInterval = 0;
+    std::string captureDirectory = "./captures";
+    std::string timingsFile;
+    double simulationRate = 60.0;
+    int frameRate = 60;
+    bool isPipelined = true;
+    bool showLoadingScreen = false;
+    int textureBudgetMB = 0;
+    int tilemapBudgetMB = 128;
+    double scriptBudgetMs = 2.0;
+    std::string archivePath;
+    std::string scriptCacheDirectory = "./assets/cache/scripts";
+    int startLevel = 1;
+    int levelSwitchFrame = 0;
+
+    /**
+     * Fills the settings from the command line arguments.
+     *
+     * @return false if an argument is unknown or malformed, the error is logged.
+     */
+    static bool ParseCommandLine(int argc, char* argv[], GameSettings& outSettings);
+
+    /**
+     * True if the frame has to be saved as PNG.
+     */
+    bool ShouldCaptureFrame(int frame) const;
+};
+
+#endif
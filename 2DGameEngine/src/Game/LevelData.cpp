@@ -0,0 +1,915 @@
+#include "LevelData.h"
+#include "../Logger/Logger.h"
+#include "../Renderer/TilemapRenderer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+    struct LevelHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numEntities;
+        uint32_t numStrings;
+    };
+
+    /**
+     * Visits the blocks of records in file order, Save and Read share it so they cannot disagree
+     */
+    template <typename TLevel, typename TFunc>
+    void ForEachBlock(TLevel& level, TFunc func)
+    {
+        func(level.assets);
+        func(level.animationClips);
+        func(level.animationFrames);
+        func(level.collisionLayers);
+        func(level.ignoredLayerPairs);
+        func(level.tiles);
+        func(level.decorations);
+        func(level.tags);
+        func(level.groups);
+        func(level.transforms);
+        func(level.rigidBodies);
+        func(level.sprites);
+        func(level.animations);
+        func(level.boxColliders);
+        func(level.healths);
+        func(level.projectileEmitters);
+        func(level.cameraFollows);
+        func(level.keyboardControls);
+        func(level.scriptReferences);
+    }
+
+    template <typename T>
+    void WriteValue(std::ofstream& file, const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "level records are written as they are in memory");
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void WriteBlock(std::ofstream& file, const std::vector<T>& records)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "level records are written as they are in memory");
+        WriteValue(file, static_cast<uint32_t>(records.size()));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(T)));
+    }
+
+    /**
+     * Reads values and blocks from a compiled level, any read past the end fails and marks the
+     * reader invalid
+     */
+    class LevelReader
+    {
+    public:
+        LevelReader(const uint8_t* bytes, size_t size) : cursor(bytes), end(bytes + size) {}
+
+        template <typename T>
+        bool ReadValue(T& outValue)
+        {
+            if (!isValid || static_cast<size_t>(end - cursor) < sizeof(T))
+            {
+                isValid = false;
+                return false;
+            }
+            std::memcpy(&outValue, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool ReadBlock(std::vector<T>& outRecords)
+        {
+            uint32_t count = 0;
+            if (!ReadValue(count) || static_cast<size_t>(end - cursor) / sizeof(T) < count)
+            {
+                isValid = false;
+                return false;
+            }
+            outRecords.resize(count);
+            std::memcpy(outRecords.data(), cursor, count * sizeof(T));
+            cursor += count * sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& outText)
+        {
+            uint32_t length = 0;
+            if (!ReadValue(length) || static_cast<size_t>(end - cursor) < length)
+            {
+                isValid = false;
+                return false;
+            }
+            outText.assign(reinterpret_cast<const char*>(cursor), length);
+            cursor += length;
+            return true;
+        }
+
+        bool IsValid() const { return isValid; }
+        size_t GetRemainingSize() const { return static_cast<size_t>(end - cursor); }
+
+    private:
+        const uint8_t* cursor;
+        const uint8_t* end;
+        bool isValid = true;
+    };
+
+    template <typename T>
+    bool HasValidEntities(const std::vector<T>& records, uint32_t numEntities)
+    {
+        for (const auto& record : records)
+        {
+            if (record.entity >= numEntities)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // A sprite flagged with baked = true never moves, it is drawn in the tilemap chunks
+    bool IsBakedSprite(const sol::table& entity)
+    {
+        sol::optional<sol::table> sprite = entity["components"]["sprite"];
+        sol::optional<sol::table> transform = entity["components"]["transform"];
+        if (sprite == sol::nullopt || transform == sol::nullopt)
+        {
+            return false;
+        }
+        return entity["components"]["sprite"]["baked"].get_or(false) && !entity["components"]["sprite"]["fixed"].get_or(false);
+    }
+
+    // An entity without tag, group or any component other than its transform and sprite is pure decoration
+    bool IsDecoration(const sol::table& entity)
+    {
+        if (entity["tag"].valid() || entity["group"].valid())
+        {
+            return false;
+        }
+        sol::table components = entity["components"];
+        for (const auto& component : components)
+        {
+            std::string componentName = component.first.as<std::string>();
+            if (componentName != "transform" && componentName != "sprite")
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Lowest z-index of the sprites that are not baked, the chunks are drawn under all of them
+    int GetLowestEntityZIndex(const sol::table& entities)
+    {
+        int lowestZIndex = std::numeric_limits<int>::max();
+        for (int i = 0; ; i++)
+        {
+            sol::optional<sol::table> hasEntity = entities[i];
+            if (hasEntity == sol::nullopt)
+            {
+                break;
+            }
+            sol::table entity = entities[i];
+            sol::optional<sol::table> sprite = entity["components"]["sprite"];
+            if (sprite != sol::nullopt && !IsBakedSprite(entity))
+            {
+                lowestZIndex = std::min(lowestZIndex, entity["components"]["sprite"]["z_index"].get_or(1));
+            }
+        }
+        return lowestZIndex;
+    }
+}
+
+bool LevelData::ReadTable(const sol::table& level)
+{
+    Clear();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Assets, packed in atlas pages when the level asks for it
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasTextureAtlas = level["texture_atlas"];
+    if (hasTextureAtlas != sol::nullopt)
+    {
+        sol::table atlas = level["texture_atlas"];
+        textureAtlas.isEnabled = 1;
+        textureAtlas.pageSize = atlas["page_size"].get_or(2048);
+        textureAtlas.cacheFile = AddString(atlas["cache_file"].get_or(std::string("")));
+    }
+
+    sol::optional<sol::table> hasAssets = level["assets"];
+    if (hasAssets == sol::nullopt)
+    {
+        Logger::Err("The level has no assets table");
+        return false;
+    }
+    sol::table assetTable = level["assets"];
+    for (int i = 0; ; i++)
+    {
+        sol::optional<sol::table> hasAsset = assetTable[i];
+        if (hasAsset == sol::nullopt)
+        {
+            break;
+        }
+        sol::table asset = assetTable[i];
+        std::string assetType = asset["type"];
+        if (assetType == "texture")
+        {
+            assets.push_back(LevelAsset{ LAT_Texture, AddString(asset["id"]), AddString(asset["file"]), 0 });
+        }
+        if (assetType == "font")
+        {
+            assets.push_back(LevelAsset{ LAT_Font, AddString(asset["id"]), AddString(asset["file"]), asset["font_size"] });
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Animation clips of the spritesheets, either explicit frames or a strip of frames of the same size
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasAnimations = level["animations"];
+    if (hasAnimations != sol::nullopt)
+    {
+        sol::table animationTable = level["animations"];
+        for (int i = 0; ; i++)
+        {
+            sol::optional<sol::table> hasClip = animationTable[i];
+            if (hasClip == sol::nullopt)
+            {
+                break;
+            }
+            sol::table clip = animationTable[i];
+            std::string clipId = clip["id"];
+            std::string assetId = clip["texture_asset_id"].get_or(std::string(""));
+            float frameRate = clip["fps"].get_or(1.0f);
+            EAnimationLoopMode loopMode = AnimationClipTable::ParseLoopMode(clip["loop"].get_or(std::string("loop")));
+
+            std::vector<SDL_Rect> frames;
+            sol::optional<sol::table> hasFrames = clip["frames"];
+            if (hasFrames != sol::nullopt)
+            {
+                sol::table frameTable = clip["frames"];
+                for (int frame = 0; ; frame++)
+                {
+                    sol::optional<sol::table> hasFrame = frameTable[frame];
+                    if (hasFrame == sol::nullopt)
+                    {
+                        break;
+                    }
+                    sol::table frameRect = frameTable[frame];
+                    frames.push_back(SDL_Rect{ frameRect["x"].get_or(0), frameRect["y"].get_or(0), frameRect["w"], frameRect["h"] });
+                }
+            }
+            else
+            {
+                int startX = clip["start_x"].get_or(0);
+                int startY = clip["start_y"].get_or(0);
+                int frameWidth = clip["frame_width"];
+                int frameHeight = clip["frame_height"];
+                int numFrames = clip["num_frames"].get_or(1);
+                for (int frame = 0; frame < numFrames; frame++)
+                {
+                    frames.push_back(SDL_Rect{ startX + frame * frameWidth, startY, frameWidth, frameHeight });
+                }
+            }
+            AddAnimationClip(clipId, assetId, frames, frameRate, loopMode);
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Tilemap, the tiles themselves are read from the map file by ReadTiles
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasTilemap = level["tilemap"];
+    if (hasTilemap == sol::nullopt)
+    {
+        Logger::Err("The level has no tilemap table");
+        return false;
+    }
+    sol::table map = level["tilemap"];
+    mapFile = map["map_file"];
+    tilemap.mapFile = AddString(mapFile);
+    tilemap.textureAssetID = AddString(map["texture_asset_id"]);
+    tilemap.numRows = map["num_rows"];
+    tilemap.numCols = map["num_cols"];
+    tilemap.tileSize = map["tile_size"];
+    tilemap.scale = map["scale"];
+    tilemap.chunkTiles = map["chunk_tiles"].get_or(TilemapRenderer::DEFAULT_CHUNK_TILES);
+
+    // A tile index of the map file is row * tileset_cols + column in the tileset, with the default
+    // 10 columns "21" is row 2 column 1
+    tilemap.tilesetCols = map["tileset_cols"].get_or(10);
+
+    // Tiles listed as solid are baked into the tile collision grid instead of collider entities
+    sol::optional<sol::table> hasSolidTiles = map["solid_tiles"];
+    if (hasSolidTiles != sol::nullopt)
+    {
+        sol::table solidTiles = map["solid_tiles"];
+        for (int i = 0; ; i++)
+        {
+            sol::optional<int> solidTile = solidTiles[i];
+            if (solidTile == sol::nullopt)
+            {
+                break;
+            }
+            if (solidTile.value() >= 0)
+            {
+                if (solidTile.value() >= static_cast<int>(isSolidTile.size()))
+                {
+                    isSolidTile.resize(solidTile.value() + 1, false);
+                }
+                isSolidTile[solidTile.value()] = true;
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Collision layers and the layer pairs that never collide
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasCollisionLayers = level["collision_layers"];
+    if (hasCollisionLayers != sol::nullopt)
+    {
+        sol::table collisionLayerTable = level["collision_layers"];
+
+        sol::table layers = collisionLayerTable["layers"];
+        for (int i = 0; ; i++)
+        {
+            sol::optional<std::string> layerName = layers[i];
+            if (layerName == sol::nullopt)
+            {
+                break;
+            }
+            layerMatrix.AddLayer(layerName.value());
+            collisionLayers.push_back(AddString(layerName.value()));
+        }
+
+        sol::optional<sol::table> hasIgnoredPairs = collisionLayerTable["ignore"];
+        if (hasIgnoredPairs != sol::nullopt)
+        {
+            sol::table ignoredPairs = collisionLayerTable["ignore"];
+            for (int i = 0; ; i++)
+            {
+                sol::optional<sol::table> hasPair = ignoredPairs[i];
+                if (hasPair == sol::nullopt)
+                {
+                    break;
+                }
+                sol::table pair = ignoredPairs[i];
+                std::string layerA = pair[1];
+                std::string layerB = pair[2];
+                if (!layerMatrix.HasLayer(layerA) || !layerMatrix.HasLayer(layerB))
+                {
+                    Logger::Err("Unknown collision layer in ignore pair: " + layerA + ", " + layerB);
+                }
+                else
+                {
+                    ignoredLayerPairs.push_back(LevelLayerPair{ layerMatrix.GetLayer(layerA), layerMatrix.GetLayer(layerB) });
+                }
+            }
+        }
+    }
+
+    // The tile grid collides like a collider placed on the tilemap collision layer
+    tilemap.collisionLayer = layerMatrix.GetLayer(map["collision_layer"].get_or(std::string("obstacles")));
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Entities and their components
+    ////////////////////////////////////////////////////////////////////////////
+    sol::optional<sol::table> hasEntities = level["entities"];
+    if (hasEntities == sol::nullopt)
+    {
+        Logger::Err("The level has no entities table");
+        return false;
+    }
+    sol::table entities = level["entities"];
+    const int maxBakedZIndex = GetLowestEntityZIndex(entities);
+    for (int i = 0; ; i++)
+    {
+        sol::optional<sol::table> hasEntity = entities[i];
+        if (hasEntity == sol::nullopt)
+        {
+            break;
+        }
+        ReadEntity(entities[i], static_cast<uint32_t>(i), maxBakedZIndex);
+    }
+    return true;
+}
+
+void LevelData::ReadEntity(const sol::table& entity, uint32_t tableIndex, int maxBakedZIndex)
+{
+    // The chunks are drawn under every entity, a baked sprite above the lowest entity layer would end up below it
+    bool isBaked = IsBakedSprite(entity);
+    if (isBaked && entity["components"]["sprite"]["z_index"].get_or(1) > maxBakedZIndex)
+    {
+        const std::string textureId = entity["components"]["sprite"]["texture_asset_id"].get_or(std::string());
+        Logger::Warn("Sprite " + textureId + " is above the lowest entity z-index " + std::to_string(maxBakedZIndex) + ", it is not baked");
+        isBaked = false;
+    }
+
+    // Static decorations (only a transform and a baked sprite) are drawn in the tilemap chunks, without an entity
+    if (isBaked && IsDecoration(entity))
+    {
+        AddDecoration(entity);
+        return;
+    }
+
+    const uint32_t entityIndex = numEntities++;
+
+    sol::optional<std::string> tag = entity["tag"];
+    if (tag != sol::nullopt)
+    {
+        tags.push_back(LevelName{ entityIndex, AddString(tag.value()) });
+    }
+
+    sol::optional<std::string> group = entity["group"];
+    if (group != sol::nullopt)
+    {
+        groups.push_back(LevelName{ entityIndex, AddString(group.value()) });
+    }
+
+    sol::optional<sol::table> hasComponents = entity["components"];
+    if (hasComponents == sol::nullopt)
+    {
+        return;
+    }
+    sol::table components = entity["components"];
+
+    // Transform
+    sol::optional<sol::table> transform = components["transform"];
+    if (transform != sol::nullopt)
+    {
+        transforms.push_back(LevelTransform{
+            entityIndex,
+            components["transform"]["position"]["x"],
+            components["transform"]["position"]["y"],
+            components["transform"]["scale"]["x"].get_or(1.0f),
+            components["transform"]["scale"]["y"].get_or(1.0f),
+            components["transform"]["rotation"].get_or(0.0)
+        });
+    }
+
+    // RigidBody
+    sol::optional<sol::table> rigidbody = components["rigidbody"];
+    if (rigidbody != sol::nullopt)
+    {
+        rigidBodies.push_back(LevelRigidBody{
+            entityIndex,
+            components["rigidbody"]["velocity"]["x"].get_or(0.0f),
+            components["rigidbody"]["velocity"]["y"].get_or(0.0f)
+        });
+    }
+
+    // Sprite
+    sol::optional<sol::table> sprite = components["sprite"];
+    if (sprite != sol::nullopt && isBaked)
+    {
+        AddDecoration(entity);
+    }
+    else if (sprite != sol::nullopt)
+    {
+        sprites.push_back(LevelSprite{
+            entityIndex,
+            AddString(components["sprite"]["texture_asset_id"]),
+            components["sprite"]["width"],
+            components["sprite"]["height"],
+            components["sprite"]["z_index"].get_or(1),
+            components["sprite"]["fixed"].get_or(false) ? 1u : 0u,
+            components["sprite"]["src_rect_x"].get_or(0),
+            components["sprite"]["src_rect_y"].get_or(0)
+        });
+    }
+
+    // Animation
+    sol::optional<sol::table> animation = components["animation"];
+    if (animation != sol::nullopt)
+    {
+        animations.push_back(LevelAnimation{ entityIndex, GetAnimationClip(entity) });
+    }
+
+    // BoxCollider
+    sol::optional<sol::table> collider = components["boxcollider"];
+    if (collider != sol::nullopt)
+    {
+        // Without an explicit layer the collider goes on the layer named after the entity group
+        std::string layerName = components["boxcollider"]["layer"].get_or(group.value_or(std::string("default")));
+        boxColliders.push_back(LevelBoxCollider{
+            entityIndex,
+            components["boxcollider"]["width"],
+            components["boxcollider"]["height"],
+            components["boxcollider"]["offset"]["x"].get_or(0.0f),
+            components["boxcollider"]["offset"]["y"].get_or(0.0f),
+            layerMatrix.GetLayer(layerName)
+        });
+    }
+
+    // Health
+    sol::optional<sol::table> health = components["health"];
+    if (health != sol::nullopt)
+    {
+        healths.push_back(LevelHealth{ entityIndex, static_cast<int32_t>(components["health"]["health_percentage"].get_or(100)) });
+    }
+
+    // ProjectileEmitter
+    sol::optional<sol::table> projectileEmitter = components["projectile_emitter"];
+    if (projectileEmitter != sol::nullopt)
+    {
+        projectileEmitters.push_back(LevelProjectileEmitter{
+            entityIndex,
+            components["projectile_emitter"]["projectile_velocity"]["x"],
+            components["projectile_emitter"]["projectile_velocity"]["y"],
+            static_cast<int32_t>(components["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
+            static_cast<int32_t>(components["projectile_emitter"]["projectile_duration"].get_or(10)) * 1000,
+            static_cast<int32_t>(components["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
+            components["projectile_emitter"]["friendly"].get_or(false) ? 1u : 0u
+        });
+    }
+
+    // CameraFollow
+    sol::optional<sol::table> cameraFollow = components["camera_follow"];
+    if (cameraFollow != sol::nullopt)
+    {
+        cameraFollows.push_back(LevelCameraFollow{ entityIndex });
+    }
+
+    // KeyboardControlled
+    sol::optional<sol::table> keyboardControlled = components["keyboard_controller"];
+    if (keyboardControlled != sol::nullopt)
+    {
+        sol::table controller = components["keyboard_controller"];
+        LevelKeyboardControl control = { entityIndex, {}, {} };
+        const char* directions[4] = { "up", "right", "down", "left" };
+        for (int direction = 0; direction < 4; direction++)
+        {
+            const std::string name = directions[direction];
+            control.velocities[direction * 2] = controller[name + "_velocity"]["x"];
+            control.velocities[direction * 2 + 1] = controller[name + "_velocity"]["y"];
+            control.clips[direction] = clipTable.GetClipIndex(controller[name + "_clip"].get_or(std::string("")));
+        }
+        keyboardControls.push_back(control);
+    }
+
+    // Script, the first update function of on_update_script
+    sol::optional<sol::protected_function> script = components["on_update_script"][0];
+    if (script != sol::nullopt)
+    {
+        scripts.push_back(LevelScript{ entityIndex, script.value() });
+        scriptReferences.push_back(LevelScriptReference{ entityIndex, tableIndex });
+    }
+}
+
+// Clip index of an entity animation, older scripts give num_frames and speed_rate instead of a clip
+int LevelData::GetAnimationClip(const sol::table& entity)
+{
+    sol::table animation = entity["components"]["animation"];
+    sol::optional<std::string> clipId = animation["clip"];
+    if (clipId != sol::nullopt)
+    {
+        int clipIndex = clipTable.GetClipIndex(clipId.value());
+        if (clipIndex == AnimationClipTable::INVALID_CLIP)
+        {
+            Logger::Err("Unknown animation clip: " + clipId.value());
+        }
+        return clipIndex;
+    }
+
+    sol::optional<sol::table> sprite = entity["components"]["sprite"];
+    if (sprite == sol::nullopt)
+    {
+        return AnimationClipTable::INVALID_CLIP;
+    }
+
+    std::string assetId = entity["components"]["sprite"]["texture_asset_id"];
+    int width = entity["components"]["sprite"]["width"];
+    int height = entity["components"]["sprite"]["height"];
+    int srcRectX = entity["components"]["sprite"]["src_rect_x"].get_or(0);
+    int srcRectY = entity["components"]["sprite"]["src_rect_y"].get_or(0);
+    int numFrames = animation["num_frames"].get_or(1);
+    int speedRate = animation["speed_rate"].get_or(1);
+
+    // entities animated the same way share an unnamed clip
+    std::string generatedId = assetId + ":" + std::to_string(srcRectX) + ":" + std::to_string(srcRectY) + ":" +
+        std::to_string(width) + "x" + std::to_string(height) + ":" + std::to_string(numFrames) + ":" + std::to_string(speedRate);
+    int clipIndex = clipTable.GetClipIndex(generatedId);
+    if (clipIndex == AnimationClipTable::INVALID_CLIP)
+    {
+        std::vector<SDL_Rect> frames;
+        for (int frame = 0; frame < numFrames; frame++)
+        {
+            frames.push_back(SDL_Rect{ srcRectX + frame * width, srcRectY, width, height });
+        }
+        clipIndex = AddAnimationClip(generatedId, assetId, frames, static_cast<float>(speedRate), ALM_Loop);
+    }
+    return clipIndex;
+}
+
+/**
+ * Adds the clip to the clip table resolving the names, and records it at the index it got there,
+ * a redefined clip replaces its record
+ */
+int LevelData::AddAnimationClip(const std::string& clipID, const std::string& assetID, const std::vector<SDL_Rect>& frames, float frameRate, EAnimationLoopMode loopMode)
+{
+    const int clipIndex = clipTable.AddClip(clipID, assetID, frames, frameRate, loopMode);
+    if (clipIndex == AnimationClipTable::INVALID_CLIP)
+    {
+        return clipIndex;
+    }
+
+    LevelAnimationClip clip = {
+        AddString(clipID),
+        AddString(assetID),
+        static_cast<uint32_t>(animationFrames.size()),
+        static_cast<uint32_t>(frames.size()),
+        frameRate,
+        loopMode
+    };
+    animationFrames.insert(animationFrames.end(), frames.begin(), frames.end());
+
+    if (clipIndex < static_cast<int>(animationClips.size()))
+    {
+        animationClips[clipIndex] = clip;
+    }
+    else
+    {
+        animationClips.push_back(clip);
+    }
+    return clipIndex;
+}
+
+void LevelData::AddDecoration(const sol::table& entity)
+{
+    sol::table transform = entity["components"]["transform"];
+    sol::table sprite = entity["components"]["sprite"];
+    int width = sprite["width"];
+    int height = sprite["height"];
+    float scaleX = transform["scale"]["x"].get_or(1.0f);
+    float scaleY = transform["scale"]["y"].get_or(1.0f);
+
+    decorations.push_back(LevelDecoration{
+        AddString(sprite["texture_asset_id"]),
+        sprite["z_index"].get_or(1),
+        SDL_Rect{ sprite["src_rect_x"].get_or(0), sprite["src_rect_y"].get_or(0), width, height },
+        SDL_FRect{ transform["position"]["x"], transform["position"]["y"], width * scaleX, height * scaleY },
+        transform["rotation"].get_or(0.0)
+    });
+}
+
+/**
+ * Parses the map file in place: one line per tile row, tile indices separated by commas. Rows
+ * and fields out of the map are ignored, missing ones stay empty, the first of them is reported.
+ */
+bool LevelData::ReadTiles(const char* text, size_t size)
+{
+    tiles.assign(static_cast<size_t>(tilemap.numCols) * tilemap.numRows, LevelTile{ TilemapRenderer::EMPTY_TILE, 0 });
+
+    int row = 0;
+    int col = 0;
+    int line = 1;
+    int value = 0;
+    bool hasDigits = false;         // digits read in the current field
+    bool isNegative = false;
+    bool isFieldDone = false;       // blank after the digits, only a separator may follow
+    bool isRowEmpty = true;
+    bool hasReportedSize = false;
+
+    // the end of the text ends the last line
+    for (size_t i = 0; i <= size; i++)
+    {
+        const char ch = i < size ? text[i] : '\n';
+
+        if (ch >= '0' && ch <= '9')
+        {
+            if (isFieldDone)
+            {
+                Logger::Err("Missing separator in the map file " + mapFile + " at line " + std::to_string(line));
+                return false;
+            }
+            value = value * 10 + (ch - '0');
+            if (value >= TilemapRenderer::EMPTY_TILE)
+            {
+                Logger::Err("Tile index out of range in the map file " + mapFile + " at line " + std::to_string(line));
+                return false;
+            }
+            hasDigits = true;
+            isRowEmpty = false;
+        }
+        else if (ch == '-' && !hasDigits && !isNegative)
+        {
+            isNegative = true;
+            isRowEmpty = false;
+        }
+        else if (ch == ' ' || ch == '\t' || ch == '\r')
+        {
+            isFieldDone = hasDigits;
+        }
+        else if (ch == ',' || ch == '\n')
+        {
+            // a field ends, a line without any field is skipped
+            if (ch == ',' || !isRowEmpty)
+            {
+                if (row < tilemap.numRows && col < tilemap.numCols)
+                {
+                    // an empty field or a negative index leaves the tile empty
+                    LevelTile& tile = tiles[static_cast<size_t>(row) * tilemap.numCols + col];
+                    if (hasDigits && !isNegative)
+                    {
+                        tile.index = static_cast<uint16_t>(value);
+                        if (value < static_cast<int>(isSolidTile.size()) && isSolidTile[value])
+                        {
+                            tile.flags |= LTF_Solid;
+                        }
+                    }
+                }
+                col++;
+                isRowEmpty = false;
+            }
+            value = 0;
+            hasDigits = isNegative = isFieldDone = false;
+
+            if (ch == '\n')
+            {
+                if (!isRowEmpty)
+                {
+                    if (col != tilemap.numCols && !hasReportedSize)
+                    {
+                        Logger::Warn("The map file " + mapFile + " has " + std::to_string(col) + " tiles at line " + std::to_string(line) +
+                            ", " + std::to_string(tilemap.numCols) + " expected");
+                        hasReportedSize = true;
+                    }
+                    row++;
+                }
+                col = 0;
+                isRowEmpty = true;
+                line++;
+            }
+        }
+        else
+        {
+            Logger::Err("Unexpected character in the map file " + mapFile + " at line " + std::to_string(line));
+            return false;
+        }
+    }
+
+    if (row != tilemap.numRows)
+    {
+        Logger::Warn("The map file " + mapFile + " has " + std::to_string(row) + " rows, " + std::to_string(tilemap.numRows) + " expected");
+    }
+    return true;
+}
+
+bool LevelData::Save(const std::string& path) const
+{
+    if (numEntities > MAX_ENTITIES)
+    {
+        Logger::Err("The level has " + std::to_string(numEntities) + " entities, more than a compiled level can hold");
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        Logger::Err("Error creating the compiled level " + path);
+        return false;
+    }
+
+    WriteValue(file, LevelHeader{ MAGIC, VERSION, numEntities, static_cast<uint32_t>(strings.size()) });
+    WriteValue(file, textureAtlas);
+    WriteValue(file, tilemap);
+    for (const auto& text : strings)
+    {
+        WriteValue(file, static_cast<uint32_t>(text.size()));
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    ForEachBlock(*this, [&file](const auto& records) { WriteBlock(file, records); });
+
+    if (!file)
+    {
+        Logger::Err("Error writing the compiled level " + path);
+        return false;
+    }
+    return true;
+}
+
+bool LevelData::Read(const uint8_t* bytes, size_t size)
+{
+    Clear();
+
+    LevelReader reader(bytes, size);
+    LevelHeader header = {};
+    if (!reader.ReadValue(header) || header.magic != MAGIC || header.version != VERSION)
+    {
+        Logger::Err("Not a compiled level of version " + std::to_string(VERSION));
+        return false;
+    }
+
+    // an entity may have no record at all, so its count is checked against a limit rather than the bytes left
+    if (header.numEntities > MAX_ENTITIES)
+    {
+        Logger::Err("Corrupted compiled level: " + std::to_string(header.numEntities) + " entities");
+        return false;
+    }
+    numEntities = header.numEntities;
+    reader.ReadValue(textureAtlas);
+    reader.ReadValue(tilemap);
+
+    // every string starts with its length, a count the remaining bytes cannot hold is not allocated
+    if (!reader.IsValid() || header.numStrings > reader.GetRemainingSize() / sizeof(uint32_t))
+    {
+        Logger::Err("Truncated compiled level");
+        Clear();
+        return false;
+    }
+    strings.resize(header.numStrings);
+    for (auto& text : strings)
+    {
+        reader.ReadString(text);
+    }
+    ForEachBlock(*this, [&reader](auto& records) { reader.ReadBlock(records); });
+
+    if (!reader.IsValid())
+    {
+        Logger::Err("Truncated compiled level");
+        Clear();
+        return false;
+    }
+    mapFile = GetString(tilemap.mapFile);
+
+    bool isValid = tilemap.numCols >= 0 && tilemap.numRows >= 0 && tilemap.tilesetCols > 0 &&
+        tiles.size() == static_cast<size_t>(tilemap.numCols) * tilemap.numRows;
+    for (const auto& clip : animationClips)
+    {
+        isValid = isValid && clip.firstFrame + static_cast<uint64_t>(clip.numFrames) <= animationFrames.size();
+    }
+    isValid = isValid &&
+        HasValidEntities(tags, numEntities) && HasValidEntities(groups, numEntities) &&
+        HasValidEntities(transforms, numEntities) && HasValidEntities(rigidBodies, numEntities) &&
+        HasValidEntities(sprites, numEntities) && HasValidEntities(animations, numEntities) &&
+        HasValidEntities(boxColliders, numEntities) && HasValidEntities(healths, numEntities) &&
+        HasValidEntities(projectileEmitters, numEntities) && HasValidEntities(cameraFollows, numEntities) &&
+        HasValidEntities(keyboardControls, numEntities) && HasValidEntities(scriptReferences, numEntities);
+    if (!isValid)
+    {
+        Logger::Err("Corrupted compiled level");
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * The functions are looked up by the position of their entity in the table, the level script has to
+ * be the one the level was compiled from, which the staleness check of the loader makes sure of.
+ */
+bool LevelData::ResolveScripts(const sol::table& level)
+{
+    scripts.clear();
+    for (const auto& reference : scriptReferences)
+    {
+        sol::optional<sol::protected_function> function = level["entities"][reference.tableIndex]["components"]["on_update_script"][0];
+        if (function == sol::nullopt)
+        {
+            Logger::Err("No update function for the entity " + std::to_string(reference.tableIndex) + " of the Level table");
+            scripts.clear();
+            return false;
+        }
+        scripts.push_back(LevelScript{ reference.entity, function.value() });
+    }
+    return true;
+}
+
+const std::string& LevelData::GetString(uint32_t index) const
+{
+    static const std::string empty;
+    return index < strings.size() ? strings[index] : empty;
+}
+
+void LevelData::Clear()
+{
+    strings.clear();
+    textureAtlas = {};
+    tilemap = {};
+    numEntities = 0;
+    ForEachBlock(*this, [](auto& records) { records.clear(); });
+    scripts.clear();
+
+    clipTable.Clear();
+    layerMatrix.Reset();
+    isSolidTile.clear();
+    stringIndices.clear();
+    mapFile.clear();
+}
+
+uint32_t LevelData::AddString(const std::string& text)
+{
+    const auto it = stringIndices.find(text);
+    if (it != stringIndices.end())
+    {
+        return it->second;
+    }
+
+    const uint32_t index = static_cast<uint32_t>(strings.size());
+    strings.push_back(text);
+    stringIndices.emplace(text, index);
+    return index;
+}
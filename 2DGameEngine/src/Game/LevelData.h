@@ -0,0 +1,319 @@
+#ifndef LEVELDATA_H
+#define LEVELDATA_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <sol/sol.hpp>
+#include "../AssetManager/AnimationClipTable.h"
+#include "../Collision/CollisionLayerMatrix.h"
+
+/**
+ * Records of a level description. They only hold plain values, strings are indices in the
+ * string table of the level and entities are indices in the entities of the level, so every
+ * block of records is written and read as it is in memory.
+ */
+enum ELevelAssetType : uint32_t
+{
+    LAT_Texture = 1,
+    LAT_Font = 2
+};
+
+struct LevelAsset
+{
+    uint32_t type;
+    uint32_t id;
+    uint32_t file;
+    int32_t fontSize;
+};
+
+struct LevelTextureAtlas
+{
+    uint32_t isEnabled;
+    int32_t pageSize;
+    uint32_t cacheFile;
+};
+
+struct LevelAnimationClip
+{
+    uint32_t id;
+    uint32_t assetID;
+    uint32_t firstFrame;        /**< Index of the first frame in the frames of the level */
+    uint32_t numFrames;
+    float frameRate;
+    int32_t loopMode;
+};
+
+struct LevelTilemap
+{
+    int32_t numCols;
+    int32_t numRows;
+    int32_t tileSize;
+    int32_t chunkTiles;
+    double scale;
+    uint32_t textureAssetID;
+    int32_t tilesetCols;        /**< Tile columns of the tileset texture */
+    int32_t collisionLayer;     /**< Layer the tile collision grid collides as */
+    uint32_t mapFile;           /**< Path of the map file the tiles were read from */
+};
+
+enum ELevelTileFlags : uint16_t
+{
+    LTF_Solid = 1 << 0
+};
+
+struct LevelTile
+{
+    uint16_t index;             /**< row * tilesetCols + column in the tileset, TilemapRenderer::EMPTY_TILE for none */
+    uint16_t flags;
+};
+
+struct LevelLayerPair
+{
+    int32_t layerA;
+    int32_t layerB;
+};
+
+struct LevelDecoration
+{
+    uint32_t assetID;
+    int32_t zIndex;
+    SDL_Rect srcRect;
+    SDL_FRect dstRect;
+    double angle;
+};
+
+struct LevelName
+{
+    uint32_t entity;
+    uint32_t name;
+};
+
+struct LevelTransform
+{
+    uint32_t entity;
+    float positionX;
+    float positionY;
+    float scaleX;
+    float scaleY;
+    double rotation;
+};
+
+struct LevelRigidBody
+{
+    uint32_t entity;
+    float velocityX;
+    float velocityY;
+};
+
+struct LevelSprite
+{
+    uint32_t entity;
+    uint32_t assetID;
+    int32_t width;
+    int32_t height;
+    int32_t zIndex;
+    uint32_t isFixed;
+    int32_t srcRectX;
+    int32_t srcRectY;
+};
+
+struct LevelAnimation
+{
+    uint32_t entity;
+    int32_t clip;
+};
+
+struct LevelBoxCollider
+{
+    uint32_t entity;
+    int32_t width;
+    int32_t height;
+    float offsetX;
+    float offsetY;
+    int32_t layer;
+};
+
+struct LevelHealth
+{
+    uint32_t entity;
+    int32_t healthPercentage;
+};
+
+struct LevelProjectileEmitter
+{
+    uint32_t entity;
+    float velocityX;
+    float velocityY;
+    int32_t repeatFrequency;    /**< Milliseconds */
+    int32_t projectileDuration; /**< Milliseconds */
+    int32_t hitPercentDamage;
+    uint32_t isFriendly;
+};
+
+struct LevelCameraFollow
+{
+    uint32_t entity;
+};
+
+struct LevelKeyboardControl
+{
+    uint32_t entity;
+    float velocities[8];        /**< Up, right, down and left velocities, x then y */
+    int32_t clips[4];           /**< Up, right, down and left clips */
+};
+
+/**
+ * Where the update function of a scripted entity is in the Level table: a compiled level cannot hold
+ * Lua functions, they are looked up again once the level script has run (see ResolveScripts).
+ */
+struct LevelScriptReference
+{
+    uint32_t entity;
+    uint32_t tableIndex;        /**< Index of the entity in Level.entities, its function is components.on_update_script[0] */
+};
+
+/**
+ * Update function of a scripted entity. Not a record, it is read from the Level table of the script
+ * or resolved from a LevelScriptReference.
+ */
+struct LevelScript
+{
+    uint32_t entity;
+    sol::protected_function function;
+};
+
+/**
+ * Everything a level creates, read once from the level Lua script or from a compiled level.
+ *
+ * Running the script of a big level and walking its tables through sol is most of the loading
+ * time. The level compiler (tools/LevelCompiler.cpp) runs the script offline and saves the
+ * resulting LevelData as a compiled level: a header followed by the blocks of records, each
+ * block being a count and the records as they are in memory. Loading a compiled level reads
+ * the blocks in place, without walking the tables. A level with entity scripts still runs its
+ * script, from its cached bytecode, for the update functions and the globals they use.
+ *
+ * Animation clips and collision layers are already resolved to the indices they get when the
+ * level replays them, in order, into the empty clip table and layer matrix.
+ */
+struct LevelData
+{
+    static constexpr uint32_t MAGIC = 0x564C4547;   // "GELV"
+    static constexpr uint32_t VERSION = 4;
+
+    /**
+     * Entities a compiled level can have, a larger count in the header is taken as corrupted
+     */
+    static constexpr uint32_t MAX_ENTITIES = 1u << 20;
+
+    std::vector<std::string> strings;
+
+    LevelTextureAtlas textureAtlas = {};
+    std::vector<LevelAsset> assets;
+
+    std::vector<LevelAnimationClip> animationClips;
+    std::vector<SDL_Rect> animationFrames;
+
+    /**
+     * Collision layers after the default one, in the order they are added
+     */
+    std::vector<uint32_t> collisionLayers;
+    std::vector<LevelLayerPair> ignoredLayerPairs;
+
+    LevelTilemap tilemap = {};
+    std::vector<LevelTile> tiles;
+    std::vector<LevelDecoration> decorations;
+
+    uint32_t numEntities = 0;
+    std::vector<LevelName> tags;
+    std::vector<LevelName> groups;
+    std::vector<LevelTransform> transforms;
+    std::vector<LevelRigidBody> rigidBodies;
+    std::vector<LevelSprite> sprites;
+    std::vector<LevelAnimation> animations;
+    std::vector<LevelBoxCollider> boxColliders;
+    std::vector<LevelHealth> healths;
+    std::vector<LevelProjectileEmitter> projectileEmitters;
+    std::vector<LevelCameraFollow> cameraFollows;
+    std::vector<LevelKeyboardControl> keyboardControls;
+
+    std::vector<LevelScriptReference> scriptReferences;
+
+    /**
+     * Filled by ReadTable, or by ResolveScripts for a compiled level
+     */
+    std::vector<LevelScript> scripts;
+
+    /**
+     * Reads the Level table of an executed level script, except the tiles.
+     *
+     * @return false if the table misses a mandatory field, the error is logged.
+     */
+    bool ReadTable(const sol::table& level);
+
+    /**
+     * Reads the tiles of the map file named by the script, once ReadTable is done, from the whole
+     * file in memory.
+     *
+     * @return false if the file is malformed, the error is logged.
+     */
+    bool ReadTiles(const char* text, size_t size);
+
+    /**
+     * Path of the map file read by ReadTable, or of the map file a compiled level was made from.
+     */
+    const std::string& GetMapFile() const { return mapFile; }
+
+    /**
+     * Saves the level as a compiled level.
+     *
+     * @return false if the file cannot be written, the error is logged.
+     */
+    bool Save(const std::string& path) const;
+
+    /**
+     * Reads a compiled level from memory, the mapped archive or a file read at once.
+     *
+     * @return false if the bytes are not a compiled level of this version or are truncated.
+     */
+    bool Read(const uint8_t* bytes, size_t size);
+
+    /**
+     * Finds the update functions of the scripted entities of a compiled level in the Level table,
+     * once the level script has run in the Lua state of the level.
+     *
+     * @return false if an entity of the table has no update function any more, the error is logged.
+     */
+    bool ResolveScripts(const sol::table& level);
+
+    const std::string& GetString(uint32_t index) const;
+
+    void Clear();
+
+private:
+    uint32_t AddString(const std::string& text);
+
+    /**
+     * @param tableIndex Index of the entity in Level.entities, kept by the references to its script.
+     * @param maxBakedZIndex Highest z-index of a sprite that can be baked, the lowest of the entity sprites.
+     */
+    void ReadEntity(const sol::table& entity, uint32_t tableIndex, int maxBakedZIndex);
+
+    int GetAnimationClip(const sol::table& entity);
+    int AddAnimationClip(const std::string& clipID, const std::string& assetID, const std::vector<SDL_Rect>& frames, float frameRate, EAnimationLoopMode loopMode);
+    void AddDecoration(const sol::table& entity);
+
+    /**
+     * Only used while reading the script: the clips and layers defined so far, to resolve names
+     * to indices, the tile indices flagged solid and the interned strings
+     */
+    AnimationClipTable clipTable;
+    CollisionLayerMatrix layerMatrix;
+    std::vector<bool> isSolidTile;
+    std::unordered_map<std::string, uint32_t> stringIndices;
+    std::string mapFile;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "LevelLoader.h"
 #include <glm/glm.hpp>
+#include <filesystem>
 #include <fstream>
+#include <iterator>
 #include "../Components/TransformComponent.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/BoxColliderComponent.h"
@@ -11,8 +13,13 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
 #include "../Components/TextRenderComponent.h"
+#include "../Components/ScriptComponent.h"
 #include "../Logger/Logger.h"
+#include "../Systems/CollisionSystem.h"
+#include "../Systems/TileCollisionSystem.h"
+#include "../Systems/ScriptSystem.h"
 #include "./Game.h"
+#include "./LevelData.h"
 
 
 LevelLoader::LevelLoader()
@@ -25,226 +32,340 @@ LevelLoader::~LevelLoader()
     Logger::Log("Level Loader destructor");
 }
 
-void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, SDL_Renderer* renderer, int levelNumber) {
-    // This checks the syntax of our script, but it does not execute the script
-    sol::load_result script = lua.load_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
+// A compiled level older than its script or its map file is out of date, only known when both are loose files
+static bool IsCompiledLevelStale(const std::string& compiledPath, const std::string& sourcePath) {
+    std::error_code error;
+    std::filesystem::file_time_type sourceTime = std::filesystem::last_write_time(sourcePath, error);
+    if (error) {
+        return false;
+    }
+    std::filesystem::file_time_type compiledTime = std::filesystem::last_write_time(compiledPath, error);
+    return !error && compiledTime < sourceTime;
+}
+
+bool LevelLoader::ReadCompiledLevel(const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel) {
+    const std::string compiledPath = GetCompiledLevelPath(levelNumber);
+
+    // an archived level is read from the mapped archive, in place
+    if (const ArchiveEntry* archivedLevel = assetStore->FindArchivedFile(compiledPath)) {
+        return outLevel.Read(assetStore->GetArchivedData(*archivedLevel), archivedLevel->size);
+    }
+
+    std::ifstream levelFile(compiledPath, std::ios::binary);
+    if (!levelFile) {
+        return false;
+    }
+    if (IsCompiledLevelStale(compiledPath, GetScriptPath(levelNumber))) {
+        Logger::Warn("The compiled level " + compiledPath + " is older than its script, the script is loaded instead");
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(levelFile)), std::istreambuf_iterator<char>());
+    if (!outLevel.Read(bytes.data(), bytes.size())) {
+        return false;
+    }
+
+    // the tiles are compiled in too, the map file is only known once the level is read
+    if (IsCompiledLevelStale(compiledPath, outLevel.GetMapFile())) {
+        Logger::Warn("The compiled level " + compiledPath + " is older than its map file " + outLevel.GetMapFile() + ", the script is loaded instead");
+        outLevel.Clear();
+        return false;
+    }
+    return true;
+}
+
+bool LevelLoader::ResolveCompiledScripts(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& level) {
+    // the update functions and the globals they use only exist once the level script has run
+    if (level.scriptReferences.empty()) {
+        return true;
+    }
+    if (!RunLevelScript(lua, assetStore, levelNumber) || !level.ResolveScripts(lua["Level"])) {
+        Logger::Warn("The entity scripts of the compiled level " + GetCompiledLevelPath(levelNumber) + " are not in its script, the script is loaded instead");
+        level.Clear();
+        return false;
+    }
+    return true;
+}
+
+bool LevelLoader::RunLevelScript(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber) {
+    // This checks the syntax of our script, but it does not execute the script. The archived
+    // script is already compiled, its chunk is loaded from the mapped archive, a script file is
+    // loaded from its cached bytecode unless it changed since it was cached.
+    const std::string scriptPath = GetScriptPath(levelNumber);
+    const ArchiveEntry* archivedScript = assetStore->FindArchivedFile(scriptPath);
+    sol::load_result script = archivedScript ?
+        lua.load_buffer(reinterpret_cast<const char*>(assetStore->GetArchivedData(*archivedScript)), archivedScript->size, "@" + scriptPath) :
+        scriptCache.Load(lua, scriptPath);
     if (!script.valid()) {
         sol::error err = script;
         std::string errorMessage = err.what();
         Logger::Err("Error loading the lua script: " + errorMessage);
-        return;
+        return false;
     }
 
     // Executes the script using the Sol state
-    lua.script_file("./assets/scripts/Level" + std::to_string(levelNumber) + ".lua");
+    sol::protected_function_result scriptResult = script();
+    if (!scriptResult.valid()) {
+        sol::error err = scriptResult;
+        std::string errorMessage = err.what();
+        Logger::Err("Error running the lua script: " + errorMessage);
+        return false;
+    }
+    return true;
+}
+
+bool LevelLoader::ReadScriptLevel(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel) {
+    if (!RunLevelScript(lua, assetStore, levelNumber)) {
+        return false;
+    }
 
     // Read the big table for the current level
-    sol::table level = lua["Level"];
+    if (!outLevel.ReadTable(lua["Level"])) {
+        return false;
+    }
+
+    // an archived map is parsed in place in the mapped archive, a map file is read at once
+    const std::string& mapFilePath = outLevel.GetMapFile();
+    if (const ArchiveEntry* archivedMap = assetStore->FindArchivedFile(mapFilePath)) {
+        return outLevel.ReadTiles(reinterpret_cast<const char*>(assetStore->GetArchivedData(*archivedMap)), archivedMap->size);
+    }
+
+    std::ifstream mapFile(mapFilePath, std::ios::binary);
+    if (!mapFile) {
+        Logger::Err("Error opening the map file " + mapFilePath);
+        return false;
+    }
+    std::string mapText((std::istreambuf_iterator<char>(mapFile)), std::istreambuf_iterator<char>());
+    return outLevel.ReadTiles(mapText.data(), mapText.size());
+}
 
+void LevelLoader::LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer, SDL_Renderer* renderer, int levelNumber) {
+    LevelData level;
+    if (!ReadLevel(lua, assetStore, levelNumber, level)) {
+        return;
+    }
+
+    CreateLevel(level, registry, assetStore, tilemapRenderer, renderer);
+}
+
+bool LevelLoader::ReadLevel(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel) {
+    // The compiled level skips walking the Lua tables, the script only runs for its entity scripts
+    if (ReadCompiledLevel(assetStore, levelNumber, outLevel) && ResolveCompiledScripts(lua, assetStore, levelNumber, outLevel)) {
+        Logger::Log("Compiled level loaded: " + GetCompiledLevelPath(levelNumber));
+        return true;
+    }
+    return ReadScriptLevel(lua, assetStore, levelNumber, outLevel);
+}
+
+void LevelLoader::CreateLevel(const LevelData& level, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer, SDL_Renderer* renderer) {
+    CreateLevelAssets(level, assetStore, TextureAtlas::GetMaxTextureSize(renderer));
+    assetStore->CreateTextureAtlasPages(renderer);
+
+    CreateLevelEntities(level, registry, assetStore, tilemapRenderer);
+
+    const LevelTilemap& map = level.tilemap;
+    Game::MapWidth = map.numCols * map.tileSize * map.scale;
+    Game::MapHeight = map.numRows * map.tileSize * map.scale;
+
+    // Everything drawn by the tilemap is known now, bake its chunks, or let the game bake them
+    // once the textures still loading in the background are there
+    if (!assetStore->IsLoading()) {
+        tilemapRenderer->Bake(renderer, *assetStore);
+    }
+}
+
+void LevelLoader::CreateLevelAssets(const LevelData& level, const std::unique_ptr<AssetManager>& assetStore, int maxTextureSize) {
     ////////////////////////////////////////////////////////////////////////////
-    // Read the level assets
+    // Queue the level assets
     ////////////////////////////////////////////////////////////////////////////
-    sol::table assets = level["assets"];
 
-    int i = 0;
-    while (true) {
-        sol::optional<sol::table> hasAsset = assets[i];
-        if (hasAsset == sol::nullopt) {
-            break;
-        }
-        sol::table asset = assets[i];
-        std::string assetType = asset["type"];
-        std::string assetId = asset["id"];
-        if (assetType == "texture") {
-            assetStore->AddTexture(renderer, assetId, asset["file"]);
-            Logger::Log("A new texture asset was added to the asset store, id: " + assetId);
+    // Level textures are packed in atlas pages when the level asks for it
+    if (level.textureAtlas.isEnabled) {
+        assetStore->BeginTextureAtlas(level.textureAtlas.pageSize, level.GetString(level.textureAtlas.cacheFile));
+    }
+
+    for (const auto& asset : level.assets) {
+        const std::string& assetId = level.GetString(asset.id);
+        if (asset.type == LAT_Texture) {
+            assetStore->LoadTextureAsync(assetId, level.GetString(asset.file));
+            Logger::Log("A new texture asset was queued in the asset store, id: " + assetId);
         }
-        if (assetType == "font") {
-            assetStore->AddFont(assetId, asset["file"], asset["font_size"]);
-            Logger::Log("A new font asset was added to the asset store, id: " + assetId);
+        if (asset.type == LAT_Font) {
+            assetStore->LoadFontAsync(assetId, level.GetString(asset.file), asset.fontSize);
+            Logger::Log("A new font asset was queued in the asset store, id: " + assetId);
         }
-        i++;
     }
+    assetStore->PackTextureAtlas(maxTextureSize);
 
     ////////////////////////////////////////////////////////////////////////////
-    // Read the level tilemap information
+    // Replay the animation clips of the spritesheets, they get the indices the entities refer to
     ////////////////////////////////////////////////////////////////////////////
-    sol::table map = level["tilemap"];
-    std::string mapFilePath = map["map_file"];
-    std::string mapTextureAssetId = map["texture_asset_id"];
-    int mapNumRows = map["num_rows"];
-    int mapNumCols = map["num_cols"];
-    int tileSize = map["tile_size"];
-    double mapScale = map["scale"];
-    std::fstream mapFile;
-    mapFile.open(mapFilePath);
-    for (int y = 0; y < mapNumRows; y++) {
-        for (int x = 0; x < mapNumCols; x++) {
-            char ch;
-            mapFile.get(ch);
-            int srcRectY = std::atoi(&ch) * tileSize;
-            mapFile.get(ch);
-            int srcRectX = std::atoi(&ch) * tileSize;
-            mapFile.ignore();
-
-            Entity tile = registry->CreateEntity();
-            tile.AddComponent<TransformComponent>(glm::vec2(x * (mapScale * tileSize), y * (mapScale * tileSize)), glm::vec2(mapScale, mapScale), 0.0);
-            tile.AddComponent<SpriteComponent>(mapTextureAssetId, tileSize, tileSize, 0, false, srcRectX, srcRectY);
-        }
+    AnimationClipTable& animationClips = assetStore->GetAnimationClips();
+    for (const auto& clip : level.animationClips) {
+        std::vector<SDL_Rect> frames(level.animationFrames.begin() + clip.firstFrame, level.animationFrames.begin() + clip.firstFrame + clip.numFrames);
+        animationClips.AddClip(level.GetString(clip.id), level.GetString(clip.assetID), frames, clip.frameRate, static_cast<EAnimationLoopMode>(clip.loopMode));
+    }
+    if (!level.animationClips.empty()) {
+        Logger::Log("Animation clips loaded: " + std::to_string(animationClips.GetNumClips()));
     }
-    mapFile.close();
-    Game::MapWidth = mapNumCols * tileSize * mapScale;
-    Game::MapHeight = mapNumRows * tileSize * mapScale;
+}
 
+void LevelLoader::CreateLevelEntities(const LevelData& level, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer) {
     ////////////////////////////////////////////////////////////////////////////
-    // Read the level entities and their components
+    // Set up the tilemap and its collision grid
     ////////////////////////////////////////////////////////////////////////////
-    sol::table entities = level["entities"];
-    i = 0;
-    while (true) {
-        sol::optional<sol::table> hasEntity = entities[i];
-        if (hasEntity == sol::nullopt) {
-            break;
+    const LevelTilemap& map = level.tilemap;
+    TileCollisionGrid& tileGrid = registry->GetSystem<TileCollisionSystem>().GetGrid();
+    tileGrid.Reset(map.numCols, map.numRows, static_cast<float>(map.tileSize * map.scale));
+
+    // Tiles go to the tilemap renderer, they are baked in chunks once the level is loaded
+    tilemapRenderer->Reset(map.numCols, map.numRows, map.tileSize, static_cast<float>(map.scale), level.GetString(map.textureAssetID), map.tilesetCols, map.chunkTiles);
+    for (int y = 0; y < map.numRows; y++) {
+        for (int x = 0; x < map.numCols; x++) {
+            const LevelTile& tile = level.tiles[static_cast<size_t>(y) * map.numCols + x];
+            if (tile.flags & LTF_Solid) {
+                tileGrid.SetSolid(x, y, true);
+            }
+            tilemapRenderer->SetTile(x, y, tile.index);
         }
+    }
 
-        sol::table entity = entities[i];
+    // Static decorations are drawn in the tilemap chunks, without an entity
+    for (const auto& decoration : level.decorations) {
+        tilemapRenderer->AddDecoration(level.GetString(decoration.assetID), decoration.srcRect, decoration.dstRect, decoration.zIndex, decoration.angle, SDL_FLIP_NONE);
+    }
 
-        Entity newEntity = registry->CreateEntity();
+    ////////////////////////////////////////////////////////////////////////////
+    // Set up the collision layers and the layer pairs that never collide
+    ////////////////////////////////////////////////////////////////////////////
+    CollisionLayerMatrix& layerMatrix = registry->GetSystem<CollisionSystem>().GetLayerMatrix();
+    layerMatrix.Reset();
+    for (uint32_t layerName : level.collisionLayers) {
+        layerMatrix.AddLayer(level.GetString(layerName));
+    }
+    for (const auto& pair : level.ignoredLayerPairs) {
+        layerMatrix.SetLayersCollide(pair.layerA, pair.layerB, false);
+    }
 
-        // Tag
-        sol::optional<std::string> tag = entity["tag"];
-        if (tag != sol::nullopt) {
-            newEntity.Tag(entity["tag"]);
-        }
+    // The tile grid collides like a collider placed on the tilemap collision layer
+    registry->GetSystem<TileCollisionSystem>().SetCollidingLayers(layerMatrix.GetLayerMask(map.collisionLayer));
 
-        // Group
-        sol::optional<std::string> group = entity["group"];
-        if (group != sol::nullopt) {
-            newEntity.Group(entity["group"]);
-        }
+    ////////////////////////////////////////////////////////////////////////////
+    // Create the level entities, then fill the component pools one block at a time
+    ////////////////////////////////////////////////////////////////////////////
+    std::vector<Entity> entities;
+    entities.reserve(level.numEntities);
+    for (uint32_t i = 0; i < level.numEntities; i++) {
+        entities.push_back(registry->CreateEntity());
+    }
 
-        // Components
-        sol::optional<sol::table> hasComponents = entity["components"];
-        if (hasComponents != sol::nullopt) {
-            // Transform
-            sol::optional<sol::table> transform = entity["components"]["transform"];
-            if (transform != sol::nullopt) {
-                newEntity.AddComponent<TransformComponent>(
-                    glm::vec2(
-                        entity["components"]["transform"]["position"]["x"],
-                        entity["components"]["transform"]["position"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["transform"]["scale"]["x"].get_or(1.0),
-                        entity["components"]["transform"]["scale"]["y"].get_or(1.0)
-                    ),
-                    entity["components"]["transform"]["rotation"].get_or(0.0)
-                );
-            }
+    for (const auto& tag : level.tags) {
+        entities[tag.entity].Tag(level.GetString(tag.name));
+    }
+    for (const auto& group : level.groups) {
+        entities[group.entity].Group(level.GetString(group.name));
+    }
 
-            // RigidBody
-            sol::optional<sol::table> rigidbody = entity["components"]["rigidbody"];
-            if (rigidbody != sol::nullopt) {
-                newEntity.AddComponent<RigidBodyComponent>(
-                    glm::vec2(
-                        entity["components"]["rigidbody"]["velocity"]["x"].get_or(0.0),
-                        entity["components"]["rigidbody"]["velocity"]["y"].get_or(0.0)
-                    )
-                );
-            }
+    registry->ReserveComponents<TransformComponent>(static_cast<int>(level.transforms.size()));
+    for (const auto& transform : level.transforms) {
+        entities[transform.entity].AddComponent<TransformComponent>(
+            glm::vec2(transform.positionX, transform.positionY),
+            glm::vec2(transform.scaleX, transform.scaleY),
+            transform.rotation
+        );
+    }
 
-            // Sprite
-            sol::optional<sol::table> sprite = entity["components"]["sprite"];
-            if (sprite != sol::nullopt) {
-                newEntity.AddComponent<SpriteComponent>(
-                    entity["components"]["sprite"]["texture_asset_id"],
-                    entity["components"]["sprite"]["width"],
-                    entity["components"]["sprite"]["height"],
-                    entity["components"]["sprite"]["z_index"].get_or(1),
-                    entity["components"]["sprite"]["fixed"].get_or(false),
-                    entity["components"]["sprite"]["src_rect_x"].get_or(0),
-                    entity["components"]["sprite"]["src_rect_y"].get_or(0)
-                );
-            }
+    registry->ReserveComponents<RigidBodyComponent>(static_cast<int>(level.rigidBodies.size()));
+    for (const auto& rigidBody : level.rigidBodies) {
+        entities[rigidBody.entity].AddComponent<RigidBodyComponent>(glm::vec2(rigidBody.velocityX, rigidBody.velocityY));
+    }
 
-            // Animation
-            sol::optional<sol::table> animation = entity["components"]["animation"];
-            if (animation != sol::nullopt) {
-                newEntity.AddComponent<AnimationComponent>(
-                    entity["components"]["animation"]["num_frames"].get_or(1),
-                    entity["components"]["animation"]["speed_rate"].get_or(1)
-                );
-            }
+    registry->ReserveComponents<SpriteComponent>(static_cast<int>(level.sprites.size()));
+    for (const auto& sprite : level.sprites) {
+        Entity& entity = entities[sprite.entity];
+        entity.AddComponent<SpriteComponent>(
+            level.GetString(sprite.assetID),
+            sprite.width,
+            sprite.height,
+            sprite.zIndex,
+            sprite.isFixed != 0,
+            sprite.srcRectX,
+            sprite.srcRectY
+        );
 
-            // BoxCollider
-            sol::optional<sol::table> collider = entity["components"]["boxcollider"];
-            if (collider != sol::nullopt) {
-                newEntity.AddComponent<BoxCollisionComponent>(
-                    entity["components"]["boxcollider"]["width"],
-                    entity["components"]["boxcollider"]["height"],
-                    glm::vec2(
-                        entity["components"]["boxcollider"]["offset"]["x"].get_or(0),
-                        entity["components"]["boxcollider"]["offset"]["y"].get_or(0)
-                    )
-                );
-            }
-            
-            // Health
-            sol::optional<sol::table> health = entity["components"]["health"];
-            if (health != sol::nullopt) {
-                newEntity.AddComponent<HealthComponent>(
-                    static_cast<int>(entity["components"]["health"]["health_percentage"].get_or(100))
-                );
-            }
-            
-            // ProjectileEmitter
-            sol::optional<sol::table> projectileEmitter = entity["components"]["projectile_emitter"];
-            if (projectileEmitter != sol::nullopt) {
-                newEntity.AddComponent<ProjectileEmitterComponent>(
-                    glm::vec2(
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["x"],
-                        entity["components"]["projectile_emitter"]["projectile_velocity"]["y"]
-                    ),
-                    static_cast<int>(entity["components"]["projectile_emitter"]["repeat_frequency"].get_or(1)) * 1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["projectile_duration"].get_or(10)) * 1000,
-                    static_cast<int>(entity["components"]["projectile_emitter"]["hit_percentage_damage"].get_or(10)),
-                    entity["components"]["projectile_emitter"]["friendly"].get_or(false)
-                );
-            }
+        // the asset ids are only looked up here, the sprite draws through its handle
+        auto& spriteComponent = entity.GetComponent<SpriteComponent>();
+        spriteComponent.texture = assetStore->GetTextureHandle(spriteComponent.assetID);
+    }
 
-            // CameraFollow
-            sol::optional<sol::table> cameraFollow = entity["components"]["camera_follow"];
-            if (cameraFollow != sol::nullopt) {
-                newEntity.AddComponent<CameraFollowComponent>();
-            }
+    registry->ReserveComponents<AnimationComponent>(static_cast<int>(level.animations.size()));
+    for (const auto& animation : level.animations) {
+        entities[animation.entity].AddComponent<AnimationComponent>(animation.clip, 0.0);
+    }
 
-            // KeyboardControlled
-            sol::optional<sol::table> keyboardControlled = entity["components"]["keyboard_controller"];
-            if (keyboardControlled != sol::nullopt) {
-                newEntity.AddComponent<KeyboardControlledComponent>(
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["up_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["up_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["right_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["right_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["down_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["down_velocity"]["y"]
-                    ),
-                    glm::vec2(
-                        entity["components"]["keyboard_controller"]["left_velocity"]["x"],
-                        entity["components"]["keyboard_controller"]["left_velocity"]["y"]
-                    )
-                );
-            }
-        }
-        i++;
+    registry->ReserveComponents<BoxCollisionComponent>(static_cast<int>(level.boxColliders.size()));
+    for (const auto& collider : level.boxColliders) {
+        entities[collider.entity].AddComponent<BoxCollisionComponent>(
+            collider.width,
+            collider.height,
+            glm::vec2(collider.offsetX, collider.offsetY),
+            collider.layer
+        );
     }
-}
 
+    registry->ReserveComponents<HealthComponent>(static_cast<int>(level.healths.size()));
+    for (const auto& health : level.healths) {
+        entities[health.entity].AddComponent<HealthComponent>(health.healthPercentage);
+    }
 
+    registry->ReserveComponents<ProjectileEmitterComponent>(static_cast<int>(level.projectileEmitters.size()));
+    for (const auto& emitter : level.projectileEmitters) {
+        entities[emitter.entity].AddComponent<ProjectileEmitterComponent>(
+            glm::vec2(emitter.velocityX, emitter.velocityY),
+            emitter.repeatFrequency,
+            emitter.projectileDuration,
+            emitter.hitPercentDamage,
+            emitter.isFriendly != 0
+        );
+    }
 
+    for (const auto& cameraFollow : level.cameraFollows) {
+        entities[cameraFollow.entity].AddComponent<CameraFollowComponent>();
+    }
+
+    registry->ReserveComponents<KeyboardControlledComponent>(static_cast<int>(level.keyboardControls.size()));
+    for (const auto& control : level.keyboardControls) {
+        entities[control.entity].AddComponent<KeyboardControlledComponent>(
+            glm::vec2(control.velocities[0], control.velocities[1]),
+            glm::vec2(control.velocities[2], control.velocities[3]),
+            glm::vec2(control.velocities[4], control.velocities[5]),
+            glm::vec2(control.velocities[6], control.velocities[7]),
+            control.clips[0],
+            control.clips[1],
+            control.clips[2],
+            control.clips[3]
+        );
+    }
+
+    // Scripted entities run their update function in the script system
+    ScriptSystem& scriptSystem = registry->GetSystem<ScriptSystem>();
+    registry->ReserveComponents<ScriptComponent>(static_cast<int>(level.scripts.size()));
+    for (const auto& script : level.scripts) {
+        entities[script.entity].AddComponent<ScriptComponent>(scriptSystem.AddScript(script.function));
+    }
+}
 
+bool LevelLoader::LevelExists(const AssetManager& assetStore, int levelNumber) {
+    const std::string scriptPath = GetScriptPath(levelNumber);
+    const std::string compiledPath = GetCompiledLevelPath(levelNumber);
+    std::error_code error;
+    return assetStore.FindArchivedFile(scriptPath) || assetStore.FindArchivedFile(compiledPath) ||
+        std::filesystem::exists(scriptPath, error) || std::filesystem::exists(compiledPath, error);
+}
+
+std::string LevelLoader::GetScriptPath(int levelNumber) {
+    return "./assets/scripts/Level" + std::to_string(levelNumber) + ".lua";
+}
+
+std::string LevelLoader::GetCompiledLevelPath(int levelNumber) {
+    return "./assets/scripts/Level" + std::to_string(levelNumber) + ".level";
+}
@@ -4,17 +4,76 @@
 #include "../ECS/ECS.h"
 #include <SDL2/SDL.h>
 #include "../AssetManager/AssetManager.h"
+#include "../Renderer/TilemapRenderer.h"
+#include "ScriptCache.h"
 #include <memory>
 #include <sol/sol.hpp>
+#include <string>
 
+struct LevelData;
 
 class LevelLoader
 {
 public:
     LevelLoader() ;
     ~LevelLoader();
-    void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, SDL_Renderer* renderer, int levelNumber);
 
+    /**
+     * Loads the compiled level when there is an up to date one, in the archive or next to the
+     * script, and runs the level Lua script otherwise, or for the entity scripts of the compiled level.
+     */
+    void LoadLevel(sol::state& lua, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer, SDL_Renderer* renderer, int levelNumber);
+
+    /**
+     * Reads the level description, from the compiled level or the level script. Does not use the
+     * renderer, so a level can be read on another thread than the one owning it.
+     */
+    bool ReadLevel(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel);
+
+    /**
+     * Queues the assets and creates the tilemap and the entities of a level description.
+     */
+    void CreateLevel(const LevelData& level, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer, SDL_Renderer* renderer);
+
+    /**
+     * First part of CreateLevel, without the renderer: queues the assets, packs the atlas pages
+     * (created by AssetManager::CreateTextureAtlasPages) and adds the animation clips.
+     *
+     * @param maxTextureSize Largest texture the renderer can create, 0 for no limit.
+     */
+    void CreateLevelAssets(const LevelData& level, const std::unique_ptr<AssetManager>& assetStore, int maxTextureSize);
+
+    /**
+     * Second part of CreateLevel, without the renderer: sets up the tilemap, its collision grid
+     * and the collision layers, and creates the entities. The tilemap is not baked and the map
+     * size of the game is not set.
+     */
+    void CreateLevelEntities(const LevelData& level, const std::unique_ptr<Registry>& registry, const std::unique_ptr<AssetManager>& assetStore, const std::unique_ptr<TilemapRenderer>& tilemapRenderer);
+
+    /**
+     * Whether the level has a script or a compiled level, on disk or in the archive
+     */
+    static bool LevelExists(const AssetManager& assetStore, int levelNumber);
+
+    static std::string GetScriptPath(int levelNumber);
+    static std::string GetCompiledLevelPath(int levelNumber);
+
+    /**
+     * Directory of the compiled level scripts, empty to compile them on every load
+     */
+    void SetScriptCacheDirectory(const std::string& directory) { scriptCache.SetDirectory(directory); }
+
+private:
+    bool ReadCompiledLevel(const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel);
+    bool ReadScriptLevel(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& outLevel);
+    bool ResolveCompiledScripts(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber, LevelData& level);
+
+    /**
+     * Loads the level script, from the archive or the script cache, and runs it to build the Level table
+     */
+    bool RunLevelScript(sol::state& lua, const std::unique_ptr<AssetManager>& assetStore, int levelNumber);
+
+    ScriptCache scriptCache;
 
 };
 
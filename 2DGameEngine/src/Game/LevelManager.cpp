@@ -0,0 +1,191 @@
+#include "LevelManager.h"
+#include "LevelData.h"
+#include "../Logger/Logger.h"
+#include "../Systems/ScriptSystem.h"
+
+LevelManager::LevelManager()
+    : state(ELS_Idle)
+{
+}
+
+LevelManager::~LevelManager()
+{
+    Clear();
+}
+
+void LevelManager::Preload(int levelNumber, LevelContext&& context, const AssetManager& currentAssets, int maxTextureSize)
+{
+    if (IsPreloading())
+    {
+        Logger::Warn("Level " + std::to_string(staged.levelNumber) + " is already preloading, level " + std::to_string(levelNumber) + " is not loaded");
+        return;
+    }
+
+    if (levelThread.joinable())
+    {
+        levelThread.join();
+    }
+    ReleaseStagedLevel();
+
+    staged = std::move(context);
+    staged.levelNumber = levelNumber;
+
+    // the textures resident now are shared, the ones evicted until the level is created are loaded again
+    std::vector<SharedTexture> sharedTextures;
+    currentAssets.GetShareableTextures(sharedTextures);
+    staged.assetManager->SetShareableTextures(sharedTextures);
+
+    Logger::Log("Preloading level " + std::to_string(levelNumber) + ", " + std::to_string(sharedTextures.size()) + " textures can be shared");
+    preloadStart = SDL_GetPerformanceCounter();
+    state = ELS_Loading;
+    levelThread = std::thread(&LevelManager::LoadStagedLevel, this, maxTextureSize);
+}
+
+/**
+ * Reads the level and creates its entities without the renderer, the pages and the textures are
+ * created on the main thread by Update.
+ */
+void LevelManager::LoadStagedLevel(int maxTextureSize)
+{
+    ScriptSystem& scriptSystem = staged.registry->GetSystem<ScriptSystem>();
+    scriptSystem.Initialize(*staged.lua);
+
+    LevelData level;
+    if (!loader.ReadLevel(*staged.lua, staged.assetManager, staged.levelNumber, level))
+    {
+        Logger::Err("Error preloading level " + std::to_string(staged.levelNumber));
+        state = ELS_Failed;
+        return;
+    }
+
+    loader.CreateLevelAssets(level, staged.assetManager, maxTextureSize);
+    loader.CreateLevelEntities(level, staged.registry, staged.assetManager, staged.tilemapRenderer);
+
+    // the systems get their entities now rather than in the first frame of the level
+    staged.registry->Update();
+    scriptSystem.StopAutomaticGarbageCollection();
+
+    const LevelTilemap& map = level.tilemap;
+    staged.mapWidth = map.numCols * map.tileSize * map.scale;
+    staged.mapHeight = map.numRows * map.tileSize * map.scale;
+    state = ELS_Created;
+}
+
+void LevelManager::Update(SDL_Renderer* renderer, AssetManager& currentAssets, double budgetMs)
+{
+    if (state == ELS_Failed && levelThread.joinable())
+    {
+        levelThread.join();
+        ReleaseStagedLevel();
+        return;
+    }
+
+    if (state == ELS_Created)
+    {
+        levelThread.join();
+        staged.assetManager->CreateTextureAtlasPages(renderer);
+        staged.assetManager->HoldSharedTextures(currentAssets);
+        state = ELS_Uploading;
+    }
+
+    if (state != ELS_Uploading)
+    {
+        return;
+    }
+
+    staged.assetManager->UploadLoadedAssets(renderer, budgetMs);
+    if (staged.assetManager->IsLoading())
+    {
+        return;
+    }
+
+    staged.tilemapRenderer->Bake(renderer, *staged.assetManager);
+    state = ELS_Ready;
+
+    const double preloadMs = (SDL_GetPerformanceCounter() - preloadStart) * 1000.0 / SDL_GetPerformanceFrequency();
+    Logger::Log("Level " + std::to_string(staged.levelNumber) + " preloaded in " + std::to_string(preloadMs) + " ms");
+}
+
+void LevelManager::FinishLoading(SDL_Renderer* renderer, AssetManager& currentAssets)
+{
+    if (state == ELS_Loading && levelThread.joinable())
+    {
+        levelThread.join();
+    }
+
+    Update(renderer, currentAssets, 0.0);
+    if (state == ELS_Uploading)
+    {
+        staged.assetManager->FinishLoading(renderer);
+        Update(renderer, currentAssets, 0.0);
+    }
+}
+
+LevelContext LevelManager::TakeLevel()
+{
+    LevelContext level = std::move(staged);
+    staged = LevelContext();
+    state = ELS_Idle;
+    return level;
+}
+
+void LevelManager::DestroyLevel(LevelContext&& level)
+{
+    // the tilemap releases its textures in the asset manager of the level, destroyed next
+    if (level.tilemapRenderer)
+    {
+        level.tilemapRenderer->Clear();
+    }
+    level.tilemapRenderer.reset();
+    level.assetManager.reset();
+
+    if (destroyThread.joinable())
+    {
+        destroyThread.join();
+    }
+
+    // thousands of entities and a Lua heap take a while to free, the frame does not wait for them
+    destroyThread = std::thread([registry = std::move(level.registry), lua = std::move(level.lua)]() mutable
+    {
+        registry.reset();
+        lua.reset();
+    });
+}
+
+void LevelManager::Clear()
+{
+    JoinThreads();
+    ReleaseStagedLevel();
+    state = ELS_Idle;
+}
+
+void LevelManager::ReleaseStagedLevel()
+{
+    if (staged.tilemapRenderer)
+    {
+        staged.tilemapRenderer->Clear();
+    }
+    staged.tilemapRenderer.reset();
+    staged.assetManager.reset();
+    staged.registry.reset();
+    staged.lua.reset();
+    staged = LevelContext();
+}
+
+void LevelManager::JoinThreads()
+{
+    if (levelThread.joinable())
+    {
+        levelThread.join();
+    }
+    if (destroyThread.joinable())
+    {
+        destroyThread.join();
+    }
+}
+
+int LevelManager::GetNextLevel(const AssetManager& assetStore, int levelNumber)
+{
+    const int nextLevel = levelNumber + 1;
+    return LevelLoader::LevelExists(assetStore, nextLevel) ? nextLevel : 1;
+}
@@ -0,0 +1,138 @@
+#ifndef LEVELMANAGER_H
+#define LEVELMANAGER_H
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sol/sol.hpp>
+#include "../ECS/ECS.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Renderer/TilemapRenderer.h"
+#include "LevelLoader.h"
+
+/**
+ * Everything a level owns: its Lua state, the registry of its entities, its assets and its tilemap.
+ *
+ * Declared in the order they can be destroyed in reverse: the tilemap releases its textures in
+ * the asset manager, the script system of the registry holds references into the Lua state.
+ */
+struct LevelContext
+{
+    int levelNumber = 0;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    std::unique_ptr<sol::state> lua;
+    std::unique_ptr<Registry> registry;
+    std::unique_ptr<AssetManager> assetManager;
+    std::unique_ptr<TilemapRenderer> tilemapRenderer;
+};
+
+/**
+ * Loads the next level in the background while the current one plays.
+ *
+ * The level is read and its entities created in a staging context on the level thread: the level
+ * script runs in the staging Lua state, the atlas is packed and the images decoded by the staging
+ * asset loader. The main thread then creates the atlas pages and the textures within a time
+ * budget per frame, and bakes the tilemap. Once ready, the game swaps the staged context with the
+ * current one, which only moves pointers, and hands the old level to DestroyLevel.
+ *
+ * Textures resident in the current level with the same asset ID and file are not loaded again,
+ * the staged asset manager shares them and takes them over at the swap (see
+ * AssetManager::SetShareableTextures). The other textures of the old level are released with it.
+ *
+ * Every function runs on the main thread, while the simulation worker is idle.
+ */
+class LevelManager
+{
+public:
+    LevelManager();
+    ~LevelManager();
+
+    LevelManager(const LevelManager&) = delete;
+    LevelManager& operator=(const LevelManager&) = delete;
+
+    /**
+     * Starts loading a level into the staging context on the level thread.
+     *
+     * @param context Empty level with its systems added and its assets set up, the level thread owns it until the level is taken.
+     * @param currentAssets Asset manager of the level playing, whose resident textures the staged level shares.
+     * @param maxTextureSize Largest texture the renderer can create, 0 for no limit.
+     */
+    void Preload(int levelNumber, LevelContext&& context, const AssetManager& currentAssets, int maxTextureSize);
+
+    /**
+     * Creates the atlas pages once the level thread is done, then the textures decoded so far
+     * within the time budget, and bakes the tilemap once the last one is there.
+     *
+     * @param currentAssets Asset manager of the level playing, the shared textures are referenced in it.
+     * @param budgetMs Time budget of the texture uploads in milliseconds, 0 to upload everything already decoded.
+     */
+    void Update(SDL_Renderer* renderer, AssetManager& currentAssets, double budgetMs);
+
+    /**
+     * Blocks until the staged level is ready.
+     */
+    void FinishLoading(SDL_Renderer* renderer, AssetManager& currentAssets);
+
+    /**
+     * Hands the ready level over, the manager is idle again.
+     */
+    LevelContext TakeLevel();
+
+    /**
+     * Releases a level that is no longer played. Its tilemap and assets belong to the renderer and
+     * are released at once, its entities and its Lua state are destroyed on a background thread.
+     */
+    void DestroyLevel(LevelContext&& level);
+
+    /**
+     * Waits for the background threads and releases the staged level, before the renderer is destroyed.
+     */
+    void Clear();
+
+    bool IsPreloading() const { return state != ELS_Idle && state != ELS_Failed; }
+    bool IsReady() const { return state == ELS_Ready; }
+    bool HasFailed() const { return state == ELS_Failed; }
+    int GetStagedLevel() const { return staged.levelNumber; }
+
+    /**
+     * Level played after this one: the next level number when it exists, otherwise the first level.
+     */
+    static int GetNextLevel(const AssetManager& assetStore, int levelNumber);
+
+    /**
+     * Directory of the compiled level scripts, see LevelLoader::SetScriptCacheDirectory.
+     */
+    void SetScriptCacheDirectory(const std::string& directory) { loader.SetScriptCacheDirectory(directory); }
+
+private:
+    enum ELevelState
+    {
+        ELS_Idle,
+        ELS_Loading,    /**< Read and created on the level thread */
+        ELS_Created,    /**< Level thread done, waiting for its textures */
+        ELS_Uploading,  /**< Textures uploaded by Update */
+        ELS_Ready,
+        ELS_Failed
+    };
+
+    /**
+     * Body of the level thread, the staged context is only touched by it until it sets ELS_Created.
+     */
+    void LoadStagedLevel(int maxTextureSize);
+
+    void ReleaseStagedLevel();
+    void JoinThreads();
+
+    LevelLoader loader;
+    LevelContext staged;
+    std::atomic<ELevelState> state;
+    Uint64 preloadStart = 0;
+
+    std::thread levelThread;
+    std::thread destroyThread;
+};
+
+#endif
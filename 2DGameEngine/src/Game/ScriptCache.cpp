@@ -0,0 +1,150 @@
+#include "ScriptCache.h"
+#include "../Logger/Logger.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    /**
+     * Header of a cache file, followed by the bytecode
+     */
+    struct ScriptCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+    };
+
+    constexpr uint32_t SCRIPT_CACHE_MAGIC = 0x43534547;    // "GESC"
+    constexpr uint32_t SCRIPT_CACHE_VERSION = 1;
+
+    bool ReadFile(const std::string& path, std::string& outBytes)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        outBytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    int WriteChunk(lua_State*, const void* bytes, size_t size, void* userData)
+    {
+        static_cast<std::string*>(userData)->append(static_cast<const char*>(bytes), size);
+        return 0;
+    }
+}
+
+ScriptCache::ScriptCache(const std::string& directory)
+    : directory(directory)
+{
+}
+
+sol::load_result ScriptCache::Load(sol::state& lua, const std::string& scriptPath)
+{
+    std::string source;
+    if (directory.empty() || !ReadFile(scriptPath, source))
+    {
+        return lua.load_file(scriptPath);
+    }
+
+    const std::string chunkName = "@" + scriptPath;
+    const uint64_t sourceHash = Hash(source.data(), source.size());
+    const std::string cachePath = GetCachePath(scriptPath);
+
+    std::string cached;
+    ScriptCacheHeader header = {};
+    if (ReadFile(cachePath, cached) && cached.size() > sizeof(header))
+    {
+        std::memcpy(&header, cached.data(), sizeof(header));
+        if (header.magic == SCRIPT_CACHE_MAGIC && header.version == SCRIPT_CACHE_VERSION && header.sourceHash == sourceHash)
+        {
+            sol::load_result chunk = lua.load_buffer(cached.data() + sizeof(header), cached.size() - sizeof(header), chunkName, sol::load_mode::binary);
+            if (chunk.valid())
+            {
+                return chunk;
+            }
+            Logger::Warn("The cached bytecode of " + scriptPath + " cannot be loaded, compiling the script");
+        }
+    }
+
+    sol::load_result chunk = lua.load_buffer(source.data(), source.size(), chunkName, sol::load_mode::text);
+    if (!chunk.valid())
+    {
+        return chunk;
+    }
+
+    // the chunk stays on the stack for the caller, a copy of it is dumped
+    lua_State* state = lua.lua_state();
+    sol::protected_function function = chunk;
+    std::string bytecode;
+    function.push();
+    const bool isDumped = lua_dump(state, WriteChunk, &bytecode, 0) == 0;
+    lua_pop(state, 1);
+
+    if (isDumped)
+    {
+        Save(cachePath, sourceHash, bytecode);
+    }
+    return chunk;
+}
+
+uint64_t ScriptCache::Hash(const char* bytes, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * One cache file per script, named after its path so a new version of a script replaces the old one
+ */
+std::string ScriptCache::GetCachePath(const std::string& scriptPath) const
+{
+    std::string name = scriptPath;
+    for (char& character : name)
+    {
+        if (character == '/' || character == '\\' || character == ':' || character == '.')
+        {
+            character = '_';
+        }
+    }
+    return directory + "/" + name + ".luac";
+}
+
+/**
+ * Writes a temporary file renamed over the cache file, an interrupted write never leaves a
+ * truncated bytecode behind
+ */
+void ScriptCache::Save(const std::string& cachePath, uint64_t sourceHash, const std::string& bytecode) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        const ScriptCacheHeader header = { SCRIPT_CACHE_MAGIC, SCRIPT_CACHE_VERSION, sourceHash };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+        if (!file)
+        {
+            Logger::Warn("Error writing the script cache " + cachePath);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error)
+    {
+        Logger::Warn("Error writing the script cache " + cachePath + ": " + error.message());
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
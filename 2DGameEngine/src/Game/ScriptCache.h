@@ -0,0 +1,48 @@
+#ifndef SCRIPTCACHE_H
+#define SCRIPTCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <sol/sol.hpp>
+
+/**
+ * Cache of the compiled Lua scripts.
+ *
+ * The first load of a script compiles its source and writes the bytecode (lua_dump) in the cache
+ * directory, one file per script, with the hash of the source it was compiled from. Later loads
+ * hash the source and load the bytecode when the hashes match, without parsing the source. A
+ * changed source, a bytecode of another Lua version or a damaged cache file is compiled again and
+ * replaces the cache file.
+ *
+ * The bytecode is loaded without any check by Lua: the cache directory has to be as trusted as
+ * the scripts themselves.
+ */
+class ScriptCache
+{
+public:
+    static constexpr const char* DEFAULT_DIRECTORY = "./assets/cache/scripts";
+
+    explicit ScriptCache(const std::string& directory = DEFAULT_DIRECTORY);
+
+    /**
+     * Loads the chunk of a script file without running it, from the cache when it is up to date.
+     * An empty cache directory compiles the source every time.
+     */
+    sol::load_result Load(sol::state& lua, const std::string& scriptPath);
+
+    void SetDirectory(const std::string& directory) { this->directory = directory; }
+    const std::string& GetDirectory() const { return directory; }
+
+    /**
+     * 64-bit FNV-1a hash of the bytes
+     */
+    static uint64_t Hash(const char* bytes, size_t size);
+
+private:
+    std::string GetCachePath(const std::string& scriptPath) const;
+    void Save(const std::string& cachePath, uint64_t sourceHash, const std::string& bytecode) const;
+
+    std::string directory;
+};
+
+#endif
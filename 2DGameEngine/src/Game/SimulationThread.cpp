@@ -0,0 +1,67 @@
+#include "SimulationThread.h"
+
+SimulationThread::~SimulationThread()
+{
+    Stop();
+}
+
+void SimulationThread::Start(std::function<void()> job)
+{
+    Stop();
+
+    this->job = std::move(job);
+    isStopping = false;
+    isBusy = false;
+    thread = std::thread(&SimulationThread::Loop, this);
+}
+
+void SimulationThread::Kick()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isBusy = true;
+    }
+    condition.notify_all();
+}
+
+void SimulationThread::Wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return !isBusy; });
+}
+
+void SimulationThread::Stop()
+{
+    if (!thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return !isBusy; });
+        isStopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void SimulationThread::Loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return isBusy || isStopping; });
+        if (isStopping)
+        {
+            return;
+        }
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        isBusy = false;
+        condition.notify_all();
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Worker thread running the simulation of the next frame while the main thread renders the current one.
+ *
+ * The job is given once to Start, every Kick runs it once on the worker and Wait blocks until that
+ * run is over. Between Wait and the next Kick the worker is idle, the data shared with the job can
+ * then be touched by the main thread without locking.
+ */
+class SimulationThread
+{
+public:
+    SimulationThread() = default;
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    /**
+     * Starts the worker, idle until the first Kick.
+     */
+    void Start(std::function<void()> job);
+
+    /**
+     * Runs the job once on the worker, the previous run must have been waited for.
+     */
+    void Kick();
+
+    /**
+     * Blocks until the job started by the last Kick is over, returns at once when the worker is idle.
+     */
+    void Wait();
+
+    /**
+     * Waits for the running job and joins the worker.
+     */
+    void Stop();
+
+    bool IsStarted() const { return thread.joinable(); }
+
+private:
+    void Loop();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::function<void()> job;
+    bool isBusy = false;
+    bool isStopping = false;
+};
+
+#endif
@@ -1,87 +1,491 @@
 #include "Logger.h"
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
-#include <fstream> 
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-ENGINE_API std::vector<LogEntry> Logger::messages;
+namespace
+{
+    /**
+     * Records of the ring buffer (256 bytes each), a power of two
+     */
+    constexpr size_t LOG_BUFFER_SIZE = 16384;
 
-/** log.txt file path from text file debug  */
-ENGINE_API std::string Logger::filePath = "log.txt";
+    /**
+     * Longest the writer sleeps before looking for new records, in milliseconds
+     */
+    constexpr int LOG_WRITE_INTERVAL_MS = 5;
 
-ENGINE_API void Logger::SaveLogToFile() 
-{
-    std::ofstream file(filePath, std::ios::trunc); 
+    const char* const LogPrefixes[] = { "LOG: [", "WARN: [", "ERR: [" };
+    const char* const LogColors[] = { "\x1B[32m", "\x1B[33m", "\x1B[91m" };
 
-    if (!file.is_open()) 
+    int64_t GetTicks()
     {
-        throw std::runtime_error("Failed to open file for writing: " + filePath);
+        return std::chrono::steady_clock::now().time_since_epoch().count();
     }
 
-    for (const auto& logEntry : messages) 
+    /**
+     * Bounded multi-producer ring buffer (Vyukov): a record is ready for the producer claiming
+     * position p when its sequence is p, and for the writer when its sequence is p + 1. Producers
+     * claim positions with a compare-exchange, never a lock, and the single writer reads them in
+     * order.
+     */
+    class LogWriter
     {
-        file << logEntry.message << std::endl;
-    }
+    public:
+        LogWriter()
+            : records(new LogRecord[LOG_BUFFER_SIZE])
+        {
+            for (size_t i = 0; i < LOG_BUFFER_SIZE; i++)
+            {
+                records[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            startTicks = GetTicks();
+            startTime = std::chrono::system_clock::now();
+            history.resize(Logger::HISTORY_SIZE);
+
+            isRunning = true;
+            thread = std::thread(&LogWriter::Loop, this);
+        }
+
+        LogRecord* Claim()
+        {
+            uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                LogRecord& record = records[position & (LOG_BUFFER_SIZE - 1)];
+                const uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+                const int64_t difference = static_cast<int64_t>(sequence - position);
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        return &record;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                else
+                {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * The claimed position is the current sequence of the record
+         */
+        void Publish(LogRecord* record)
+        {
+            const uint64_t position = record->sequence.load(std::memory_order_relaxed);
+            const bool isUrgent = record->type == LOG_ERROR;
+            record->sequence.store(position + 1, std::memory_order_release);
+
+            // errors go out at once, the rest waits for the writer to wake up unless the buffer fills up
+            if (isUrgent || position - dequeuePosition.load(std::memory_order_relaxed) > LOG_BUFFER_SIZE / 2)
+            {
+                condition.notify_one();
+            }
+        }
+
+        /**
+         * Blocks until the records claimed so far are written
+         */
+        void Flush()
+        {
+            const uint64_t target = enqueuePosition.load(std::memory_order_acquire);
+            std::unique_lock<std::mutex> lock(mutex);
+            isFlushRequested = true;
+            condition.notify_one();
+            flushCondition.wait(lock, [this, target] { return writtenPosition >= target || !isRunning; });
+        }
+
+        /**
+         * Writes what is left and joins the writer, at exit
+         */
+        void Stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!isRunning)
+                {
+                    return;
+                }
+                isStopping = true;
+            }
+            condition.notify_one();
+            thread.join();
+        }
+
+        bool IsRunning() const { return isRunning; }
+
+        void GetHistory(std::vector<LogEntry>& outEntries)
+        {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            outEntries.clear();
+            const size_t numEntries = std::min(historyCount, history.size());
+            for (size_t i = historyCount - numEntries; i < historyCount; i++)
+            {
+                outEntries.push_back(history[i % history.size()]);
+            }
+        }
+
+        uint64_t GetDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+        /**
+         * Writes the published records on the calling thread, once the writer is stopped
+         */
+        void WriteNow()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            WriteRecords();
+        }
+
+    private:
+        void Loop()
+        {
+            file.open(filePath, std::ios::trunc);
+            if (!file.is_open())
+            {
+                std::cerr << "Failed to open the log file " << filePath << ", logging to the console only" << std::endl;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                lock.unlock();
+                const bool hasWritten = WriteRecords();
+                lock.lock();
+
+                if (hasWritten || isFlushRequested)
+                {
+                    writtenPosition = dequeuePosition.load(std::memory_order_relaxed);
+                    isFlushRequested = false;
+                    flushCondition.notify_all();
+                }
+
+                if (isStopping && !HasRecord())
+                {
+                    break;
+                }
+                if (!HasRecord())
+                {
+                    condition.wait_for(lock, std::chrono::milliseconds(LOG_WRITE_INTERVAL_MS));
+                }
+            }
+
+            isRunning = false;
+            flushCondition.notify_all();
+        }
+
+        bool HasRecord() const
+        {
+            const uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+            return records[position & (LOG_BUFFER_SIZE - 1)].sequence.load(std::memory_order_acquire) == position + 1;
+        }
+
+        /**
+         * Formats every ready record, then flushes the console and the file once for the batch
+         */
+        bool WriteRecords()
+        {
+            bool hasWritten = false;
+            const uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+            if (dropped != reportedDropCount)
+            {
+                WriteLine(LOG_WARNING, FormatLine(LOG_WARNING, GetTicks(), std::to_string(dropped - reportedDropCount) + " log messages dropped, the log buffer was full"));
+                reportedDropCount = dropped;
+                hasWritten = true;
+            }
+
+            while (HasRecord())
+            {
+                const uint64_t position = dequeuePosition.load(std::memory_order_relaxed);
+                LogRecord& record = records[position & (LOG_BUFFER_SIZE - 1)];
+                const LogType type = record.type;
+                std::string line = FormatRecord(record);
+                record.sequence.store(position + LOG_BUFFER_SIZE, std::memory_order_release);
+                dequeuePosition.store(position + 1, std::memory_order_relaxed);
+
+                WriteLine(type, line);
+                hasWritten = true;
+            }
+
+            if (hasWritten)
+            {
+                std::cout.flush();
+                file.flush();
+            }
+            return hasWritten;
+        }
+
+        void WriteLine(LogType type, const std::string& line)
+        {
+            if (type == LOG_ERROR)
+            {
+                // keep the order of the lines between the two streams
+                std::cout.flush();
+                std::cerr << LogColors[type] << line << "\033[0m\n";
+            }
+            else
+            {
+                std::cout << LogColors[type] << line << "\033[0m\n";
+            }
+
+            if (file.is_open())
+            {
+                file << line << '\n';
+            }
+
+            std::lock_guard<std::mutex> lock(historyMutex);
+            LogEntry& entry = history[historyCount % history.size()];
+            entry.type = type;
+            entry.message = line;
+            historyCount++;
+        }
+
+        std::string FormatRecord(LogRecord& record)
+        {
+            std::string message;
+            const unsigned char* payload = record.payload;
+            int arg = 0;
+
+            for (const char* character = record.format; *character; character++)
+            {
+                if (character[0] != '{' || character[1] != '}')
+                {
+                    message += *character;
+                    continue;
+                }
+                character++;
+
+                if (arg == record.numArgs)
+                {
+                    continue;
+                }
+
+                switch (record.argTypes[arg++])
+                {
+                    case ELA_Int:
+                    {
+                        int64_t value;
+                        std::memcpy(&value, payload, sizeof(value));
+                        payload += sizeof(value);
+                        message += std::to_string(value);
+                        break;
+                    }
+                    case ELA_UInt:
+                    {
+                        uint64_t value;
+                        std::memcpy(&value, payload, sizeof(value));
+                        payload += sizeof(value);
+                        message += std::to_string(value);
+                        break;
+                    }
+                    case ELA_Double:
+                    {
+                        double value;
+                        std::memcpy(&value, payload, sizeof(value));
+                        payload += sizeof(value);
+                        message += std::to_string(value);
+                        break;
+                    }
+                    case ELA_String:
+                    {
+                        uint16_t length;
+                        std::memcpy(&length, payload, sizeof(length));
+                        payload += sizeof(length);
+                        message.append(reinterpret_cast<const char*>(payload), length);
+                        payload += length;
+                        break;
+                    }
+                    case ELA_HeapString:
+                    {
+                        char* text;
+                        std::memcpy(&text, payload, sizeof(text));
+                        payload += sizeof(text);
+                        message += text;
+                        delete[] text;
+                        break;
+                    }
+                }
+            }
+
+            // arguments beyond the last "{}" are not written, their heap strings are still freed
+            for (; arg < record.numArgs; arg++)
+            {
+                if (record.argTypes[arg] == ELA_String)
+                {
+                    uint16_t length;
+                    std::memcpy(&length, payload, sizeof(length));
+                    payload += sizeof(length) + length;
+                }
+                else if (record.argTypes[arg] == ELA_HeapString)
+                {
+                    char* text;
+                    std::memcpy(&text, payload, sizeof(text));
+                    payload += sizeof(text);
+                    delete[] text;
+                }
+                else
+                {
+                    // integers and doubles are all stored on 8 bytes
+                    payload += sizeof(uint64_t);
+                }
+            }
+
+            return FormatLine(record.type, record.ticks, message);
+        }
 
-    file.close();
+        std::string FormatLine(LogType type, int64_t ticks, const std::string& message)
+        {
+            return LogPrefixes[type] + GetTimeString(ticks) + "]: " + message;
+        }
+
+        /**
+         * Wall clock time of a steady clock time, strftime only runs when the second changes
+         */
+        const std::string& GetTimeString(int64_t ticks)
+        {
+            const auto elapsed = std::chrono::steady_clock::duration(ticks - startTicks);
+            const std::time_t time = std::chrono::system_clock::to_time_t(startTime + std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed));
+            if (time != cachedTime)
+            {
+                std::tm localTime = {};
+#if defined(_WIN32) || defined(_WIN64)
+                localtime_s(&localTime, &time);
+#else
+                localtime_r(&time, &localTime);
+#endif
+                char text[32];
+                std::strftime(text, sizeof(text), "%d-%b-%Y %H:%M:%S", &localTime);
+                cachedTimeString = text;
+                cachedTime = time;
+            }
+            return cachedTimeString;
+        }
+
+        std::unique_ptr<LogRecord[]> records;
+        std::atomic<uint64_t> enqueuePosition { 0 };
+        std::atomic<uint64_t> dequeuePosition { 0 };
+        std::atomic<uint64_t> droppedCount { 0 };
+        uint64_t reportedDropCount = 0;
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::condition_variable flushCondition;
+        std::atomic<bool> isRunning { false };
+        bool isStopping = false;
+        bool isFlushRequested = false;
+        uint64_t writtenPosition = 0;
+
+        /** Written by the writer thread only */
+        std::ofstream file;
+        const std::string filePath = "log.txt";
+        int64_t startTicks = 0;
+        std::chrono::system_clock::time_point startTime;
+        std::time_t cachedTime = -1;
+        std::string cachedTimeString;
+
+        std::mutex historyMutex;
+        std::vector<LogEntry> history;
+        size_t historyCount = 0;
+    };
+
+    /**
+     * Started by the first message and never destroyed, messages logged by static destructors
+     * are written by the caller once the writer is stopped at exit
+     */
+    LogWriter& GetWriter()
+    {
+        static LogWriter* writer = []()
+        {
+            LogWriter* newWriter = new LogWriter();
+            std::atexit([]() { GetWriter().Stop(); });
+            return newWriter;
+        }();
+        return *writer;
+    }
 }
 
-/**
- * Retrieves the current date and time as a formatted string.
- *
- * @return A string representing the current date and time in the format "DD-MMM-YYYY HH:MM:SS".
- */
-ENGINE_API std::string CurrentDateTimeToString()
+ENGINE_API LogRecord* Logger::BeginRecord(LogType type, const char* format)
 {
-    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    std::string output(30, '\0');
-    std::strftime(&output[0], output.size(), "%d-%b-%Y %H:%M:%S", std::localtime(&now));
-    return output;
+    LogRecord* record = GetWriter().Claim();
+    if (record)
+    {
+        record->ticks = GetTicks();
+        record->format = format;
+        record->type = type;
+        record->numArgs = 0;
+        record->payloadSize = 0;
+    }
+    return record;
 }
 
-/**
- * Logs an informational message to the console in green color.
- *
- * @param message The informational message to log.
- */
-ENGINE_API void Logger::Log(const std::string& message) 
+ENGINE_API void Logger::EndRecord(LogRecord* record)
 {
-    LogEntry logEntry;
-    logEntry.type = LOG_INFO;
-    logEntry.message = "LOG: [" + CurrentDateTimeToString() + "]: " + message;
-    std::cout << "\x1B[32m" << logEntry.message << "\033[0m" << std::endl;
-
-    messages.push_back(logEntry);
+    LogWriter& writer = GetWriter();
+    writer.Publish(record);
+    if (!writer.IsRunning())
+    {
+        writer.WriteNow();
+    }
 }
 
 /**
- * Logs a warning message to the console in yellow color.
- *
- * @param message The warning message to log.
+ * Copies the string in the payload, a string too long for it is copied on the heap
  */
-ENGINE_API void Logger::Warn(const std::string& message) 
+ENGINE_API void Logger::AddString(LogRecord& record, const char* text, size_t length)
 {
-    LogEntry logEntry;
-    logEntry.type = LOG_WARNING;
-    logEntry.message = "WARN: [" + CurrentDateTimeToString() + "]: " + message;
-    messages.push_back(logEntry);
+    if (record.numArgs == LogRecord::MAX_ARGS)
+    {
+        return;
+    }
+
+    if (record.payloadSize + sizeof(uint16_t) + length <= LogRecord::PAYLOAD_SIZE)
+    {
+        const uint16_t stringLength = static_cast<uint16_t>(length);
+        record.argTypes[record.numArgs++] = ELA_String;
+        std::memcpy(record.payload + record.payloadSize, &stringLength, sizeof(stringLength));
+        std::memcpy(record.payload + record.payloadSize + sizeof(stringLength), text, length);
+        record.payloadSize += static_cast<uint16_t>(sizeof(stringLength) + length);
+        return;
+    }
+
+    if (record.payloadSize + sizeof(char*) > LogRecord::PAYLOAD_SIZE)
+    {
+        return;
+    }
 
-    std::cout << "\x1B[33m" << logEntry.message << "\033[0m" << std::endl;
+    char* copy = new char[length + 1];
+    std::memcpy(copy, text, length);
+    copy[length] = '\0';
+    AddValue(record, ELA_HeapString, copy);
 }
 
-/**
- * Logs an error message to the console in red color.
- *
- * @param message The error message to log.
- */
-ENGINE_API void Logger::Err(const std::string& message) 
+ENGINE_API void Logger::SaveLogToFile()
 {
-    LogEntry logEntry;
-    logEntry.type = LOG_ERROR;
-    logEntry.message = "ERR: [" + CurrentDateTimeToString() + "]: " + message;
-
-    messages.push_back(logEntry);
-    std::cerr << "\x1B[91m"<< logEntry.message << "\033[0m" << std::endl;
+    GetWriter().Flush();
 }
 
+ENGINE_API void Logger::GetHistory(std::vector<LogEntry>& outEntries)
+{
+    GetWriter().GetHistory(outEntries);
+}
 
+ENGINE_API uint64_t Logger::GetDroppedCount()
+{
+    return GetWriter().GetDroppedCount();
+}
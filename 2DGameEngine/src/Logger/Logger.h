@@ -1,7 +1,12 @@
 #ifndef LOGGER_H
 #define LOGGER_H
-#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -31,7 +36,7 @@
 /**
  * Enum representing the type of log entry.
  */
-enum ENGINE_API LogType 
+enum ENGINE_API LogType
 {
     LOG_INFO,      /**< Informational log entry */
     LOG_WARNING,   /**< Warning log entry */
@@ -41,52 +46,182 @@ enum ENGINE_API LogType
 /**
  * Struct representing a single log entry with a type and message.
  */
-struct ENGINE_API ALIGN(16) LogEntry 
+struct ENGINE_API ALIGN(16) LogEntry
 {
     LogType type;                /**< Type of log entry */
     std::string message;         /**< Message content of the log entry */
 };
 
+/**
+ * Type of an argument stored in a log record.
+ */
+enum ELogArgType : uint8_t
+{
+    ELA_Int,
+    ELA_UInt,
+    ELA_Double,
+    ELA_String,         /**< Length (uint16_t) followed by the characters, in the payload */
+    ELA_HeapString      /**< Pointer to a copy too long for the payload, freed by the writer */
+};
+
+/**
+ * Fixed-size slot of the log ring buffer. The producer only copies the format pointer and the
+ * raw arguments, the message is formatted by the writer thread.
+ */
+struct ENGINE_API ALIGN(64) LogRecord
+{
+    static constexpr int MAX_ARGS = 8;
+    static constexpr size_t PAYLOAD_SIZE = 192;
+
+    std::atomic<uint64_t> sequence;     /**< Position the slot is ready for, see Logger.cpp */
+    int64_t ticks;                      /**< steady_clock time of the call */
+    const char* format;                 /**< String literal, "{}" is replaced by the next argument */
+    LogType type;
+    uint8_t numArgs;
+    uint8_t argTypes[MAX_ARGS];
+    uint16_t payloadSize;
+    unsigned char payload[PAYLOAD_SIZE];
+};
+
 /**
  * Logger class responsible for managing and outputting log messages.
+ *
+ * Logging only fills a fixed-size record of a lock-free ring buffer: the format string is a
+ * literal kept by pointer, the arguments are copied raw and the time is a steady clock read.
+ * A writer thread formats the records, with a wall clock string cached per second, writes them to
+ * the console and to the log file and keeps the last messages in a bounded history. When the
+ * buffer is full, records are dropped rather than blocking the caller, and the number dropped is
+ * reported.
+ *
+ *   Logger::Log("Entity created with id = {}", entityId);
+ *
+ * Messages built as strings still work, the string is copied in the record.
  */
-class ENGINE_API Logger 
+class ENGINE_API Logger
 {
     public:
         /**
-         * Static list of all log entries recorded.
+         * Messages kept by GetHistory.
          */
-        ENGINE_API static std::vector<LogEntry> messages;
+        static constexpr size_t HISTORY_SIZE = 1024;
 
         /**
          * Logs an informational message.
          *
          * @param message The message to log as an informational entry.
          */
-        ENGINE_API static void Log(const std::string& message);
-        
+        ENGINE_API static void Log(const std::string& message) { Write(LOG_INFO, "{}", message); }
+
+        /**
+         * Logs an informational message formatted by the writer thread.
+         *
+         * @param format String literal, each "{}" is replaced by the next argument.
+         * @param args Integers, floating point numbers or strings, copied in the record.
+         */
+        template <size_t N, typename... TArgs>
+        static void Log(const char (&format)[N], const TArgs&... args) { Write(LOG_INFO, format, args...); }
+
         /**
         * Logs a warning message to the console in yellow color.
         *
         * @param message The warning message to log.
         */
-        ENGINE_API static void Warn(const std::string& message);
+        ENGINE_API static void Warn(const std::string& message) { Write(LOG_WARNING, "{}", message); }
+
+        template <size_t N, typename... TArgs>
+        static void Warn(const char (&format)[N], const TArgs&... args) { Write(LOG_WARNING, format, args...); }
 
         /**
-         * Logs an error message.
+         * Logs an error message, written out at once rather than with the next batch.
          *
          * @param message The message to log as an error entry.
          */
-        ENGINE_API static void Err(const std::string& message);
+        ENGINE_API static void Err(const std::string& message) { Write(LOG_ERROR, "{}", message); }
+
+        template <size_t N, typename... TArgs>
+        static void Err(const char (&format)[N], const TArgs&... args) { Write(LOG_ERROR, format, args...); }
 
         /**
-         * Static function from save log file in project  folder
+         * Waits until every message logged so far is written to the console and to the log file.
          */
         ENGINE_API static void SaveLogToFile();
 
+        /**
+         * Copies the last HISTORY_SIZE messages written, oldest first.
+         */
+        ENGINE_API static void GetHistory(std::vector<LogEntry>& outEntries);
+
+        /**
+         * Messages dropped since the start because the ring buffer was full.
+         */
+        ENGINE_API static uint64_t GetDroppedCount();
 
 private:
-    ENGINE_API ALIGN(16) static std::string filePath;
+    template <typename... TArgs>
+    static void Write(LogType type, const char* format, const TArgs&... args)
+    {
+        LogRecord* record = BeginRecord(type, format);
+        if (!record)
+        {
+            return;
+        }
+        (AddArg(*record, args), ...);
+        EndRecord(record);
+    }
+
+    /**
+     * Claims a record of the ring buffer, nullptr when it is full
+     */
+    ENGINE_API static LogRecord* BeginRecord(LogType type, const char* format);
+
+    /**
+     * Hands the filled record to the writer thread
+     */
+    ENGINE_API static void EndRecord(LogRecord* record);
+
+    ENGINE_API static void AddString(LogRecord& record, const char* text, size_t length);
+
+    template <typename T>
+    static void AddArg(LogRecord& record, const T& value)
+    {
+        if constexpr (std::is_convertible_v<const T&, const char*>)
+        {
+            const char* text = value;
+            AddString(record, text ? text : "(null)", text ? std::strlen(text) : 6);
+        }
+        else if constexpr (std::is_same_v<T, std::string>)
+        {
+            AddString(record, value.data(), value.size());
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            AddValue(record, ELA_Double, static_cast<double>(value));
+        }
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            AddValue(record, ELA_Int, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            AddValue(record, ELA_UInt, static_cast<uint64_t>(value));
+        }
+        else
+        {
+            static_assert(std::is_integral_v<T>, "Log arguments are numbers or strings");
+        }
+    }
+
+    template <typename TValue>
+    static void AddValue(LogRecord& record, ELogArgType argType, TValue value)
+    {
+        if (record.numArgs == LogRecord::MAX_ARGS || record.payloadSize + sizeof(value) > LogRecord::PAYLOAD_SIZE)
+        {
+            return;
+        }
+        record.argTypes[record.numArgs++] = argType;
+        std::memcpy(record.payload + record.payloadSize, &value, sizeof(value));
+        record.payloadSize += sizeof(value);
+    }
 };
 
 #endif
@@ -0,0 +1,216 @@
+#include "DebugDraw.h"
+#include <cmath>
+
+namespace
+{
+    constexpr double TWO_PI = 2.0 * 3.14159265358979323846;
+
+    bool IsSameColor(const SDL_Color& a, const SDL_Color& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+}
+
+void DebugDraw::DrawLine(int x1, int y1, int x2, int y2, SDL_Color color)
+{
+    ColorBatch& batch = GetBatch(color);
+    batch.lines.push_back(SDL_Point{ x1, y1 });
+    batch.lines.push_back(SDL_Point{ x2, y2 });
+    numPrimitives++;
+}
+
+void DebugDraw::DrawRect(const SDL_Rect& rect, SDL_Color color)
+{
+    GetBatch(color).rects.push_back(rect);
+    numPrimitives++;
+}
+
+void DebugDraw::FillRect(const SDL_Rect& rect, SDL_Color color)
+{
+    if (rect.w <= 0 || rect.h <= 0) return;
+
+    GetBatch(color).filledRects.push_back(rect);
+    numPrimitives++;
+}
+
+void DebugDraw::DrawCircle(int centerX, int centerY, int radius, SDL_Color color, int segments)
+{
+    if (radius <= 0 || segments < 3) return;
+
+    ColorBatch& batch = GetBatch(color);
+
+    SDL_Point previous = { centerX + radius, centerY };
+    for (int i = 1; i <= segments; i++)
+    {
+        const double angle = TWO_PI * i / segments;
+        const SDL_Point point =
+        {
+            centerX + static_cast<int>(std::lround(radius * std::cos(angle))),
+            centerY + static_cast<int>(std::lround(radius * std::sin(angle)))
+        };
+        batch.lines.push_back(previous);
+        batch.lines.push_back(point);
+        previous = point;
+    }
+    numPrimitives++;
+}
+
+void DebugDraw::FillCircle(int centerX, int centerY, int radius, SDL_Color color)
+{
+    if (radius <= 0) return;
+
+    ColorBatch& batch = GetBatch(color);
+
+    for (int dy = -radius; dy < radius; dy++)
+    {
+        // half width of the row through the pixel centers
+        const double y = dy + 0.5;
+        const int halfWidth = static_cast<int>(std::sqrt(static_cast<double>(radius) * radius - y * y) + 0.5);
+        if (halfWidth > 0)
+        {
+            batch.filledRects.push_back(SDL_Rect{ centerX - halfWidth, centerY + dy, halfWidth * 2, 1 });
+        }
+    }
+    numPrimitives++;
+}
+
+/**
+ * Submits the filled rectangles and the outlines color by color, then every line of every color
+ * as 1 pixel wide quads in one SDL_RenderGeometry call, the color going in the vertices.
+ */
+void DebugDraw::Flush(SDL_Renderer* renderer)
+{
+    stats = DebugDrawStats();
+    stats.primitives = numPrimitives;
+
+    Uint8 r, g, b, a;
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+    for (const auto& batch : batches)
+    {
+        if (batch.filledRects.empty()) continue;
+
+        SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+        SDL_RenderFillRects(renderer, batch.filledRects.data(), static_cast<int>(batch.filledRects.size()));
+        stats.drawCalls++;
+    }
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    lineVertices.clear();
+    lineIndices.clear();
+
+    for (const auto& batch : batches)
+    {
+        for (size_t i = 0; i + 1 < batch.lines.size(); i += 2)
+        {
+            // quad around the segment through the pixel centers, half a pixel on each side
+            const float x1 = batch.lines[i].x + 0.5f;
+            const float y1 = batch.lines[i].y + 0.5f;
+            const float x2 = batch.lines[i + 1].x + 0.5f;
+            const float y2 = batch.lines[i + 1].y + 0.5f;
+
+            float dx = x2 - x1;
+            float dy = y2 - y1;
+            const float length = std::sqrt(dx * dx + dy * dy);
+            if (length > 0.0f)
+            {
+                dx /= length;
+                dy /= length;
+            }
+            else
+            {
+                dx = 1.0f;
+                dy = 0.0f;
+            }
+
+            // extend the ends by half a pixel so the end points are covered like with SDL_RenderDrawLine
+            const float normalX = -dy * 0.5f;
+            const float normalY = dx * 0.5f;
+            const float startX = x1 - dx * 0.5f;
+            const float startY = y1 - dy * 0.5f;
+            const float endX = x2 + dx * 0.5f;
+            const float endY = y2 + dy * 0.5f;
+
+            const int firstVertex = static_cast<int>(lineVertices.size());
+            const float cornerX[4] = { startX + normalX, endX + normalX, endX - normalX, startX - normalX };
+            const float cornerY[4] = { startY + normalY, endY + normalY, endY - normalY, startY - normalY };
+            for (int corner = 0; corner < 4; corner++)
+            {
+                SDL_Vertex vertex;
+                vertex.position.x = cornerX[corner];
+                vertex.position.y = cornerY[corner];
+                vertex.color = batch.color;
+                vertex.tex_coord.x = 0.0f;
+                vertex.tex_coord.y = 0.0f;
+                lineVertices.push_back(vertex);
+            }
+
+            lineIndices.push_back(firstVertex + 0);
+            lineIndices.push_back(firstVertex + 1);
+            lineIndices.push_back(firstVertex + 2);
+            lineIndices.push_back(firstVertex + 0);
+            lineIndices.push_back(firstVertex + 2);
+            lineIndices.push_back(firstVertex + 3);
+        }
+    }
+
+    if (!lineVertices.empty())
+    {
+        SDL_RenderGeometry(renderer, NULL, lineVertices.data(), static_cast<int>(lineVertices.size()),
+            lineIndices.data(), static_cast<int>(lineIndices.size()));
+        stats.drawCalls++;
+    }
+#else
+    // SDL_RenderGeometry needs SDL 2.0.18, fall back to one call per line
+    for (const auto& batch : batches)
+    {
+        if (batch.lines.empty()) continue;
+
+        SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+        for (size_t i = 0; i + 1 < batch.lines.size(); i += 2)
+        {
+            SDL_RenderDrawLine(renderer, batch.lines[i].x, batch.lines[i].y, batch.lines[i + 1].x, batch.lines[i + 1].y);
+            stats.drawCalls++;
+        }
+    }
+#endif
+
+    for (const auto& batch : batches)
+    {
+        if (batch.rects.empty()) continue;
+
+        SDL_SetRenderDrawColor(renderer, batch.color.r, batch.color.g, batch.color.b, batch.color.a);
+        SDL_RenderDrawRects(renderer, batch.rects.data(), static_cast<int>(batch.rects.size()));
+        stats.drawCalls++;
+    }
+
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+
+    // clear keeps the capacity, so steady-state frames do not allocate
+    for (auto& batch : batches)
+    {
+        batch.rects.clear();
+        batch.filledRects.clear();
+        batch.lines.clear();
+    }
+    numPrimitives = 0;
+}
+
+DebugDraw::ColorBatch& DebugDraw::GetBatch(SDL_Color color)
+{
+    for (auto& batch : batches)
+    {
+        if (IsSameColor(batch.color, color))
+        {
+            return batch;
+        }
+    }
+
+    batches.emplace_back();
+    batches.back().color = color;
+    return batches.back();
+}
@@ -0,0 +1,79 @@
+#ifndef DEBUGDRAW_H
+#define DEBUGDRAW_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+/**
+ * Draw calls issued by the last Flush.
+ */
+struct DebugDrawStats
+{
+    int drawCalls = 0;          /**< Number of SDL render calls */
+    int primitives = 0;         /**< Number of lines, rects and circles drawn */
+};
+
+/**
+ * Immediate-mode buffer of debug primitives, usable by any system.
+ *
+ * Draw functions only record the primitive in per-color arrays, Flush submits them with one
+ * SDL_RenderFillRects and one SDL_RenderDrawRects call per color and a single SDL_RenderGeometry
+ * call for all the lines, instead of a color change and a draw call per primitive.
+ *
+ * Within a flush, filled shapes are drawn first, then lines, then outlined rectangles.
+ */
+class DebugDraw
+{
+public:
+    DebugDraw() = default;
+
+    void DrawLine(int x1, int y1, int x2, int y2, SDL_Color color);
+    void DrawRect(const SDL_Rect& rect, SDL_Color color);
+    void FillRect(const SDL_Rect& rect, SDL_Color color);
+
+    /**
+     * Outlines a circle with a polygon of the given number of segments.
+     */
+    void DrawCircle(int centerX, int centerY, int radius, SDL_Color color, int segments = DEFAULT_CIRCLE_SEGMENTS);
+
+    /**
+     * Fills a circle with one horizontal span per pixel row.
+     */
+    void FillCircle(int centerX, int centerY, int radius, SDL_Color color);
+
+    /**
+     * Draws the recorded primitives and empties the buffer, keeping its capacity.
+     */
+    void Flush(SDL_Renderer* renderer);
+
+    const DebugDrawStats& GetStats() const { return stats; }
+
+    static constexpr int DEFAULT_CIRCLE_SEGMENTS = 24;
+
+private:
+    /**
+     * Primitives sharing a color
+     */
+    struct ColorBatch
+    {
+        SDL_Color color;
+        std::vector<SDL_Rect> rects;
+        std::vector<SDL_Rect> filledRects;
+        std::vector<SDL_Point> lines;       // two points per line
+    };
+
+    ColorBatch& GetBatch(SDL_Color color);
+
+    /**
+     * Batches of the colors used so far, a handful at most, found by linear search
+     */
+    std::vector<ColorBatch> batches;
+    int numPrimitives = 0;
+
+    std::vector<SDL_Vertex> lineVertices;
+    std::vector<int> lineIndices;
+
+    DebugDrawStats stats;
+};
+
+#endif
@@ -0,0 +1,79 @@
+#include "RenderProfiler.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+int RenderProfiler::AddSection(const std::string& name)
+{
+    RenderSectionTiming timing;
+    timing.name = name;
+    timings.push_back(timing);
+    sectionStarts.push_back(0);
+    return static_cast<int>(timings.size()) - 1;
+}
+
+void RenderProfiler::BeginSection(int section)
+{
+    sectionStarts[section] = SDL_GetPerformanceCounter();
+}
+
+void RenderProfiler::EndSection(int section)
+{
+    const Uint64 elapsed = SDL_GetPerformanceCounter() - sectionStarts[section];
+    const double elapsedMs = elapsed * 1000.0 / SDL_GetPerformanceFrequency();
+
+    RenderSectionTiming& timing = timings[section];
+    timing.minMs = timing.samples == 0 ? elapsedMs : std::min(timing.minMs, elapsedMs);
+    timing.maxMs = timing.samples == 0 ? elapsedMs : std::max(timing.maxMs, elapsedMs);
+    timing.totalMs += elapsedMs;
+    timing.lastMs = elapsedMs;
+    timing.samples++;
+}
+
+void RenderProfiler::LogReport() const
+{
+    for (const auto& timing : timings)
+    {
+        if (timing.samples == 0) continue;
+
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3) << timing.name
+             << ": avg " << timing.totalMs / timing.samples << " ms"
+             << ", min " << timing.minMs << " ms"
+             << ", max " << timing.maxMs << " ms"
+             << " over " << timing.samples << " frames";
+        Logger::Log(line.str());
+    }
+}
+
+bool RenderProfiler::WriteReport(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open())
+    {
+        Logger::Err("Error writing render timings: " + filePath);
+        return false;
+    }
+
+    file << "section,samples,avg_ms,min_ms,max_ms,total_ms\n";
+    file << std::fixed << std::setprecision(4);
+    for (const auto& timing : timings)
+    {
+        const double average = timing.samples > 0 ? timing.totalMs / timing.samples : 0.0;
+        file << timing.name << "," << timing.samples << "," << average << ","
+             << timing.minMs << "," << timing.maxMs << "," << timing.totalMs << "\n";
+    }
+    return true;
+}
+
+void RenderProfiler::Reset()
+{
+    for (auto& timing : timings)
+    {
+        const std::string name = timing.name;
+        timing = RenderSectionTiming();
+        timing.name = name;
+    }
+}
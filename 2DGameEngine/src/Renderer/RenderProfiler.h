@@ -0,0 +1,57 @@
+#ifndef RENDERPROFILER_H
+#define RENDERPROFILER_H
+
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+
+/**
+ * Accumulated timing of one section of the frame.
+ */
+struct RenderSectionTiming
+{
+    std::string name;
+    int samples = 0;
+    double totalMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+    double lastMs = 0.0;
+};
+
+/**
+ * Measures the time spent in named sections of the render, one section per render system,
+ * with the high resolution performance counter.
+ */
+class RenderProfiler
+{
+public:
+    /**
+     * Registers a section and returns its id, used by BeginSection/EndSection.
+     */
+    int AddSection(const std::string& name);
+
+    void BeginSection(int section);
+    void EndSection(int section);
+
+    const std::vector<RenderSectionTiming>& GetTimings() const { return timings; }
+
+    /**
+     * Logs the average, minimum and maximum time of every section.
+     */
+    void LogReport() const;
+
+    /**
+     * Writes the timings as CSV: section, samples, average, minimum, maximum and total milliseconds.
+     *
+     * @return false if the file could not be written.
+     */
+    bool WriteReport(const std::string& filePath) const;
+
+    void Reset();
+
+private:
+    std::vector<RenderSectionTiming> timings;
+    std::vector<Uint64> sectionStarts;
+};
+
+#endif
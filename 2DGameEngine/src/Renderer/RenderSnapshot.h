@@ -0,0 +1,81 @@
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <SDL2/SDL.h>
+#include "SDL2/SDL_ttf.h"
+
+/**
+ * Sprite ready to draw, its texture region resolved and its source rectangle in the texture.
+ */
+struct SpriteDraw
+{
+    SDL_Texture* texture = nullptr;
+    SDL_Rect srcRect;
+    glm::vec2 position;         /**< World position, screen position for fixed sprites */
+    glm::vec2 size;             /**< Size on screen, scale applied */
+    double rotation = 0.0;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    bool isFixed = false;
+};
+
+struct TextDraw
+{
+    TTF_Font* font = nullptr;   /**< Null while the font is loading */
+    std::string text;
+    glm::vec2 position;
+    SDL_Color color;
+    bool isFixed = false;
+};
+
+struct HealthBarDraw
+{
+    glm::vec2 position;         /**< World position of the top-left corner of the bar */
+    int healthPercentage = 0;
+};
+
+struct ColliderCircleDraw
+{
+    glm::vec2 center;
+    int radius = 0;
+};
+
+/**
+ * Everything the render systems need to draw one frame, copied out of the registry at the end
+ * of the simulation so the frame can be rendered while the registry moves on to the next one.
+ *
+ * A snapshot is only written by the simulation and only read by the renderer, never both at
+ * the same time. Clear keeps the capacity of the arrays so steady-state frames do not allocate.
+ */
+struct RenderSnapshot
+{
+    SDL_Rect camera = { 0, 0, 0, 0 };
+
+    /**
+     * Sprites inside the camera view, in draw order
+     */
+    std::vector<SpriteDraw> sprites;
+    std::vector<TextDraw> texts;
+    std::vector<HealthBarDraw> healthBars;
+    TTF_Font* healthLabelFont = nullptr;
+
+    /**
+     * Collider outlines, only captured in debug mode
+     */
+    std::vector<SDL_FRect> colliderBoxes;
+    std::vector<ColliderCircleDraw> colliderCircles;
+
+    void Clear()
+    {
+        sprites.clear();
+        texts.clear();
+        healthBars.clear();
+        healthLabelFont = nullptr;
+        colliderBoxes.clear();
+        colliderCircles.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "SpriteBatcher.h"
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr double DEGREES_TO_RADIANS = 3.14159265358979323846 / 180.0;
+}
+
+void SpriteBatcher::Begin(SDL_Renderer* renderer)
+{
+    this->renderer = renderer;
+    currentTexture = nullptr;
+    numQuads = 0;
+    stats = SpriteBatchStats();
+}
+
+void SpriteBatcher::Draw(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    if (texture != currentTexture)
+    {
+        Flush();
+        currentTexture = texture;
+
+        int textureWidth = 1;
+        int textureHeight = 1;
+        SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+        inverseTextureWidth = 1.0f / (textureWidth > 0 ? textureWidth : 1);
+        inverseTextureHeight = 1.0f / (textureHeight > 0 ? textureHeight : 1);
+    }
+
+    float u0 = srcRect.x * inverseTextureWidth;
+    float v0 = srcRect.y * inverseTextureHeight;
+    float u1 = (srcRect.x + srcRect.w) * inverseTextureWidth;
+    float v1 = (srcRect.y + srcRect.h) * inverseTextureHeight;
+
+    if (flip & SDL_FLIP_HORIZONTAL) std::swap(u0, u1);
+    if (flip & SDL_FLIP_VERTICAL) std::swap(v0, v1);
+
+    // Corners relative to the center of the destination, rotated clockwise like SDL_RenderCopyEx
+    const float halfWidth = dstRect.w * 0.5f;
+    const float halfHeight = dstRect.h * 0.5f;
+    const float centerX = dstRect.x + halfWidth;
+    const float centerY = dstRect.y + halfHeight;
+
+    float cosAngle = 1.0f;
+    float sinAngle = 0.0f;
+    if (angle != 0.0)
+    {
+        const double radians = angle * DEGREES_TO_RADIANS;
+        cosAngle = static_cast<float>(std::cos(radians));
+        sinAngle = static_cast<float>(std::sin(radians));
+    }
+
+    const float cornerX[4] = { -halfWidth, halfWidth, halfWidth, -halfWidth };
+    const float cornerY[4] = { -halfHeight, -halfHeight, halfHeight, halfHeight };
+    const float cornerU[4] = { u0, u1, u1, u0 };
+    const float cornerV[4] = { v0, v0, v1, v1 };
+
+    const int firstVertex = static_cast<int>(vertices.size());
+    for (int i = 0; i < 4; i++)
+    {
+        SDL_Vertex vertex;
+        vertex.position.x = centerX + cornerX[i] * cosAngle - cornerY[i] * sinAngle;
+        vertex.position.y = centerY + cornerX[i] * sinAngle + cornerY[i] * cosAngle;
+        vertex.color = color;
+        vertex.tex_coord.x = cornerU[i];
+        vertex.tex_coord.y = cornerV[i];
+        vertices.push_back(vertex);
+    }
+
+    indices.push_back(firstVertex + 0);
+    indices.push_back(firstVertex + 1);
+    indices.push_back(firstVertex + 2);
+    indices.push_back(firstVertex + 0);
+    indices.push_back(firstVertex + 2);
+    indices.push_back(firstVertex + 3);
+
+    numQuads++;
+    stats.sprites++;
+#else
+    // SDL_RenderGeometry needs SDL 2.0.18, fall back to one draw call per sprite
+    SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(texture, color.a);
+    SDL_RenderCopyEx(renderer, texture, &srcRect, &dstRect, angle, NULL, flip);
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    stats.batches++;
+    stats.sprites++;
+#endif
+}
+
+void SpriteBatcher::Flush()
+{
+    if (numQuads == 0 || !renderer) return;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    SDL_RenderGeometry(
+        renderer,
+        currentTexture,
+        vertices.data(),
+        static_cast<int>(vertices.size()),
+        indices.data(),
+        static_cast<int>(indices.size()));
+#endif
+
+    stats.batches++;
+    stats.vertices += static_cast<int>(vertices.size());
+
+    // clear keeps the capacity, so steady-state frames do not allocate
+    vertices.clear();
+    indices.clear();
+    numQuads = 0;
+}
+
+void SpriteBatcher::End()
+{
+    Flush();
+    currentTexture = nullptr;
+}
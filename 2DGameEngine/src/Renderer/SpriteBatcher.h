@@ -0,0 +1,74 @@
+#ifndef SPRITEBATCHER_H
+#define SPRITEBATCHER_H
+
+#include <vector>
+#include <SDL2/SDL.h>
+
+/**
+ * Draw statistics of the last frame, used to verify the draw call reduction.
+ */
+struct SpriteBatchStats
+{
+    int batches = 0;        /**< Number of SDL_RenderGeometry calls */
+    int sprites = 0;        /**< Number of quads submitted */
+    int vertices = 0;       /**< Number of vertices submitted */
+};
+
+/**
+ * Accumulates rotated/flipped sprite quads in vertex and index arrays and submits them
+ * with one SDL_RenderGeometry call per run of sprites sharing the same texture.
+ *
+ * Sprites have to be submitted in draw order: a texture change flushes the current batch,
+ * so the fewer texture switches the render queue produces, the fewer draw calls are issued.
+ */
+class SpriteBatcher
+{
+public:
+    SpriteBatcher() = default;
+
+    /**
+     * Starts a new frame of batches and resets the statistics.
+     *
+     * @param renderer The SDL_Renderer the batches are flushed to.
+     */
+    void Begin(SDL_Renderer* renderer);
+
+    /**
+     * Adds a sprite to the current batch, flushing it first if the texture changes.
+     * Same parameters as SDL_RenderCopyEx with the rotation around the center of dstRect.
+     *
+     * @param texture The texture of the sprite.
+     * @param srcRect The source rectangle in the texture, in pixels.
+     * @param dstRect The destination rectangle on the screen.
+     * @param angle The rotation in degrees, clockwise.
+     * @param flip The flip of the sprite.
+     * @param color The color the texture is modulated with, white to draw it unchanged.
+     */
+    void Draw(SDL_Texture* texture, const SDL_Rect& srcRect, const SDL_Rect& dstRect, double angle, SDL_RendererFlip flip, SDL_Color color = SDL_Color{255, 255, 255, 255});
+
+    /**
+     * Submits the current batch.
+     */
+    void Flush();
+
+    /**
+     * Submits the last batch of the frame.
+     */
+    void End();
+
+    const SpriteBatchStats& GetStats() const { return stats; }
+
+private:
+    SDL_Renderer* renderer = nullptr;
+    SDL_Texture* currentTexture = nullptr;
+    float inverseTextureWidth = 1.0f;
+    float inverseTextureHeight = 1.0f;
+
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+    int numQuads = 0;
+
+    SpriteBatchStats stats;
+};
+
+#endif
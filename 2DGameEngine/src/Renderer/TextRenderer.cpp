@@ -0,0 +1,279 @@
+#include "TextRenderer.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cstdint>
+
+TextRenderer::~TextRenderer()
+{
+    Clear();
+}
+
+void TextRenderer::Begin(SDL_Renderer* renderer)
+{
+    this->renderer = renderer;
+    batcher.Begin(renderer);
+}
+
+void TextRenderer::DrawText(TTF_Font* font, const std::string& text, int x, int y, SDL_Color color)
+{
+    if (!font || text.empty())
+    {
+        return;
+    }
+
+    GlyphAtlas& atlas = GetAtlas(font);
+    if (!atlas.texture || !atlas.surface)
+    {
+        return;
+    }
+
+    int penX = x;
+    int penY = y;
+    for (const char character : text)
+    {
+        if (character == '\n')
+        {
+            penX = x;
+            penY += TTF_FontHeight(font);
+            continue;
+        }
+
+        // the glyph may grow the atlas, so its texture is read after it
+        const Glyph& glyph = GetGlyph(atlas, font, static_cast<unsigned char>(character));
+        if (glyph.rect.w > 0 && glyph.rect.h > 0)
+        {
+            const SDL_Rect dstRect = { penX, penY, glyph.rect.w, glyph.rect.h };
+            batcher.Draw(atlas.texture, glyph.rect, dstRect, 0.0, SDL_FLIP_NONE, color);
+        }
+        penX += glyph.advance;
+    }
+}
+
+void TextRenderer::DrawCachedText(TTF_Font* font, const std::string& text, int x, int y, SDL_Color color)
+{
+    if (!font || text.empty())
+    {
+        return;
+    }
+
+    const std::string key = MakeCacheKey(font, text, color);
+    const auto it = cachedTextsByKey.find(key);
+
+    if (it != cachedTextsByKey.end())
+    {
+        // most recently drawn strings stay at the front of the list
+        cachedTexts.splice(cachedTexts.begin(), cachedTexts, it->second);
+        stats.cacheHits++;
+    }
+    else
+    {
+        SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), color);
+        if (!surface)
+        {
+            Logger::Err("Error rendering text: " + text);
+            return;
+        }
+
+        CachedText cachedText;
+        cachedText.key = key;
+        cachedText.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        cachedText.width = surface->w;
+        cachedText.height = surface->h;
+        SDL_FreeSurface(surface);
+
+        if (!cachedText.texture)
+        {
+            Logger::Err("Error creating texture for text: " + text);
+            return;
+        }
+
+        cachedTexts.push_front(cachedText);
+        cachedTextsByKey.emplace(key, cachedTexts.begin());
+        stats.cacheMisses++;
+        stats.texturesCreated++;
+
+        while (cachedTexts.size() > cacheCapacity)
+        {
+            ReleaseLeastRecentlyUsed();
+        }
+    }
+
+    const CachedText& cachedText = cachedTexts.front();
+    const SDL_Rect srcRect = { 0, 0, cachedText.width, cachedText.height };
+    const SDL_Rect dstRect = { x, y, cachedText.width, cachedText.height };
+    batcher.Draw(cachedText.texture, srcRect, dstRect, 0.0, SDL_FLIP_NONE);
+}
+
+void TextRenderer::End()
+{
+    batcher.End();
+}
+
+void TextRenderer::Clear()
+{
+    for (auto& atlas : atlases)
+    {
+        SDL_DestroyTexture(atlas.second.texture);
+        SDL_FreeSurface(atlas.second.surface);
+    }
+    atlases.clear();
+
+    for (auto& cachedText : cachedTexts)
+    {
+        SDL_DestroyTexture(cachedText.texture);
+    }
+    cachedTexts.clear();
+    cachedTextsByKey.clear();
+}
+
+void TextRenderer::SetCacheCapacity(size_t capacity)
+{
+    cacheCapacity = capacity > 0 ? capacity : 1;
+    while (cachedTexts.size() > cacheCapacity)
+    {
+        ReleaseLeastRecentlyUsed();
+    }
+}
+
+TextRenderer::GlyphAtlas& TextRenderer::GetAtlas(TTF_Font* font)
+{
+    const auto it = atlases.find(font);
+    if (it != atlases.end())
+    {
+        return it->second;
+    }
+
+    GlyphAtlas& atlas = atlases[font];
+    atlas.surface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_INITIAL_SIZE, ATLAS_INITIAL_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    atlas.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, ATLAS_INITIAL_SIZE, ATLAS_INITIAL_SIZE);
+
+    if (!atlas.surface || !atlas.texture)
+    {
+        Logger::Err("Error creating glyph atlas");
+        return atlas;
+    }
+
+    SDL_SetTextureBlendMode(atlas.texture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(atlas.texture, NULL, atlas.surface->pixels, atlas.surface->pitch);
+    stats.texturesCreated++;
+    return atlas;
+}
+
+/**
+ * Rasterizes the glyph in white the first time it is drawn and copies it in the next free spot of
+ * the atlas rows, only that rectangle of the texture is updated.
+ */
+const TextRenderer::Glyph& TextRenderer::GetGlyph(GlyphAtlas& atlas, TTF_Font* font, Uint16 character)
+{
+    if (character >= atlas.glyphs.size())
+    {
+        atlas.glyphs.resize(character + 1);
+    }
+
+    Glyph& glyph = atlas.glyphs[character];
+    if (glyph.isLoaded)
+    {
+        return glyph;
+    }
+    glyph.isLoaded = true;
+
+    int minX, maxX, minY, maxY;
+    if (TTF_GlyphMetrics(font, character, &minX, &maxX, &minY, &maxY, &glyph.advance) != 0)
+    {
+        return glyph;
+    }
+
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, character, SDL_Color{255, 255, 255, 255});
+    SDL_Surface* surface = rendered ? SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0) : nullptr;
+    SDL_FreeSurface(rendered);
+    if (!surface)
+    {
+        return glyph;
+    }
+
+    // start a new row when the glyph does not fit in the current one, grow the atlas when out of rows
+    if (atlas.penX + surface->w + GLYPH_PADDING > atlas.surface->w)
+    {
+        atlas.penX = 0;
+        atlas.penY += atlas.rowHeight;
+        atlas.rowHeight = 0;
+    }
+    while (atlas.penY + surface->h + GLYPH_PADDING > atlas.surface->h || surface->w + GLYPH_PADDING > atlas.surface->w)
+    {
+        if (!GrowAtlas(atlas))
+        {
+            Logger::Err("Glyph atlas is full");
+            SDL_FreeSurface(surface);
+            return glyph;
+        }
+    }
+
+    glyph.rect = { atlas.penX, atlas.penY, surface->w, surface->h };
+    atlas.penX += surface->w + GLYPH_PADDING;
+    atlas.rowHeight = std::max(atlas.rowHeight, surface->h + GLYPH_PADDING);
+
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    SDL_Rect dstRect = glyph.rect;
+    SDL_BlitSurface(surface, NULL, atlas.surface, &dstRect);
+    SDL_FreeSurface(surface);
+
+    const Uint8* pixels = static_cast<const Uint8*>(atlas.surface->pixels) + glyph.rect.y * atlas.surface->pitch + glyph.rect.x * 4;
+    SDL_UpdateTexture(atlas.texture, &glyph.rect, pixels, atlas.surface->pitch);
+    stats.glyphsRasterized++;
+    return glyph;
+}
+
+/**
+ * Doubles the atlas size, the glyphs keep their position so their rectangles stay valid.
+ */
+bool TextRenderer::GrowAtlas(GlyphAtlas& atlas)
+{
+    const int size = atlas.surface->w * 2;
+    if (size > ATLAS_MAX_SIZE)
+    {
+        return false;
+    }
+
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
+    if (!surface || !texture)
+    {
+        SDL_FreeSurface(surface);
+        SDL_DestroyTexture(texture);
+        return false;
+    }
+
+    SDL_SetSurfaceBlendMode(atlas.surface, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(atlas.surface, NULL, surface, NULL);
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(texture, NULL, surface->pixels, surface->pitch);
+
+    // the glyphs already queued use the old texture, submit them before it goes away
+    batcher.End();
+
+    SDL_DestroyTexture(atlas.texture);
+    SDL_FreeSurface(atlas.surface);
+    atlas.texture = texture;
+    atlas.surface = surface;
+    stats.texturesCreated++;
+    return true;
+}
+
+void TextRenderer::ReleaseLeastRecentlyUsed()
+{
+    // the released texture may be the one of the pending batch
+    batcher.End();
+
+    CachedText& cachedText = cachedTexts.back();
+    SDL_DestroyTexture(cachedText.texture);
+    cachedTextsByKey.erase(cachedText.key);
+    cachedTexts.pop_back();
+}
+
+std::string TextRenderer::MakeCacheKey(TTF_Font* font, const std::string& text, SDL_Color color)
+{
+    const uint32_t packedColor = (static_cast<uint32_t>(color.r) << 24) | (static_cast<uint32_t>(color.g) << 16) |
+                                 (static_cast<uint32_t>(color.b) << 8) | static_cast<uint32_t>(color.a);
+
+    return std::to_string(reinterpret_cast<uintptr_t>(font)) + ":" + std::to_string(packedColor) + ":" + text;
+}
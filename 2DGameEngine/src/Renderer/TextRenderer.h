@@ -0,0 +1,134 @@
+#ifndef TEXTRENDERER_H
+#define TEXTRENDERER_H
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "SDL2/SDL_ttf.h"
+#include "SpriteBatcher.h"
+
+/**
+ * Rasterization work of the text renderer, steady-state frames should keep these at zero.
+ */
+struct TextRenderStats
+{
+    int glyphsRasterized = 0;       /**< Glyphs added to a glyph atlas */
+    int texturesCreated = 0;        /**< Textures created, glyph atlases and cached strings */
+    int cacheHits = 0;              /**< Strings drawn from the cache */
+    int cacheMisses = 0;            /**< Strings rendered into a new cached texture */
+};
+
+/**
+ * Draws text without rasterizing it every frame.
+ *
+ * DrawText lays out glyph quads from a glyph atlas built lazily per font (a TTF_Font is opened
+ * for one size, so a font is a (font, size) pair) and submits them through a SpriteBatcher,
+ * the text color being the vertex color of the white glyphs. It suits text that changes often.
+ *
+ * DrawCachedText renders the whole string once with TTF_RenderText_Blended and keeps the texture
+ * in an LRU cache keyed by (font, text, color). It suits static labels, drawn with one quad.
+ */
+class TextRenderer
+{
+public:
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = 128;
+
+    TextRenderer() = default;
+    ~TextRenderer();
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    /**
+     * Starts a frame of text, the statistics keep counting until ResetStats.
+     */
+    void Begin(SDL_Renderer* renderer);
+
+    /**
+     * Draws a text from the glyph atlas of the font, rasterizing only the glyphs never drawn before.
+     */
+    void DrawText(TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+
+    /**
+     * Draws a text from its cached texture, created on the first draw of the (font, text, color).
+     */
+    void DrawCachedText(TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+
+    /**
+     * Submits the glyphs of the frame.
+     */
+    void End();
+
+    /**
+     * Releases the glyph atlases and the cached strings, has to be called when the fonts are closed.
+     */
+    void Clear();
+
+    /**
+     * Maximum number of cached string textures, the least recently drawn are released first.
+     */
+    void SetCacheCapacity(size_t capacity);
+    size_t GetCacheSize() const { return cachedTexts.size(); }
+
+    const TextRenderStats& GetStats() const { return stats; }
+    void ResetStats() { stats = TextRenderStats(); }
+
+private:
+    struct Glyph
+    {
+        SDL_Rect rect = { 0, 0, 0, 0 };
+        int advance = 0;
+        bool isLoaded = false;
+    };
+
+    /**
+     * Glyphs of one font packed in rows in a texture, mirrored in a surface so the texture
+     * can be grown without reading it back
+     */
+    struct GlyphAtlas
+    {
+        SDL_Texture* texture = nullptr;
+        SDL_Surface* surface = nullptr;
+        int penX = 0;
+        int penY = 0;
+        int rowHeight = 0;
+        std::vector<Glyph> glyphs;
+    };
+
+    struct CachedText
+    {
+        std::string key;
+        SDL_Texture* texture = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    GlyphAtlas& GetAtlas(TTF_Font* font);
+    const Glyph& GetGlyph(GlyphAtlas& atlas, TTF_Font* font, Uint16 character);
+    bool GrowAtlas(GlyphAtlas& atlas);
+    void ReleaseLeastRecentlyUsed();
+
+    static std::string MakeCacheKey(TTF_Font* font, const std::string& text, SDL_Color color);
+
+    static constexpr int ATLAS_INITIAL_SIZE = 256;
+    static constexpr int ATLAS_MAX_SIZE = 4096;
+    static constexpr int GLYPH_PADDING = 1;
+
+    SDL_Renderer* renderer = nullptr;
+    SpriteBatcher batcher;
+
+    std::unordered_map<TTF_Font*, GlyphAtlas> atlases;
+
+    /**
+     * Cached strings, most recently drawn first, and their position in the list by key
+     */
+    std::list<CachedText> cachedTexts;
+    std::unordered_map<std::string, std::list<CachedText>::iterator> cachedTextsByKey;
+    size_t cacheCapacity = DEFAULT_CACHE_CAPACITY;
+
+    TextRenderStats stats;
+};
+
+#endif
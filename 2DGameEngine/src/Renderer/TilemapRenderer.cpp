@@ -0,0 +1,458 @@
+#include "TilemapRenderer.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <cmath>
+
+TilemapRenderer::~TilemapRenderer()
+{
+    DestroyChunks();
+}
+
+void TilemapRenderer::Reset(int numCols, int numRows, int tileSize, float scale, const std::string& textureAssetId, int tilesetCols, int chunkTiles)
+{
+    Clear();
+
+    this->numCols = std::max(numCols, 0);
+    this->numRows = std::max(numRows, 0);
+    this->tileSize = tileSize;
+    this->scale = scale;
+    this->textureAssetId = textureAssetId;
+    this->tilesetCols = std::max(tilesetCols, 1);
+    this->chunkTiles = std::max(chunkTiles, 1);
+
+    numChunkCols = (this->numCols + this->chunkTiles - 1) / this->chunkTiles;
+    numChunkRows = (this->numRows + this->chunkTiles - 1) / this->chunkTiles;
+    tiles.assign(static_cast<size_t>(this->numCols) * this->numRows, EMPTY_TILE);
+}
+
+void TilemapRenderer::SetTile(int col, int row, uint16_t tileIndex)
+{
+    if (col < 0 || row < 0 || col >= numCols || row >= numRows)
+    {
+        return;
+    }
+
+    tiles[static_cast<size_t>(row) * numCols + col] = tileIndex;
+}
+
+void TilemapRenderer::AddDecoration(const std::string& assetID, const SDL_Rect& srcRect, const SDL_FRect& dstRect, int zIndex, double angle, SDL_RendererFlip flip)
+{
+    decorations.push_back({ assetID, TextureHandle(), srcRect, dstRect, zIndex, angle, flip });
+}
+
+/**
+ * Creates one render target per chunk and draws its tiles and decorations into it. Chunks are baked
+ * at the world resolution, so they are copied without scaling and decorations keep their detail.
+ * The previous render target of the renderer is restored afterwards.
+ *
+ * A map over the chunk budget only gets ready to be streamed, its chunks are baked by UpdateStreaming.
+ */
+bool TilemapRenderer::Bake(SDL_Renderer* renderer, AssetManager& assetManager)
+{
+    DestroyChunks();
+    ReleaseTextures();
+    fallbackAssetManager = &assetManager;
+
+    // resolve the texture handles once, every chunk then draws with array lookups, the
+    // references keep the textures resident for the next bake and the tile by tile fallback
+    tilesetTexture = assetManager.GetTextureHandle(textureAssetId);
+    assetManager.AcquireTexture(tilesetTexture);
+    for (auto& decoration : decorations)
+    {
+        decoration.texture = assetManager.GetTextureHandle(decoration.assetID);
+        assetManager.AcquireTexture(decoration.texture);
+    }
+
+    // decorations of the same z-index keep the order they were added in
+    std::stable_sort(decorations.begin(), decorations.end(), [](const Decoration& a, const Decoration& b)
+    {
+        return a.zIndex < b.zIndex;
+    });
+    SortDecorationsByChunk();
+
+    if (!SDL_RenderTargetSupported(renderer))
+    {
+        Logger::Err("Render targets are not supported, the tilemap is drawn tile by tile");
+        return false;
+    }
+
+    chunks.assign(static_cast<size_t>(numChunkCols) * numChunkRows, nullptr);
+    stats.chunks = static_cast<int>(chunks.size());
+
+    // the chunks partition the map, so the whole map takes the memory of one texture of its size
+    const size_t drawTileSize = static_cast<size_t>(tileSize * scale);
+    const size_t mapBytes = static_cast<size_t>(numCols) * numRows * drawTileSize * drawTileSize * 4;
+    isStreamed = chunkBudget > 0 && mapBytes > chunkBudget;
+    if (isStreamed)
+    {
+        isBaked = true;
+        Logger::Log("Tilemap of " + std::to_string(mapBytes / (1024 * 1024)) + " MB streamed in " + std::to_string(chunks.size()) +
+            " chunks of " + std::to_string(chunkTiles) + "x" + std::to_string(chunkTiles) + " tiles");
+        return true;
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+
+    for (int chunkRow = 0; chunkRow < numChunkRows; chunkRow++)
+    {
+        for (int chunkCol = 0; chunkCol < numChunkCols; chunkCol++)
+        {
+            if (!BakeChunk(renderer, chunkCol, chunkRow))
+            {
+                SDL_SetRenderTarget(renderer, previousTarget);
+                DestroyChunks();
+                return false;
+            }
+        }
+    }
+
+    SDL_SetRenderTarget(renderer, previousTarget);
+    isBaked = true;
+
+    Logger::Log("Tilemap baked in " + std::to_string(chunks.size()) + " chunks of " + std::to_string(chunkTiles) + "x" + std::to_string(chunkTiles) + " tiles");
+    return true;
+}
+
+/**
+ * The chunks the camera left behind are destroyed first, so the resident chunks stay a few
+ * around the camera whatever the map size, then the visible chunks are baked and the
+ * prefetched ones with what remains of the bakes of the update.
+ */
+void TilemapRenderer::UpdateStreaming(SDL_Renderer* renderer, const SDL_Rect& camera)
+{
+    stats.bakedChunks = 0;
+
+    if (!isBaked || !isStreamed || tileSize <= 0)
+    {
+        return;
+    }
+
+    const ChunkRange keepRange = GetChunkRange(camera, STREAM_KEEP_CHUNKS);
+    for (size_t i = 0; i < residentChunks.size();)
+    {
+        const int chunkIndex = residentChunks[i];
+        if (keepRange.Contains(chunkIndex % numChunkCols, chunkIndex / numChunkCols))
+        {
+            i++;
+            continue;
+        }
+
+        int width = 0;
+        int height = 0;
+        SDL_QueryTexture(chunks[chunkIndex], nullptr, nullptr, &width, &height);
+        stats.chunkBytes -= static_cast<size_t>(width) * height * 4;
+        stats.residentChunks--;
+
+        SDL_DestroyTexture(chunks[chunkIndex]);
+        chunks[chunkIndex] = nullptr;
+        residentChunks[i] = residentChunks.back();
+        residentChunks.pop_back();
+    }
+
+    SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+    const ChunkRange ranges[2] = { GetChunkRange(camera, 0), GetChunkRange(camera, STREAM_PREFETCH_CHUNKS) };
+    for (const auto& range : ranges)
+    {
+        for (int chunkRow = range.firstRow; chunkRow <= range.lastRow; chunkRow++)
+        {
+            for (int chunkCol = range.firstCol; chunkCol <= range.lastCol; chunkCol++)
+            {
+                if (stats.bakedChunks >= MAX_CHUNK_BAKES_PER_UPDATE || chunks[chunkRow * numChunkCols + chunkCol])
+                {
+                    continue;
+                }
+
+                if (!BakeChunk(renderer, chunkCol, chunkRow))
+                {
+                    // the chunks already baked stay, the others are drawn tile by tile
+                    Logger::Err("Tilemap streaming stopped");
+                    isStreamed = false;
+                    SDL_SetRenderTarget(renderer, previousTarget);
+                    return;
+                }
+                stats.bakedChunks++;
+            }
+        }
+    }
+
+    if (stats.bakedChunks > 0)
+    {
+        SDL_SetRenderTarget(renderer, previousTarget);
+    }
+}
+
+void TilemapRenderer::Render(SDL_Renderer* renderer, const SDL_Rect& camera)
+{
+    stats.visibleChunks = 0;
+
+    if (numChunkCols == 0 || numChunkRows == 0 || tileSize <= 0)
+    {
+        return;
+    }
+
+    const int drawTileSize = static_cast<int>(tileSize * scale);
+    const int chunkWorldSize = chunkTiles * drawTileSize;
+    const ChunkRange visibleRange = GetChunkRange(camera, 0);
+
+    for (int chunkRow = visibleRange.firstRow; chunkRow <= visibleRange.lastRow; chunkRow++)
+    {
+        for (int chunkCol = visibleRange.firstCol; chunkCol <= visibleRange.lastCol; chunkCol++)
+        {
+            const SDL_Rect chunkTilesRect = GetChunkTiles(chunkCol, chunkRow);
+            const SDL_Rect dstRect =
+            {
+                chunkCol * chunkWorldSize - camera.x,
+                chunkRow * chunkWorldSize - camera.y,
+                chunkTilesRect.w * drawTileSize,
+                chunkTilesRect.h * drawTileSize
+            };
+
+            SDL_Texture* chunk = isBaked ? chunks[chunkRow * numChunkCols + chunkCol] : nullptr;
+            if (chunk)
+            {
+                SDL_RenderCopy(renderer, chunk, nullptr, &dstRect);
+            }
+            else if (fallbackAssetManager)
+            {
+                // decorations crossing the chunk border must not be drawn twice
+                SDL_RenderSetClipRect(renderer, &dstRect);
+                DrawChunk(renderer, *fallbackAssetManager, chunkCol, chunkRow, static_cast<float>(dstRect.x), static_cast<float>(dstRect.y));
+                SDL_RenderSetClipRect(renderer, nullptr);
+            }
+
+            stats.visibleChunks++;
+        }
+    }
+}
+
+void TilemapRenderer::Clear()
+{
+    DestroyChunks();
+    ReleaseTextures();
+    tiles.clear();
+    decorations.clear();
+    chunkDecorationStarts.clear();
+    chunkDecorations.clear();
+    numCols = numRows = 0;
+    numChunkCols = numChunkRows = 0;
+    fallbackAssetManager = nullptr;
+}
+
+void TilemapRenderer::ReleaseTextures()
+{
+    if (!fallbackAssetManager)
+    {
+        return;
+    }
+
+    fallbackAssetManager->ReleaseTexture(tilesetTexture);
+    tilesetTexture = TextureHandle();
+    for (auto& decoration : decorations)
+    {
+        fallbackAssetManager->ReleaseTexture(decoration.texture);
+        decoration.texture = TextureHandle();
+    }
+}
+
+void TilemapRenderer::DestroyChunks()
+{
+    for (auto chunk : chunks)
+    {
+        SDL_DestroyTexture(chunk);
+    }
+    chunks.clear();
+    residentChunks.clear();
+    isBaked = false;
+    isStreamed = false;
+    stats = TilemapRenderStats();
+}
+
+bool TilemapRenderer::BakeChunk(SDL_Renderer* renderer, int chunkCol, int chunkRow)
+{
+    const SDL_Rect chunkTilesRect = GetChunkTiles(chunkCol, chunkRow);
+    const int drawTileSize = static_cast<int>(tileSize * scale);
+    const int width = chunkTilesRect.w * drawTileSize;
+    const int height = chunkTilesRect.h * drawTileSize;
+    SDL_Texture* chunk = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+
+    if (!chunk || SDL_SetRenderTarget(renderer, chunk) != 0)
+    {
+        Logger::Err("Error creating tilemap chunk: " + std::string(SDL_GetError()));
+        SDL_DestroyTexture(chunk);
+        return false;
+    }
+
+    SDL_SetTextureBlendMode(chunk, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    DrawChunk(renderer, *fallbackAssetManager, chunkCol, chunkRow, 0.0f, 0.0f);
+
+    const int chunkIndex = chunkRow * numChunkCols + chunkCol;
+    chunks[chunkIndex] = chunk;
+    residentChunks.push_back(chunkIndex);
+    stats.residentChunks++;
+    stats.chunkBytes += static_cast<size_t>(width) * height * 4;
+    return true;
+}
+
+/**
+ * Counts the decorations of every chunk, then fills the lists in decoration order, so a chunk
+ * only goes through the decorations it shows.
+ */
+void TilemapRenderer::SortDecorationsByChunk()
+{
+    const size_t numChunks = static_cast<size_t>(numChunkCols) * numChunkRows;
+    chunkDecorationStarts.assign(numChunks + 1, 0);
+    chunkDecorations.clear();
+
+    const float chunkWorldSize = static_cast<float>(chunkTiles * static_cast<int>(tileSize * scale));
+    if (numChunks == 0 || chunkWorldSize <= 0.0f)
+    {
+        return;
+    }
+
+    const auto getDecorationChunks = [&](const Decoration& decoration)
+    {
+        const SDL_FRect& bounds = decoration.dstRect;
+        return ChunkRange
+        {
+            std::max(0, static_cast<int>(std::floor(bounds.x / chunkWorldSize))),
+            std::max(0, static_cast<int>(std::floor(bounds.y / chunkWorldSize))),
+            std::min(numChunkCols - 1, static_cast<int>(std::ceil((bounds.x + bounds.w) / chunkWorldSize)) - 1),
+            std::min(numChunkRows - 1, static_cast<int>(std::ceil((bounds.y + bounds.h) / chunkWorldSize)) - 1)
+        };
+    };
+
+    for (const auto& decoration : decorations)
+    {
+        const ChunkRange range = getDecorationChunks(decoration);
+        for (int chunkRow = range.firstRow; chunkRow <= range.lastRow; chunkRow++)
+        {
+            for (int chunkCol = range.firstCol; chunkCol <= range.lastCol; chunkCol++)
+            {
+                chunkDecorationStarts[chunkRow * numChunkCols + chunkCol + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < numChunks; i++)
+    {
+        chunkDecorationStarts[i + 1] += chunkDecorationStarts[i];
+    }
+
+    chunkDecorations.resize(chunkDecorationStarts[numChunks]);
+    std::vector<int> nextSlots(chunkDecorationStarts.begin(), chunkDecorationStarts.end() - 1);
+    for (size_t i = 0; i < decorations.size(); i++)
+    {
+        const ChunkRange range = getDecorationChunks(decorations[i]);
+        for (int chunkRow = range.firstRow; chunkRow <= range.lastRow; chunkRow++)
+        {
+            for (int chunkCol = range.firstCol; chunkCol <= range.lastCol; chunkCol++)
+            {
+                chunkDecorations[nextSlots[chunkRow * numChunkCols + chunkCol]++] = static_cast<int>(i);
+            }
+        }
+    }
+}
+
+TilemapRenderer::ChunkRange TilemapRenderer::GetChunkRange(const SDL_Rect& camera, int margin) const
+{
+    const int chunkWorldSize = chunkTiles * static_cast<int>(tileSize * scale);
+    if (chunkWorldSize <= 0)
+    {
+        return ChunkRange{ 0, 0, -1, -1 };
+    }
+
+    return ChunkRange
+    {
+        std::max(0, camera.x / chunkWorldSize - margin),
+        std::max(0, camera.y / chunkWorldSize - margin),
+        std::min(numChunkCols - 1, (camera.x + camera.w) / chunkWorldSize + margin),
+        std::min(numChunkRows - 1, (camera.y + camera.h) / chunkWorldSize + margin)
+    };
+}
+
+void TilemapRenderer::DrawChunk(SDL_Renderer* renderer, AssetManager& assetManager, int chunkCol, int chunkRow, float originX, float originY)
+{
+    const SDL_Rect chunkTilesRect = GetChunkTiles(chunkCol, chunkRow);
+    const int drawTileSize = static_cast<int>(tileSize * scale);
+
+    const TextureRegion& tileset = assetManager.GetTextureRegion(tilesetTexture);
+    if (tileset.texture)
+    {
+        for (int row = chunkTilesRect.y; row < chunkTilesRect.y + chunkTilesRect.h; row++)
+        {
+            for (int col = chunkTilesRect.x; col < chunkTilesRect.x + chunkTilesRect.w; col++)
+            {
+                const uint16_t tile = tiles[static_cast<size_t>(row) * numCols + col];
+                if (tile == EMPTY_TILE)
+                {
+                    continue;
+                }
+
+                const SDL_Rect srcRect =
+                {
+                    tileset.rect.x + (tile % tilesetCols) * tileSize,
+                    tileset.rect.y + (tile / tilesetCols) * tileSize,
+                    tileSize,
+                    tileSize
+                };
+                const SDL_Rect dstRect =
+                {
+                    static_cast<int>(originX) + (col - chunkTilesRect.x) * drawTileSize,
+                    static_cast<int>(originY) + (row - chunkTilesRect.y) * drawTileSize,
+                    drawTileSize,
+                    drawTileSize
+                };
+                SDL_RenderCopy(renderer, tileset.texture, &srcRect, &dstRect);
+            }
+        }
+    }
+
+    // decorations are placed in world coordinates, bring them to the chunk space
+    const float chunkX = static_cast<float>(chunkTilesRect.x * drawTileSize);
+    const float chunkY = static_cast<float>(chunkTilesRect.y * drawTileSize);
+    const float chunkW = static_cast<float>(chunkTilesRect.w * drawTileSize);
+    const float chunkH = static_cast<float>(chunkTilesRect.h * drawTileSize);
+
+    const int chunkIndex = chunkRow * numChunkCols + chunkCol;
+    for (int i = chunkDecorationStarts[chunkIndex]; i < chunkDecorationStarts[chunkIndex + 1]; i++)
+    {
+        const Decoration& decoration = decorations[chunkDecorations[i]];
+        const SDL_FRect& bounds = decoration.dstRect;
+        if (bounds.x + bounds.w <= chunkX || bounds.x >= chunkX + chunkW || bounds.y + bounds.h <= chunkY || bounds.y >= chunkY + chunkH)
+        {
+            continue;
+        }
+
+        const TextureRegion& region = assetManager.GetTextureRegion(decoration.texture);
+        if (!region.texture)
+        {
+            continue;
+        }
+
+        const SDL_Rect srcRect =
+        {
+            region.rect.x + decoration.srcRect.x,
+            region.rect.y + decoration.srcRect.y,
+            decoration.srcRect.w,
+            decoration.srcRect.h
+        };
+        const SDL_Rect dstRect =
+        {
+            static_cast<int>(originX + bounds.x - chunkX),
+            static_cast<int>(originY + bounds.y - chunkY),
+            static_cast<int>(bounds.w),
+            static_cast<int>(bounds.h)
+        };
+        SDL_RenderCopyEx(renderer, region.texture, &srcRect, &dstRect, decoration.angle, nullptr, decoration.flip);
+    }
+}
+
+SDL_Rect TilemapRenderer::GetChunkTiles(int chunkCol, int chunkRow) const
+{
+    const int col = chunkCol * chunkTiles;
+    const int row = chunkRow * chunkTiles;
+    return SDL_Rect{ col, row, std::min(chunkTiles, numCols - col), std::min(chunkTiles, numRows - row) };
+}
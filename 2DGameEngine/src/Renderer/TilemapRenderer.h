@@ -0,0 +1,242 @@
+#ifndef TILEMAPRENDERER_H
+#define TILEMAPRENDERER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include "../AssetManager/AssetHandle.h"
+
+class AssetManager;
+
+/**
+ * Draw statistics of the last frame.
+ */
+struct TilemapRenderStats
+{
+    int chunks = 0;             /**< Number of chunks of the map */
+    int visibleChunks = 0;      /**< Number of chunks overlapping the camera */
+    int residentChunks = 0;     /**< Number of chunks baked in a texture */
+    int bakedChunks = 0;        /**< Chunks baked by the last streaming update */
+    size_t chunkBytes = 0;      /**< Texture memory of the resident chunks */
+};
+
+/**
+ * Renders the level tilemap without one entity per tile.
+ *
+ * The tiles are stored in a plain grid and baked once, at load time, into fixed-size chunk
+ * textures (render targets). Every frame only the chunks overlapping the camera are drawn,
+ * one copy per chunk. Static decoration sprites can be baked into the same chunks.
+ *
+ * A map whose chunks do not fit in the chunk budget is streamed instead: Bake creates no chunk,
+ * UpdateStreaming bakes the chunks around the camera, a few per frame, and destroys the ones the
+ * camera left behind. A visible chunk not baked yet is drawn tile by tile until it is.
+ *
+ * When the renderer does not support render targets the tiles of the visible chunks are
+ * drawn one by one instead.
+ */
+class TilemapRenderer
+{
+public:
+    /**
+     * Width and height of a chunk, in tiles
+     */
+    static constexpr int DEFAULT_CHUNK_TILES = 16;
+
+    /**
+     * Texture memory of the chunks above which the map is streamed, in bytes
+     */
+    static constexpr size_t DEFAULT_CHUNK_BUDGET = 128 * 1024 * 1024;
+
+    /**
+     * Tile index of a tile without tile
+     */
+    static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+    TilemapRenderer() = default;
+    ~TilemapRenderer();
+
+    TilemapRenderer(const TilemapRenderer&) = delete;
+    TilemapRenderer& operator=(const TilemapRenderer&) = delete;
+
+    /**
+     * Releases the chunks and sets up an empty map.
+     *
+     * @param numCols Number of tile columns of the map.
+     * @param numRows Number of tile rows of the map.
+     * @param tileSize Size of a tile in the tileset texture, in pixels.
+     * @param scale Scale applied to the tiles when drawn in the world.
+     * @param textureAssetId Asset id of the tileset texture.
+     * @param tilesetCols Number of tile columns of the tileset texture.
+     * @param chunkTiles Width and height of a chunk, in tiles.
+     */
+    void Reset(int numCols, int numRows, int tileSize, float scale, const std::string& textureAssetId, int tilesetCols, int chunkTiles = DEFAULT_CHUNK_TILES);
+
+    /**
+     * Sets the tile drawn at (col, row), the tile index being row * tilesetCols + column of the
+     * tile in the tileset, EMPTY_TILE for none.
+     */
+    void SetTile(int col, int row, uint16_t tileIndex);
+
+    /**
+     * Adds a static sprite drawn over the tiles, baked in every chunk it overlaps.
+     * Decorations are drawn by z-index, then in the order they were added.
+     *
+     * @param assetID The texture of the sprite.
+     * @param srcRect The source rectangle in the texture.
+     * @param dstRect The destination rectangle in world coordinates.
+     * @param zIndex The z-index of the sprite.
+     * @param angle The rotation in degrees, clockwise.
+     * @param flip The flip of the sprite.
+     */
+    void AddDecoration(const std::string& assetID, const SDL_Rect& srcRect, const SDL_FRect& dstRect, int zIndex, double angle, SDL_RendererFlip flip);
+
+    /**
+     * Renders the tiles and the decorations into the chunk textures, replacing the previous ones.
+     * Has to be called again when the renderer loses its render targets.
+     *
+     * @return false if the chunks could not be created, the map is then drawn tile by tile.
+     */
+    bool Bake(SDL_Renderer* renderer, AssetManager& assetManager);
+
+    /**
+     * Bakes the missing chunks around the camera, the visible ones first and at most
+     * MAX_CHUNK_BAKES_PER_UPDATE, and destroys the chunks far from the camera.
+     * Does nothing unless the map is streamed.
+     */
+    void UpdateStreaming(SDL_Renderer* renderer, const SDL_Rect& camera);
+
+    /**
+     * Draws the chunks overlapping the camera.
+     */
+    void Render(SDL_Renderer* renderer, const SDL_Rect& camera);
+
+    /**
+     * Releases the chunk textures and forgets the map.
+     */
+    void Clear();
+
+    /**
+     * Texture memory the chunks of a map may take before the map is streamed, 0 for no limit.
+     * Applies from the next Bake.
+     */
+    void SetChunkBudget(size_t bytes) { chunkBudget = bytes; }
+    size_t GetChunkBudget() const { return chunkBudget; }
+
+    bool IsBaked() const { return isBaked; }
+    bool IsStreamed() const { return isStreamed; }
+    const TilemapRenderStats& GetStats() const { return stats; }
+
+private:
+    struct Decoration
+    {
+        std::string assetID;
+        TextureHandle texture;
+        SDL_Rect srcRect;
+        SDL_FRect dstRect;
+        int zIndex;
+        double angle;
+        SDL_RendererFlip flip;
+    };
+
+    /**
+     * Chunks from (firstCol, firstRow) to (lastCol, lastRow) included
+     */
+    struct ChunkRange
+    {
+        int firstCol;
+        int firstRow;
+        int lastCol;
+        int lastRow;
+
+        bool Contains(int chunkCol, int chunkRow) const
+        {
+            return chunkCol >= firstCol && chunkCol <= lastCol && chunkRow >= firstRow && chunkRow <= lastRow;
+        }
+    };
+
+    /**
+     * Chunks of streamed maps kept baked beyond the visible ones, baked ahead of the camera
+     */
+    static constexpr int STREAM_PREFETCH_CHUNKS = 1;
+
+    /**
+     * Chunks of streamed maps kept baked beyond the visible ones before being destroyed, more
+     * than the prefetched ones so going back and forth over a chunk border does not bake again
+     */
+    static constexpr int STREAM_KEEP_CHUNKS = 2;
+
+    static constexpr int MAX_CHUNK_BAKES_PER_UPDATE = 4;
+
+    /**
+     * Creates the render target of a chunk and draws it, the render target is left on the chunk
+     */
+    bool BakeChunk(SDL_Renderer* renderer, int chunkCol, int chunkRow);
+
+    void DestroyChunks();
+
+    /**
+     * Lists the decorations overlapping every chunk, in drawing order
+     */
+    void SortDecorationsByChunk();
+
+    /**
+     * Chunks overlapping the camera, extended by margin chunks on every side
+     */
+    ChunkRange GetChunkRange(const SDL_Rect& camera, int margin) const;
+
+    /**
+     * Drops the references of the last Bake to the tileset and decoration textures
+     */
+    void ReleaseTextures();
+
+    /**
+     * Draws the content of a chunk at the world scale, with the chunk origin on (originX, originY)
+     */
+    void DrawChunk(SDL_Renderer* renderer, AssetManager& assetManager, int chunkCol, int chunkRow, float originX, float originY);
+
+    SDL_Rect GetChunkTiles(int chunkCol, int chunkRow) const;
+
+    int numCols = 0;
+    int numRows = 0;
+    int tileSize = 0;
+    float scale = 1.0f;
+    int tilesetCols = 1;
+    int chunkTiles = DEFAULT_CHUNK_TILES;
+    int numChunkCols = 0;
+    int numChunkRows = 0;
+    std::string textureAssetId;
+    TextureHandle tilesetTexture;
+
+    /**
+     * Tile index of every tile, row after row
+     */
+    std::vector<uint16_t> tiles;
+    std::vector<Decoration> decorations;
+
+    /**
+     * Decorations of chunk i are chunkDecorations[chunkDecorationStarts[i]] to
+     * chunkDecorations[chunkDecorationStarts[i + 1]], excluded
+     */
+    std::vector<int> chunkDecorationStarts;
+    std::vector<int> chunkDecorations;
+
+    /**
+     * Texture of every chunk, nullptr while not baked, and the indices of the baked ones
+     */
+    std::vector<SDL_Texture*> chunks;
+    std::vector<int> residentChunks;
+    bool isBaked = false;
+    bool isStreamed = false;
+    size_t chunkBudget = DEFAULT_CHUNK_BUDGET;
+
+    /**
+     * Asset manager of the last Bake, used to draw tile by tile when baking failed and to
+     * release the texture references
+     */
+    AssetManager* fallbackAssetManager = nullptr;
+
+    TilemapRenderStats stats;
+};
+
+#endif
@@ -4,34 +4,136 @@
 #include "../ECS/ECS.h"
 #include "../Components/AnimationComponent.h"
 #include "../Components/SpriteComponent.h"
-#include "SDL2/SDL.h"
+#include "../Components/TransformComponent.h"
+#include "../AssetManager/AnimationClipTable.h"
+#include <cmath>
+#include <vector>
+#include <SDL2/SDL.h>
 
+/**
+ * AnimationSystem sets the source rectangle of the animated sprites from their clip.
+ *
+ * All the entities are evaluated against the same timestamp, once per rendered frame, in three
+ * passes: the clip parameters of the visible entities are gathered in flat arrays, the frame of
+ * every entity is computed by a branch-free loop over those arrays that the compiler can
+ * vectorize, then the frame rectangles are written back to the sprites.
+ */
 class AnimationSystem : public System
 {
+    /**
+     * Per visible entity, filled by the gather pass and reused between frames
+     */
+    std::vector<Entity> entities;
+    std::vector<float> elapsedTimes;
+    std::vector<float> frameRates;
+    std::vector<float> numFrames;
+    std::vector<int> loopModes;
+    std::vector<int> firstFrames;
+    std::vector<int> rowOffsets;
+    std::vector<int> frames;
+
 public:
     AnimationSystem()
     {
+        RequireComponent<TransformComponent>();
         RequireComponent<SpriteComponent>();
         RequireComponent<AnimationComponent>();
     }
 
-    void Update()
+    /**
+     * Shows the frame of every animated sprite inside the camera view at the given time,
+     * sprites outside keep their frame until they come back in view.
+     *
+     * @param clips The animation clips of the level.
+     * @param time Simulation time of the frame, in seconds.
+     * @param camera The camera of the frame.
+     */
+    void Update(const AnimationClipTable& clips, double time, const SDL_Rect& camera)
     {
-        for  (auto entity : GetSystemEntity())
+        entities.clear();
+        elapsedTimes.clear();
+        frameRates.clear();
+        numFrames.clear();
+        loopModes.clear();
+        firstFrames.clear();
+        rowOffsets.clear();
+
+        // gather
+        for (auto entity : GetSystemEntity())
         {
-            auto& animation = entity.GetComponent<AnimationComponent>();
-            auto& sprite = entity.GetComponent<SpriteComponent>();
+            const auto& animation = entity.GetComponent<AnimationComponent>();
+            if (animation.clipId < 0 || animation.clipId >= clips.GetNumClips())
+            {
+                continue;
+            }
+
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& sprite = entity.GetComponent<SpriteComponent>();
+            const bool isOutsideCameraView =
+            (
+                transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                transform.position.x > camera.x + camera.w ||
+                transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+                transform.position.y > camera.y + camera.h
+            );
+            if (isOutsideCameraView && !sprite.isFixed)
+            {
+                continue;
+            }
 
-            animation.currentFrame = ((SDL_GetTicks() - animation.startTime) * animation.frameSpeedRate / 1000) % animation.numFrames;
-            
-            sprite.srcRect.x = animation.currentFrame * sprite.width;
+            const AnimationClip& clip = clips.GetClip(animation.clipId);
+            entities.push_back(entity);
+            elapsedTimes.push_back(static_cast<float>(time - animation.startTime));
+            frameRates.push_back(clip.frameRate);
+            numFrames.push_back(static_cast<float>(clip.numFrames));
+            loopModes.push_back(clip.loopMode);
+            firstFrames.push_back(clip.firstFrame);
+            rowOffsets.push_back(animation.rowOffset);
+        }
 
+        // evaluate
+        const size_t count = entities.size();
+        frames.resize(count);
+        EvaluateFrames(count, elapsedTimes.data(), frameRates.data(), numFrames.data(), loopModes.data(), firstFrames.data(), frames.data());
 
+        // scatter
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& sprite = entities[i].GetComponent<SpriteComponent>();
+            sprite.srcRect = clips.GetFrame(frames[i]);
+            sprite.srcRect.y += rowOffsets[i];
         }
     }
 
+private:
+    /**
+     * Computes the index in the frame table of the frame shown by every entity. The loop modes are
+     * all computed and selected, so the loop body has no branches.
+     */
+    static void EvaluateFrames(size_t count, const float* elapsedTimes, const float* frameRates, const float* numFrames,
+        const int* loopModes, const int* firstFrames, int* outFrames)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const float n = numFrames[i];
+            const float frame = std::floor(std::fmax(elapsedTimes[i], 0.0f) * frameRates[i]);
+
+            const float loopFrame = frame - n * std::floor(frame / n);
+            const float onceFrame = std::fmin(frame, n - 1.0f);
+
+            // a ping-pong cycle goes 0 .. n-1 .. 1, 2n - 2 frames
+            const float period = std::fmax(2.0f * n - 2.0f, 1.0f);
+            const float cycleFrame = frame - period * std::floor(frame / period);
+            const float pingPongFrame = cycleFrame < n ? cycleFrame : period - cycleFrame;
 
+            const float clipFrame =
+                loopModes[i] == ALM_Once ? onceFrame :
+                loopModes[i] == ALM_PingPong ? pingPongFrame : loopFrame;
+
+            outFrames[i] = firstFrames[i] + static_cast<int>(clipFrame);
+        }
+    }
 };
 
 
-#endif
\ No newline at end of file
+#endif
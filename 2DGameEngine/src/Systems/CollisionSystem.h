@@ -6,8 +6,12 @@
 #include "../Events/CollisionEvent.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Collision/SweepAndPrune.h"
+#include "../Collision/CollisionLayerMatrix.h"
+#include "../Collision/ContactCache.h"
+#include <unordered_map>
 
-bool CheckAABBCollision(double aX, double aY, double aW, double aH, double bX, double bY, double bW, double bH)
+inline bool CheckAABBCollision(double aX, double aY, double aW, double aH, double bX, double bY, double bW, double bH)
 {
     return
     (
@@ -18,8 +22,45 @@ bool CheckAABBCollision(double aX, double aY, double aW, double aH, double bX, d
     );
 }
 
+/**
+ * Broadphase used by the CollisionSystem to find the overlapping pairs
+ */
+enum ECollisionBroadphase
+{
+    ECB_BruteForce,         // test every collider against every other one, O(n^2)
+    ECB_SweepAndPrune       // persistent sorted endpoints, cost scales with the motion between frames
+};
+
 class CollisionSystem : public System
 {
+    ECollisionBroadphase broadphase = ECB_SweepAndPrune;
+
+    /**
+     * Broadphase structure kept in sync with the entities of the system
+     */
+    SweepAndPrune sweepAndPrune;
+
+    /**
+     * Entities of the system by id, used to emit events for the pairs found by the broadphase
+     */
+    std::unordered_map<int, Entity> entitiesById;
+
+    /**
+     * Layer-pair matrix checked before any bounds test
+     */
+    CollisionLayerMatrix layerMatrix;
+
+    /**
+     * Contacts of the previous frames, used to split them in enter/stay/exit events
+     */
+    ContactCache contactCache;
+
+    /**
+     * Contacts ended by the removal of one of their entities, emitted on the next Update
+     */
+    std::vector<std::pair<Entity, Entity>> pendingExits;
+    std::vector<CollisionPair> removedContacts;
+
 public:
     CollisionSystem()
     {
@@ -27,7 +68,82 @@ public:
         RequireComponent<BoxCollisionComponent>();
     }
 
+    void SetBroadphase(ECollisionBroadphase type) { broadphase = type; }
+    ECollisionBroadphase GetBroadphase() const { return broadphase; }
+    const SweepAndPrune& GetSweepAndPrune() const { return sweepAndPrune; }
+
+    /**
+     * The layer of a collider is read when its entity joins the system,
+     * so the matrix has to be configured before the level entities are added.
+     */
+    CollisionLayerMatrix& GetLayerMatrix() { return layerMatrix; }
+
+    void AddEntityToSystem(Entity entity) override
+    {
+        System::AddEntityToSystem(entity);
+        entitiesById.emplace(entity.GetID(), entity);
+        const int layer = entity.GetComponent<BoxCollisionComponent>().layer;
+        sweepAndPrune.Insert(entity.GetID(), ComputeBounds(entity), CollisionLayerMatrix::GetLayerBit(layer), layerMatrix.GetLayerMask(layer));
+    }
+
+    void RemoveEntityFromSystem(Entity entity) override
+    {
+        System::RemoveEntityFromSystem(entity);
+
+        if (entitiesById.find(entity.GetID()) == entitiesById.end())
+        {
+            return;
+        }
+
+        removedContacts.clear();
+        contactCache.RemoveEntity(entity.GetID(), removedContacts);
+        for (const auto& contact : removedContacts)
+        {
+            const auto a = entitiesById.find(contact.a);
+            const auto b = entitiesById.find(contact.b);
+            if (a != entitiesById.end() && b != entitiesById.end())
+            {
+                pendingExits.emplace_back(a->second, b->second);
+            }
+        }
+
+        entitiesById.erase(entity.GetID());
+        sweepAndPrune.Remove(entity.GetID());
+    }
+
+    /**
+     * Finds the overlapping pairs with the selected broadphase and emits a CollisionEnterEvent
+     * for new contacts, a CollisionStayEvent for the ongoing ones and a CollisionExitEvent for
+     * the ended ones.
+     */
     void Update(std::unique_ptr<EventBus>& eventBus)
+    {
+        for (auto& contact : pendingExits)
+        {
+            eventBus->EmitEvent<CollisionExitEvent>(contact.first, contact.second);
+        }
+        pendingExits.clear();
+
+        contactCache.BeginFrame();
+
+        if (broadphase == ECB_SweepAndPrune)
+        {
+            UpdateSweepAndPrune();
+        }
+        else
+        {
+            UpdateBruteForce();
+        }
+
+        contactCache.EndFrame();
+
+        EmitContactEvents(eventBus);
+    }
+
+    const ContactCache& GetContactCache() const { return contactCache; }
+
+private:
+    void UpdateBruteForce()
     {
         auto entities = GetSystemEntity();
 
@@ -46,9 +162,15 @@ public:
                     continue;
                 }
 
-                auto bTransform = b.GetComponent<TransformComponent>();
                 auto bCollider = b.GetComponent<BoxCollisionComponent>();
 
+                if (!layerMatrix.ShouldCollide(aCollider.layer, bCollider.layer))
+                {
+                    continue;
+                }
+
+                auto bTransform = b.GetComponent<TransformComponent>();
+
                 bool collisionHappened = CheckAABBCollision
                 (
                     aTransform.position.x + aCollider.offset.x,
@@ -63,10 +185,7 @@ public:
                 
                 if (collisionHappened)
                 {
-                    Logger::Log("Entity id " + std::to_string(a.GetID()) + " (" + a.GetName() +") " +
-                     " is colliding entity id " + std::to_string(b.GetID()) + " (" + b.GetName() + ") ");
-
-                    eventBus->EmitEvent<CollisionEvent>(a, b); 
+                    contactCache.AddContact(a.GetID(), b.GetID());
                 }
             }
 
@@ -74,8 +193,73 @@ public:
         }
     }
 
-    
+    /**
+     * Refreshes the bounds of every collider and lets the sweep-and-prune re-sort its endpoints.
+     * Colliders that did not move leave their endpoints in place, so only moving entities cost swaps.
+     */
+    void UpdateSweepAndPrune()
+    {
+        for (const auto& it : entitiesById)
+        {
+            sweepAndPrune.Move(it.first, ComputeBounds(it.second));
+        }
+
+        sweepAndPrune.Update();
+        sweepAndPrune.ClearPairChanges();
+
+        for (const uint64_t key : sweepAndPrune.GetOverlappingPairs())
+        {
+            const CollisionPair pair = UnpackPairKey(key);
+            contactCache.AddContact(pair.a, pair.b);
+        }
+    }
+
+    void EmitContactEvents(std::unique_ptr<EventBus>& eventBus)
+    {
+        for (const auto& contact : contactCache.GetEnteredContacts())
+        {
+            const auto a = entitiesById.find(contact.a);
+            const auto b = entitiesById.find(contact.b);
+            if (a == entitiesById.end() || b == entitiesById.end()) continue;
+
+            Logger::Log("Entity id {} ({})  is colliding entity id {} ({}) ", contact.a, a->second.GetName(), contact.b, b->second.GetName());
+
+            eventBus->EmitEvent<CollisionEnterEvent>(a->second, b->second);
+        }
+
+        // Ongoing contacts are only walked when somebody listens to them
+        if (eventBus->HasSubscribers<CollisionStayEvent>())
+        {
+            for (const auto& contact : contactCache.GetStayingContacts())
+            {
+                const auto a = entitiesById.find(contact.a);
+                const auto b = entitiesById.find(contact.b);
+                if (a == entitiesById.end() || b == entitiesById.end()) continue;
+
+                eventBus->EmitEvent<CollisionStayEvent>(a->second, b->second);
+            }
+        }
+
+        for (const auto& contact : contactCache.GetExitedContacts())
+        {
+            const auto a = entitiesById.find(contact.a);
+            const auto b = entitiesById.find(contact.b);
+            if (a == entitiesById.end() || b == entitiesById.end()) continue;
+
+            eventBus->EmitEvent<CollisionExitEvent>(a->second, b->second);
+        }
+    }
+
+    static AABB ComputeBounds(const Entity& entity)
+    {
+        const auto& transform = entity.GetComponent<TransformComponent>();
+        const auto& collider = entity.GetComponent<BoxCollisionComponent>();
+
+        const float x = transform.position.x + collider.offset.x;
+        const float y = transform.position.y + collider.offset.y;
 
+        return AABB{ x, y, x + collider.width, y + collider.height };
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -18,14 +18,14 @@ class DamageSystem : public System
 
         void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) 
         {
-            eventBus->SubscribeToEvent<CollisionEvent>(this, &DamageSystem::OnCollision);
+            eventBus->SubscribeToEvent<CollisionEnterEvent>(this, &DamageSystem::OnCollision);
         }
 
-        void OnCollision(CollisionEvent& event) 
+        void OnCollision(CollisionEnterEvent& event) 
         {
             Entity a = event.a;
             Entity b = event.b;
-            Logger::Log("Collision event emitted: " + std::to_string(a.GetID()) + " and " + std::to_string(b.GetID()));
+            Logger::Log("Collision event emitted: {} and {}", a.GetID(), b.GetID());
         
             if (a.BelongsToGroup("projectiles") && b.HasTag("player")) 
             {
@@ -7,6 +7,7 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/KeyboardControlledComponent.h"
+#include "../Components/AnimationComponent.h"
 
 class KeyboardControlSystem: public System 
 {
@@ -35,26 +36,51 @@ class KeyboardControlSystem: public System
                 {
                     case SDLK_UP:
                         rigidbody.velocity = keyboardcontrol.upVelocity;
-                        sprite.srcRect.y = sprite.height * 0;
+                        SetDirection(entity, sprite, keyboardcontrol.upClip, 0);
                         break;
                     case SDLK_RIGHT:
                         rigidbody.velocity = keyboardcontrol.rightVelocity;
-                        sprite.srcRect.y = sprite.height * 1;
+                        SetDirection(entity, sprite, keyboardcontrol.rightClip, 1);
                         break;
 
                     case SDLK_DOWN:
                         rigidbody.velocity =  keyboardcontrol.downVelocity;
-                        sprite.srcRect.y = sprite.height * 2;
+                        SetDirection(entity, sprite, keyboardcontrol.downClip, 2);
                         break;
 
                     case SDLK_LEFT:
                         rigidbody.velocity = keyboardcontrol.leftVelocity;
-                        sprite.srcRect.y = sprite.height * 3;
+                        SetDirection(entity, sprite, keyboardcontrol.leftClip, 3);
                         break;
                 }
             }
         }
 
+        /**
+         * Plays the clip of the direction, or shows the row of the direction in the spritesheet
+         * when there is no clip. The clip keeps its start time so the animation does not restart,
+         * an animated sprite without direction clips keeps playing its clip on that row.
+         */
+        static void SetDirection(Entity entity, SpriteComponent& sprite, int clipId, int row)
+        {
+            if (!entity.HasComponent<AnimationComponent>())
+            {
+                sprite.srcRect.y = sprite.height * row;
+                return;
+            }
+
+            auto& animation = entity.GetComponent<AnimationComponent>();
+            if (clipId >= 0)
+            {
+                animation.clipId = clipId;
+                animation.rowOffset = 0;
+            }
+            else
+            {
+                animation.rowOffset = sprite.height * row;
+            }
+        }
+
         void Update() 
         {
                 
@@ -5,6 +5,7 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../Events/CollisionEvent.h"
+#include "../Events/TileCollisionEvent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Game/Game.h"
 
@@ -22,27 +23,37 @@ class MovementSystem : public System
 
 		void SubscribeToEvents(std::unique_ptr<EventBus>& eventBus) 
         {
-            eventBus->SubscribeToEvent<CollisionEvent>(this, &MovementSystem::OnCollision);
+            eventBus->SubscribeToEvent<CollisionEnterEvent>(this, &MovementSystem::OnCollision);
+            eventBus->SubscribeToEvent<TileCollisionEvent>(this, &MovementSystem::OnTileCollision);
         }
 
-		 void OnCollision(CollisionEvent& event) 
+		 void OnCollision(CollisionEnterEvent& event) 
         {
             Entity a = event.a;
             Entity b = event.b;
 
-            Logger::Log("Collision event emitted: " + std::to_string(a.GetID()) + " and " + std::to_string(b.GetID()));
+            Logger::Log("Collision event emitted: {} and {}", a.GetID(), b.GetID());
         
             if (a.BelongsToGroup("enemies") && b.BelongsToGroup("obstacles")) 
             {
-                OnEnemyHitObstacles(a, b);	
+                ReverseEnemy(a);	
             }
 
 			if (a.BelongsToGroup("obstacles") && b.BelongsToGroup("enemies")) 
             {
-                OnEnemyHitObstacles(b, a);	
+                ReverseEnemy(b);	
             }
 		}
 
+		void OnTileCollision(TileCollisionEvent& event)
+		{
+			// solid tiles behave like obstacles for the enemies
+			if (event.entity.BelongsToGroup("enemies"))
+			{
+				ReverseEnemy(event.entity);
+			}
+		}
+
 		void Update(double deltaTime)
 		{
 			for (auto entity : GetSystemEntity())
@@ -81,9 +92,11 @@ class MovementSystem : public System
 		}
 
 
-		void OnEnemyHitObstacles(Entity enemy, Entity obstacles)
+		/**
+		 * Sends an enemy back the way it came, after it hit an obstacle or a solid tile.
+		 */
+		void ReverseEnemy(Entity enemy)
 		{
-			(void)obstacles;
 			if (enemy.HasComponent<RigidBodyComponent>() && enemy.HasComponent<SpriteComponent>())
 			{
 				auto& rigidBody = enemy.GetComponent<RigidBodyComponent>();
@@ -9,6 +9,7 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/ProjectileComponent.h"
 #include "../Components/CameraFollowComponent.h"
+#include "./CollisionSystem.h"
 #include "../EventBus/EventBus.h"
 #include "../Events/KeyPressedEvent.h"
 #include <SDL2/SDL.h>
@@ -69,7 +70,7 @@ class ProjectileEmitterSystem: public System
                         projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
                         projectile.AddComponent<RigidBodyComponent>(projectileVelocity);
                         projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                        projectile.AddComponent<BoxCollisionComponent>(4, 4);
+                        projectile.AddComponent<BoxCollisionComponent>(4, 4, glm::vec2(0), GetProjectileLayer(*entity.registry));
                         projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
                     }
                 }
@@ -104,7 +105,7 @@ class ProjectileEmitterSystem: public System
                     projectile.AddComponent<TransformComponent>(projectilePosition, glm::vec2(1.0, 1.0), 0.0);
                     projectile.AddComponent<RigidBodyComponent>(projectileEmitter.projectileVelocity);
                     projectile.AddComponent<SpriteComponent>("bullet-texture", 4, 4, 4);
-                    projectile.AddComponent<BoxCollisionComponent>(4, 4);
+                    projectile.AddComponent<BoxCollisionComponent>(4, 4, glm::vec2(0), GetProjectileLayer(*registry));
                     projectile.AddComponent<ProjectileComponent>(projectileEmitter.isFriendly, projectileEmitter.hitPercentDamage, projectileEmitter.projectileDuration);
                 
                     // Update the projectile emitter component last emission to the current milliseconds
@@ -112,6 +113,12 @@ class ProjectileEmitterSystem: public System
                 }
             }
         }
+
+    private:
+        static int GetProjectileLayer(const Registry& registry)
+        {
+            return registry.GetSystem<CollisionSystem>().GetLayerMatrix().GetLayer("projectiles");
+        }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef RENDERCIRCLECOLLIDERSYSTEM_H
+#define RENDERCIRCLECOLLIDERSYSTEM_H
+
+#include "../ECS/ECS.h"
+#include "../Components/CircleCollisionComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Renderer/DebugDraw.h"
+#include "../Renderer/RenderSnapshot.h"
+
+/**
+ * RenderCircleColliderSystem outlines the circle colliders of the entities with
+ * TransformComponent and CircleCollisionComponent, for debugging purposes.
+ * The circle fits in the square of side 2 * radius placed at the position plus the offset.
+ */
+class RenderCircleColliderSystem : public System
+{
+public:
+    RenderCircleColliderSystem()
+    {
+        RequireComponent<TransformComponent>();
+        RequireComponent<CircleCollisionComponent>();
+    }
+
+    /**
+     * Copies the center and radius of every collider into the snapshot, in world coordinates.
+     */
+    void Capture(RenderSnapshot& snapshot)
+    {
+        for (auto entity : GetSystemEntity())
+        {
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& collider = entity.GetComponent<CircleCollisionComponent>();
+
+            ColliderCircleDraw draw;
+            draw.center = transform.position + collider.offset + glm::vec2(collider.radius);
+            draw.radius = collider.radius;
+            snapshot.colliderCircles.push_back(draw);
+        }
+    }
+
+    /**
+     * Records the circles of the snapshot in the debug draw buffer, flushed by the caller.
+     */
+    void Render(std::unique_ptr<DebugDraw>& debugDraw, const RenderSnapshot& snapshot)
+    {
+        const SDL_Rect& camera = snapshot.camera;
+        for (const auto& circle : snapshot.colliderCircles)
+        {
+            debugDraw->DrawCircle(
+                static_cast<int>(circle.center.x - camera.x),
+                static_cast<int>(circle.center.y - camera.y),
+                circle.radius,
+                SDL_Color{255, 0, 0, 255});
+        }
+    }
+};
+
+#endif
@@ -4,9 +4,10 @@
 #include "../ECS/ECS.h"
 #include "../Components/BoxColliderComponent.h"
 #include "../Components/TransformComponent.h"
+#include "../Renderer/DebugDraw.h"
+#include "../Renderer/RenderSnapshot.h"
 
 
-// TODO in future add Circle Collision Component 
 enum EColliderType
 {
     ECT_Box,
@@ -33,50 +34,45 @@ public:
     }
 
     /**
-     * Renders the bounding boxes (colliders) of all entities managed by this system.
-     * For each entity, the collider rectangle is calculated based on its position,
-     * offset, and dimensions, and then rendered as a red rectangle on the screen.
-     *
-     * @param renderer Pointer to SDL_Renderer used for drawing the bounding boxes.
+     * Copies the collider rectangle of every entity into the snapshot, in world coordinates.
      */
-    void Update(SDL_Renderer* renderer, SDL_Rect& camera)
+    void Capture(RenderSnapshot& snapshot)
     {
         for (auto entity : GetSystemEntity())
         {
-            const auto transform = entity.GetComponent<TransformComponent>();
-            const auto collider = entity.GetComponent<BoxCollisionComponent>();
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& collider = entity.GetComponent<BoxCollisionComponent>();
 
-            // Calculate collider rectangle
-            const SDL_Rect colliderRect = 
+            snapshot.colliderBoxes.push_back(SDL_FRect
             {
-                static_cast<int>(transform.position.x + collider.offset.x - camera.x),
-                static_cast<int>(transform.position.y + collider.offset.y - camera.y),
-                static_cast<int>(collider.width),
-                static_cast<int>(collider.height)
-            };
-
-            // Set draw color to red and render the rectangle
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-            SDL_RenderDrawRect(renderer, &colliderRect);
+                transform.position.x + collider.offset.x,
+                transform.position.y + collider.offset.y,
+                static_cast<float>(collider.width),
+                static_cast<float>(collider.height)
+            });
         }
     }
 
-
-//TODO in future add Circle Collision Component
-private:
-    void DrawCircle(SDL_Renderer* renderer, int centerX, int centerY, int radius)
+    /**
+     * Records the bounding boxes (colliders) of the snapshot as red rectangles in the debug draw buffer.
+     *
+     * @param debugDraw Debug draw buffer the rectangles are added to, flushed by the caller.
+     */
+    void Render(std::unique_ptr<DebugDraw>& debugDraw, const RenderSnapshot& snapshot)
     {
-        for (int w = 0; w < radius * 2; w++)
+        const SDL_Rect& camera = snapshot.camera;
+        for (const auto& box : snapshot.colliderBoxes)
         {
-            for (int h = 0; h < radius * 2; h++)
+            // Calculate collider rectangle
+            const SDL_Rect colliderRect = 
             {
-                int dx = radius - w;                // horizontal offset
-                int dy = radius - h;                // vertical offset
-                if ((dx * dx + dy * dy) <= (radius * radius))
-                {
-                    SDL_RenderDrawPoint(renderer, centerX + dx, centerY + dy);
-                }
-            }
+                static_cast<int>(box.x - camera.x),
+                static_cast<int>(box.y - camera.y),
+                static_cast<int>(box.w),
+                static_cast<int>(box.h)
+            };
+
+            debugDraw->DrawRect(colliderRect, SDL_Color{255, 0, 0, 255});
         }
     }
 };
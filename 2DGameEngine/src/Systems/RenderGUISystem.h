@@ -8,25 +8,107 @@
 #include "../Components/RigidBodyComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/ProjectileEmitterComponent.h"
+#include "./CollisionSystem.h"
+#include "./ScriptSystem.h"
+#include "../Renderer/RenderProfiler.h"
+#include "../AssetManager/AssetManager.h"
+#include "../Renderer/TilemapRenderer.h"
 #include <imgui/imgui.h>
 #include <imgui/imgui_sdl.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <random>
 
 
+/**
+ * Timings of the last frames shown by the GUI, filled by the game loop.
+ */
+struct GUIFrameStats
+{
+    double frameMs = 0.0;                               /**< Whole last frame, frame cap included */
+    double frameWorkMs = 0.0;                           /**< Last frame without the frame cap wait */
+    SDL_Rect camera = { 0, 0, 0, 0 };
+    const RenderProfiler* renderProfiler = nullptr;
+    const RenderProfiler* simulationProfiler = nullptr;
+    const AssetManager* assetManager = nullptr;
+    const TilemapRenderer* tilemapRenderer = nullptr;
+    const ScriptStats* scriptStats = nullptr;
+};
 
 /**
  * Render GUI system 
  * add new entity in game  
+ *
+ * The stress test window spawns entities in bulk and can ramp their number up until the frame
+ * time goes over a budget, the timings window shows the time of every system, the entities of
+ * every system and the size of the component pools, to find how much a level can take.
  */
 class RenderGUISystem : public System
 {
     bool* open = NULL;
+
+    /**
+     * Texture memory listed by the timings window, kept to reuse its capacity
+     */
+    std::vector<AssetMemoryInfo> textureMemoryInfo;
+
+    enum EStressPlacement
+    {
+        ESP_Grid,
+        ESP_Random
+    };
+
+    enum EStressArea
+    {
+        ESA_View,
+        ESA_Map
+    };
+
+    /**
+     * Settings of the stress test window and state of the ramp
+     */
+    struct StressTest
+    {
+        int spriteIndex = 0;
+        int scale = 1;
+        int count = 100;
+        int placement = ESP_Random;
+        int area = ESA_View;
+        int gridSpacing = 40;
+        float minSpeed = 0.0f;
+        float maxSpeed = 50.0f;
+        bool hasEmitter = false;
+        float projectileSpeed = 100.0f;
+        int projectileRepeat = 2;
+        int projectileDuration = 2;
+
+        bool isRamping = false;
+        int rampStep = 100;
+        float rampInterval = 1.0f;          // seconds
+        float frameBudgetMs = 16.6f;
+        double rampTimeLeft = 0.0;
+        double rampFrameMsSum = 0.0;
+        int rampNumFrames = 0;
+        int breakingPointEntities = -1;
+        double breakingPointFrameMs = 0.0;
+    };
+
+    StressTest stress;
+    std::mt19937 random;
+
+    static constexpr const char* STRESS_GROUP = "stress";
+
 public:
     RenderGUISystem() = default;
     
-    void Update(const std::unique_ptr<Registry>& registry)
+    void Update(const std::unique_ptr<Registry>& registry, const GUIFrameStats& frameStats)
     {
         ImGui::NewFrame();
 
+        UpdateStressRamp(registry, frameStats);
+        StressTestWindow(registry, frameStats);
+        TimingsWindow(registry, frameStats);
+
         if (ImGui::BeginMainMenuBar())
         {
             if (ImGui::BeginMenu("Game"))
@@ -117,7 +199,8 @@ public:
                 entity.AddComponent<TransformComponent>(glm::vec2(enemyXPos, enemyYPos), glm::vec2(scaleX, scaleY), glm::degrees(rotation));
                 entity.AddComponent<RigidBodyComponent>(glm::vec2(velY, velX));
                 entity.AddComponent<SpriteComponent>(sprites[selectedSpriteIndex], 32, 32, 2);
-                entity.AddComponent<BoxCollisionComponent>(32 * scaleX, 32 * scaleY);
+                const int enemyLayer = registry->GetSystem<CollisionSystem>().GetLayerMatrix().GetLayer("enemies");
+                entity.AddComponent<BoxCollisionComponent>(32 * scaleX, 32 * scaleY, glm::vec2(0), enemyLayer);
                 double projVelX = cos(projAngle) * projSpeed;
                 double projVelY = sin(projAngle) * projSpeed;
                 entity.AddComponent<ProjectileEmitterComponent>(glm::vec2(projVelX, projVelY), projRepeat * 1000, projDuration * 1000, damage, false);
@@ -141,6 +224,281 @@ public:
     }
 
 
+private:
+    static const char* const* GetSpriteNames(int& outCount)
+    {
+        static const char* const sprites[] = { "tank-texture", "truck-texture", "su27-texture", "f22-texture", "fw190-texture" };
+        outCount = IM_ARRAYSIZE(sprites);
+        return sprites;
+    }
+
+    void StressTestWindow(const std::unique_ptr<Registry>& registry, const GUIFrameStats& frameStats)
+    {
+        ImGui::SetNextWindowSize(ImVec2(420, 560), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Stress Test"))
+        {
+            int numSprites = 0;
+            const char* const* sprites = GetSpriteNames(numSprites);
+
+            if (ImGui::CollapsingHeader("Prefab", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                ImGui::Combo("Sprite", &stress.spriteIndex, sprites, numSprites);
+                ImGui::SliderInt("Scale", &stress.scale, 1, 5);
+                ImGui::Checkbox("Projectile emitter", &stress.hasEmitter);
+                if (stress.hasEmitter)
+                {
+                    ImGui::SliderFloat("Projectile speed", &stress.projectileSpeed, 10, 1000);
+                    ImGui::InputInt("Repeat (sec)", &stress.projectileRepeat);
+                    ImGui::InputInt("Duration (sec)", &stress.projectileDuration);
+                }
+            }
+
+            if (ImGui::CollapsingHeader("Placement", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                const char* placements[] = { "Grid", "Random" };
+                const char* areas[] = { "Camera view", "Whole map" };
+                ImGui::Combo("Placement", &stress.placement, placements, IM_ARRAYSIZE(placements));
+                ImGui::Combo("Area", &stress.area, areas, IM_ARRAYSIZE(areas));
+                if (stress.placement == ESP_Grid)
+                {
+                    ImGui::SliderInt("Grid spacing", &stress.gridSpacing, 8, 256);
+                }
+                ImGui::DragFloatRange2("Speed (px/sec)", &stress.minSpeed, &stress.maxSpeed, 1.0f, 0.0f, 1000.0f);
+            }
+
+            ImGui::Separator();
+            ImGui::InputInt("Count", &stress.count, 10, 100);
+            stress.count = std::max(stress.count, 1);
+
+            if (ImGui::Button("Spawn"))
+            {
+                SpawnStressEntities(registry, frameStats.camera, stress.count);
+            }
+            ImGui::SameLine();
+            const int numStressEntities = static_cast<int>(registry->GetEntitiesByGroup(STRESS_GROUP).size());
+            if (ImGui::Button("Remove all"))
+            {
+                RemoveStressEntities(registry);
+                stress.isRamping = false;
+            }
+            ImGui::SameLine();
+            ImGui::Text("%d stress entities", numStressEntities);
+
+            if (ImGui::CollapsingHeader("Ramp", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                ImGui::InputFloat("Frame budget (ms)", &stress.frameBudgetMs, 0.5f, 1.0f, "%.1f");
+                ImGui::InputInt("Entities per step", &stress.rampStep, 10, 100);
+                ImGui::SliderFloat("Step interval (sec)", &stress.rampInterval, 0.25f, 5.0f);
+                stress.rampStep = std::max(stress.rampStep, 1);
+
+                if (ImGui::Button(stress.isRamping ? "Stop ramp" : "Start ramp"))
+                {
+                    stress.isRamping = !stress.isRamping;
+                    stress.rampTimeLeft = stress.rampInterval;
+                    stress.rampFrameMsSum = 0.0;
+                    stress.rampNumFrames = 0;
+                    stress.breakingPointEntities = -1;
+                }
+
+                if (stress.isRamping)
+                {
+                    const double averageMs = stress.rampNumFrames > 0 ? stress.rampFrameMsSum / stress.rampNumFrames : 0.0;
+                    ImGui::Text("Ramping: %d entities, %.2f ms per frame", registry->GetNumEntities(), averageMs);
+                }
+                if (stress.breakingPointEntities >= 0)
+                {
+                    ImGui::Text("Budget exceeded at %d entities (%.2f ms per frame)", stress.breakingPointEntities, stress.breakingPointFrameMs);
+                }
+            }
+        }
+        ImGui::End();
+    }
+
+    /**
+     * Averages the frame time over every step interval, adds a step of entities while the average
+     * stays within the budget, stops and records the entity count once it goes over.
+     */
+    void UpdateStressRamp(const std::unique_ptr<Registry>& registry, const GUIFrameStats& frameStats)
+    {
+        if (!stress.isRamping)
+        {
+            return;
+        }
+
+        stress.rampFrameMsSum += frameStats.frameWorkMs;
+        stress.rampNumFrames++;
+        stress.rampTimeLeft -= frameStats.frameMs / 1000.0;
+        if (stress.rampTimeLeft > 0.0)
+        {
+            return;
+        }
+
+        const double averageMs = stress.rampFrameMsSum / stress.rampNumFrames;
+        if (averageMs > stress.frameBudgetMs)
+        {
+            stress.isRamping = false;
+            stress.breakingPointEntities = registry->GetNumEntities();
+            stress.breakingPointFrameMs = averageMs;
+            Logger::Log("Stress test: frame budget exceeded at " + std::to_string(stress.breakingPointEntities) +
+                " entities, " + std::to_string(averageMs) + " ms per frame");
+        }
+        else
+        {
+            SpawnStressEntities(registry, frameStats.camera, stress.rampStep);
+        }
+
+        stress.rampTimeLeft = stress.rampInterval;
+        stress.rampFrameMsSum = 0.0;
+        stress.rampNumFrames = 0;
+    }
+
+    /**
+     * Spawns entities of the prefab, on a grid or at random in the area, moving in random directions.
+     * They go in their own group, so they are not damaged and the count stays stable.
+     */
+    void SpawnStressEntities(const std::unique_ptr<Registry>& registry, const SDL_Rect& camera, int count)
+    {
+        int numSprites = 0;
+        const char* const* sprites = GetSpriteNames(numSprites);
+        const char* spriteName = sprites[std::min(stress.spriteIndex, numSprites - 1)];
+
+        const SDL_Rect area = stress.area == ESA_Map ? SDL_Rect{ 0, 0, Game::MapWidth, Game::MapHeight } : camera;
+        const int size = 32 * stress.scale;
+        const int columns = std::max((area.w - size) / stress.gridSpacing, 1);
+
+        std::uniform_real_distribution<float> randomX(static_cast<float>(area.x), static_cast<float>(area.x + std::max(area.w - size, 1)));
+        std::uniform_real_distribution<float> randomY(static_cast<float>(area.y), static_cast<float>(area.y + std::max(area.h - size, 1)));
+        std::uniform_real_distribution<float> randomSpeed(stress.minSpeed, std::max(stress.minSpeed, stress.maxSpeed));
+        std::uniform_real_distribution<float> randomAngle(0.0f, 2.0f * glm::pi<float>());
+
+        const int enemyLayer = registry->GetSystem<CollisionSystem>().GetLayerMatrix().GetLayer("enemies");
+        const int firstIndex = static_cast<int>(registry->GetEntitiesByGroup(STRESS_GROUP).size());
+
+        for (int i = 0; i < count; i++)
+        {
+            glm::vec2 position;
+            if (stress.placement == ESP_Grid)
+            {
+                // continue the grid after the entities already spawned
+                const int index = firstIndex + i;
+                position = glm::vec2(area.x + (index % columns) * stress.gridSpacing, area.y + (index / columns) * stress.gridSpacing);
+            }
+            else
+            {
+                position = glm::vec2(randomX(random), randomY(random));
+            }
+
+            const float speed = randomSpeed(random);
+            const float angle = randomAngle(random);
+            const glm::vec2 velocity(std::cos(angle) * speed, std::sin(angle) * speed);
+
+            Entity entity = registry->CreateEntity();
+            entity.Group(STRESS_GROUP);
+            entity.AddComponent<TransformComponent>(position, glm::vec2(stress.scale, stress.scale), 0.0);
+            entity.AddComponent<RigidBodyComponent>(velocity);
+            entity.AddComponent<SpriteComponent>(spriteName, 32, 32, 2);
+            entity.AddComponent<BoxCollisionComponent>(size, size, glm::vec2(0), enemyLayer);
+            entity.AddComponent<HealthComponent>(100);
+            if (stress.hasEmitter)
+            {
+                const glm::vec2 projectileVelocity(std::cos(angle) * stress.projectileSpeed, std::sin(angle) * stress.projectileSpeed);
+                entity.AddComponent<ProjectileEmitterComponent>(projectileVelocity, stress.projectileRepeat * 1000, stress.projectileDuration * 1000, 10, false);
+            }
+        }
+    }
+
+    void RemoveStressEntities(const std::unique_ptr<Registry>& registry)
+    {
+        for (auto entity : registry->GetEntitiesByGroup(STRESS_GROUP))
+        {
+            registry->KillEntity(entity);
+        }
+    }
+
+    static void ProfilerTimings(const char* title, const RenderProfiler* profiler)
+    {
+        if (!profiler || !ImGui::CollapsingHeader(title, ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            return;
+        }
+
+        ImGui::Columns(4, title);
+        ImGui::Text("Section"); ImGui::NextColumn();
+        ImGui::Text("Last ms"); ImGui::NextColumn();
+        ImGui::Text("Avg ms"); ImGui::NextColumn();
+        ImGui::Text("Max ms"); ImGui::NextColumn();
+        ImGui::Separator();
+        for (const auto& timing : profiler->GetTimings())
+        {
+            ImGui::Text("%s", timing.name.c_str()); ImGui::NextColumn();
+            ImGui::Text("%.3f", timing.lastMs); ImGui::NextColumn();
+            ImGui::Text("%.3f", timing.samples > 0 ? timing.totalMs / timing.samples : 0.0); ImGui::NextColumn();
+            ImGui::Text("%.3f", timing.maxMs); ImGui::NextColumn();
+        }
+        ImGui::Columns(1);
+    }
+
+    void TimingsWindow(const std::unique_ptr<Registry>& registry, const GUIFrameStats& frameStats)
+    {
+        ImGui::SetNextWindowSize(ImVec2(420, 600), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Timings"))
+        {
+            ImGui::Text("Frame %.2f ms (%.0f fps), work %.2f ms", frameStats.frameMs, frameStats.frameMs > 0.0 ? 1000.0 / frameStats.frameMs : 0.0, frameStats.frameWorkMs);
+            ImGui::Text("Entities %d", registry->GetNumEntities());
+
+            ProfilerTimings("Simulation", frameStats.simulationProfiler);
+            ProfilerTimings("Render", frameStats.renderProfiler);
+
+            if (ImGui::CollapsingHeader("Entities per system"))
+            {
+                for (const auto& system : registry->GetSystemStats())
+                {
+                    ImGui::Text("%-28s %d", system.name.c_str(), system.numEntities);
+                }
+            }
+
+            if (ImGui::CollapsingHeader("Component pools"))
+            {
+                for (const auto& pool : registry->GetPoolStats())
+                {
+                    ImGui::Text("%-28s %d / %d", pool.name.c_str(), pool.numComponents, pool.capacity);
+                }
+            }
+
+            if (frameStats.assetManager && ImGui::CollapsingHeader("Texture memory"))
+            {
+                const AssetMemoryStats memory = frameStats.assetManager->GetMemoryStats();
+                const double megabyte = 1024.0 * 1024.0;
+                ImGui::Text("Total %.2f MB (atlas %.2f MB), budget %s", memory.GetTotalBytes() / megabyte, memory.atlasBytes / megabyte,
+                    memory.budgetBytes > 0 ? (std::to_string(memory.budgetBytes / (1024 * 1024)) + " MB").c_str() : "none");
+                ImGui::Text("Resident %d, unreferenced %d, evictions %d", memory.numResident, memory.numUnreferenced, memory.numEvictions);
+
+                frameStats.assetManager->GetTextureMemoryInfo(textureMemoryInfo);
+                for (const auto& texture : textureMemoryInfo)
+                {
+                    ImGui::Text("%-28s %8.1f KB  refs %3d %s", texture.assetID.c_str(), texture.memoryBytes / 1024.0, texture.refCount,
+                        texture.isPacked ? "atlas" : (texture.isResident ? "" : "evicted"));
+                }
+            }
+
+            if (frameStats.tilemapRenderer && ImGui::CollapsingHeader("Tilemap"))
+            {
+                const TilemapRenderStats& tilemap = frameStats.tilemapRenderer->GetStats();
+                ImGui::Text("%s, %d chunks, %d visible", frameStats.tilemapRenderer->IsStreamed() ? "Streamed" : "Baked whole", tilemap.chunks, tilemap.visibleChunks);
+                ImGui::Text("Resident %d chunks, %.2f MB, baked this frame %d", tilemap.residentChunks, tilemap.chunkBytes / (1024.0 * 1024.0), tilemap.bakedChunks);
+            }
+
+            if (frameStats.scriptStats && ImGui::CollapsingHeader("Scripts"))
+            {
+                const ScriptStats& scripts = *frameStats.scriptStats;
+                ImGui::Text("%d scripted entities, %d updates in %d batches, %d deferred", scripts.scriptedEntities, scripts.updatedEntities, scripts.batches, scripts.deferredEntities);
+                ImGui::Text("Scripts %.3f ms, GC %.3f ms in %d steps, Lua memory %.2f MB", scripts.scriptMs, scripts.gcMs, scripts.gcSteps, scripts.memoryKB / 1024.0);
+            }
+        }
+        ImGui::End();
+    }
+
+public:
     static void Overlay(bool* is_open)
     {
         const float DISTANCE = 10.0f;
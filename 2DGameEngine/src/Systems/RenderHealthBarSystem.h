@@ -6,10 +6,18 @@
 #include "../Components/TransformComponent.h"
 #include "../Components/SpriteComponent.h"
 #include "../Components/HealthComponent.h"
+#include "../Renderer/TextRenderer.h"
+#include "../Renderer/DebugDraw.h"
+#include "../Renderer/RenderSnapshot.h"
 #include <SDL2/SDL.h>
 
 class RenderHealthBarSystem : public System
 {
+    /**
+     * Font of the health labels, referenced by the system, resolved again when the assets are cleared
+     */
+    FontHandle labelFontHandle;
+
 public:
     RenderHealthBarSystem()
     {
@@ -19,14 +27,44 @@ public:
     }
 
 
-    void Update(SDL_Renderer* renderer, const std::unique_ptr<AssetManager>& assetManager, const SDL_Rect& camera)
+    /**
+     * Copies the health and the bar position, the top-right part of the sprite, into the snapshot.
+     */
+    void Capture(const std::unique_ptr<AssetManager>& assetManager, RenderSnapshot& snapshot)
     {
+        if (!assetManager->IsValid(labelFontHandle))
+        {
+            labelFontHandle = assetManager->GetFontHandle("pico8-font-5");
+            assetManager->AcquireFont(labelFontHandle);
+        }
+        snapshot.healthLabelFont = assetManager->GetFont(labelFontHandle);
+
         for (auto entity: GetSystemEntity()) 
         {
-            const auto transform = entity.GetComponent<TransformComponent>();
-            const auto sprite = entity.GetComponent<SpriteComponent>();
-            const auto health = entity.GetComponent<HealthComponent>();
-            
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const auto& sprite = entity.GetComponent<SpriteComponent>();
+            const auto& health = entity.GetComponent<HealthComponent>();
+
+            HealthBarDraw draw;
+            draw.position = glm::vec2(transform.position.x + (sprite.width * transform.scale.x), transform.position.y);
+            draw.healthPercentage = health.healthPercentage;
+            snapshot.healthBars.push_back(draw);
+        }
+    }
+
+    /**
+     * Health bars go to the debug draw buffer, one fill call per bar color. Health labels change
+     * with the health, they are drawn as glyph quads from the glyph atlas of the font and submitted
+     * in one batch after the bars.
+     */
+    void Render(SDL_Renderer* renderer, std::unique_ptr<TextRenderer>& textRenderer, std::unique_ptr<DebugDraw>& debugDraw, const RenderSnapshot& snapshot)
+    {
+        const SDL_Rect& camera = snapshot.camera;
+        TTF_Font* labelFont = snapshot.healthLabelFont;
+        textRenderer->Begin(renderer);
+
+        for (const auto& health : snapshot.healthBars) 
+        {
             // Draw a the health bar with the correct color for the percentage
             SDL_Color healthBarColor = {255, 255, 255, 255};
             if (health.healthPercentage >= 0 && health.healthPercentage < 40) 
@@ -44,11 +82,10 @@ public:
                 // 80-100 = green
                 healthBarColor = {0, 255, 0, 255};
             }
-            // Position the health bar indicator in the top-right part of the entity sprite
             int healthBarWidth = 15;
             int healthBarHeight = 3;
-            double healthBarPosX = (transform.position.x + (sprite.width * transform.scale.x)) - camera.x;
-            double healthBarPosY = (transform.position.y) - camera.y;
+            double healthBarPosX = health.position.x - camera.x;
+            double healthBarPosY = health.position.y - camera.y;
             SDL_Rect healthBarRectangle = 
             {
                 static_cast<int>(healthBarPosX),
@@ -56,27 +93,14 @@ public:
                 static_cast<int>(healthBarWidth * (health.healthPercentage / 100.0)),
                 static_cast<int>(healthBarHeight)
             };
-            SDL_SetRenderDrawColor(renderer, healthBarColor.r, healthBarColor.g, healthBarColor.b, 255);
-            SDL_RenderFillRect(renderer, &healthBarRectangle);
+            debugDraw->FillRect(healthBarRectangle, healthBarColor);
             // Render the health percentage text label indicator
             std::string healthText = std::to_string(health.healthPercentage);
-            SDL_Surface* surface = TTF_RenderText_Blended(assetManager->GetFont("pico8-font-5"), healthText.c_str(), healthBarColor);
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_FreeSurface(surface);
-            int labelWidth = 0;
-            int labelHeight = 0;
-            SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
-            SDL_Rect healthBarTextRectangle = 
-            {
-                static_cast<int>(healthBarPosX),
-                static_cast<int>(healthBarPosY) + 5,
-                labelWidth,
-                labelHeight
-            };
-            
-            SDL_RenderCopy(renderer, texture, NULL, &healthBarTextRectangle);
-            SDL_DestroyTexture(texture);
+            textRenderer->DrawText(labelFont, healthText, static_cast<int>(healthBarPosX), static_cast<int>(healthBarPosY) + 5, healthBarColor);
         }
+
+        debugDraw->Flush(renderer);
+        textRenderer->End();
     }
 };
 
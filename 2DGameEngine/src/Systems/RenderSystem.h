@@ -5,6 +5,9 @@
 #include "../Components/SpriteComponent.h"
 #include "../Components/TransformComponent.h"
 #include "../AssetManager/AssetManager.h"
+#include "../Utilities/RadixSort.h"
+#include "../Renderer/SpriteBatcher.h"
+#include "../Renderer/RenderSnapshot.h"
 #include <algorithm>
 #include <SDL2/SDL.h>
 
@@ -14,9 +17,61 @@
  * RenderSystem is responsible for rendering entities with the required components.
  * It filters entities to those that contain both TransformComponent and SpriteComponent,
  * sorts them by their z-index, and renders them to the screen using SDL.
+ *
+ * The draw order is kept in a persistent render queue. Every entry has a packed 64 bit sort key
+ * (z-index, texture page, texture handle index), the queue is updated when entities join or leave the system and re-sorted
+ * with a radix sort only when a key changed, so steady-state frames neither allocate nor sort.
+ *
+ * Sprites are drawn through their texture handle, resolved from the asset id once, so a frame
+ * does no string lookup. Every sprite of the system holds a reference to its texture, so the
+ * asset manager does not evict textures still on screen.
+ *
+ * Capture runs with the simulation and copies the visible sprites into a RenderSnapshot, Render
+ * draws a snapshot without reading the registry, so both can run on different threads.
  */
 class RenderSystem : public System
 {
+    /**
+     * Entry of the render queue
+     */
+    struct RenderItem
+    {
+        uint64_t sortKey = 0;
+        int entityId = -1;
+    };
+
+    std::vector<RenderItem> renderQueue;
+    std::vector<RenderItem> sortScratch;
+
+    /**
+     * Per entity id, set when the entity left the system and its entry has to be dropped
+     */
+    std::vector<char> isRemoved;
+    int numRemoved = 0;
+    bool isQueueDirty = false;
+
+    /**
+     * Per texture handle index, the key of the texture (atlas page or standalone) holding the asset,
+     * and the texture that key was computed for, a texture finished loading when they differ
+     */
+    std::vector<uint16_t> pageKeys;
+    std::vector<SDL_Texture*> keyedTextures;
+    std::vector<SDL_Texture*> pageTextures;
+
+    /**
+     * Per entity id, the texture the entity holds a reference to, and the references of the
+     * entities that left the system, dropped by the next Capture
+     */
+    std::vector<TextureHandle> referencedTextures;
+    std::vector<TextureHandle> releasedTextures;
+
+    Registry* registry = nullptr;
+
+    /**
+     * Sprites are submitted in queue order and flushed once per texture run
+     */
+    SpriteBatcher spriteBatcher;
+
 public:
     /**
      * Constructs a RenderSystem and specifies required components.
@@ -29,83 +84,258 @@ public:
         RequireComponent<SpriteComponent>();
     }
 
+    void AddEntityToSystem(Entity entity) override
+    {
+        System::AddEntityToSystem(entity);
+        registry = entity.registry;
+
+        // an id recycled before the queue was compacted must not drop the new entry
+        if (entity.GetID() < static_cast<int>(isRemoved.size()) && isRemoved[entity.GetID()])
+        {
+            CompactQueue();
+        }
+
+        // the texture is keyed by the next Capture, which has the asset manager
+        if (entity.GetID() >= static_cast<int>(referencedTextures.size()))
+        {
+            referencedTextures.resize(entity.GetID() + 1);
+        }
+
+        const auto& sprite = entity.GetComponent<SpriteComponent>();
+        RenderItem item;
+        item.entityId = entity.GetID();
+        item.sortKey = MakeSortKey(sprite.zIndex, UNRESOLVED_KEY, UNRESOLVED_KEY);
+        renderQueue.push_back(item);
+        isQueueDirty = true;
+    }
+
+    void RemoveEntityFromSystem(Entity entity) override
+    {
+        System::RemoveEntityFromSystem(entity);
+
+        if (entity.GetID() >= static_cast<int>(isRemoved.size()))
+        {
+            isRemoved.resize(entity.GetID() + 1, 0);
+        }
+
+        if (!isRemoved[entity.GetID()])
+        {
+            isRemoved[entity.GetID()] = 1;
+            numRemoved++;
+        }
+
+        if (entity.GetID() < static_cast<int>(referencedTextures.size()) && referencedTextures[entity.GetID()].IsSet())
+        {
+            releasedTextures.push_back(referencedTextures[entity.GetID()]);
+            referencedTextures[entity.GetID()] = TextureHandle();
+        }
+    }
+
     /**
-     * Updates and renders all entities managed by this RenderSystem.
-     * Filters entities by the required components, sorts them based on their
-     * z-index in ascending order, and renders each entity on the SDL_Renderer.
+     * Copies the sprites inside the camera view of the snapshot into it, in draw order.
+     * Refreshes the sort keys of the render queue and re-sorts it if any key changed.
+     * Runs with the simulation, the renderer is not touched.
      *
-     * @param renderer Pointer to SDL_Renderer used for rendering entities.
-     * @param assetManager Unique pointer to AssetManager for managing and accessing textures.
+     * @param assetManager Unique pointer to AssetManager, the texture regions are looked up in it by handle.
+     * @param snapshot Snapshot of the frame, its camera already set.
      */
-    void Update(SDL_Renderer* renderer,std::unique_ptr<AssetManager>& assetManager, SDL_Rect& camera)
+    void Capture(std::unique_ptr<AssetManager>& assetManager, RenderSnapshot& snapshot)
     {
-        struct RenderableEntity
+        if (numRemoved > 0)
         {
-            TransformComponent transformComponent;
-            SpriteComponent spriteComponent;
-        };
+            CompactQueue();
+        }
 
-        std::vector<RenderableEntity> renderableEntities;
+        for (const auto& texture : releasedTextures)
+        {
+            assetManager->ReleaseTexture(texture);
+        }
+        releasedTextures.clear();
 
-        for (auto entity : GetSystemEntity())
+        // Detect sprites whose z-index or texture changed since the last frame, a texture
+        // found for the first time also moves its sprites to their page
+        for (auto& item : renderQueue)
         {
-            RenderableEntity renderableEntity;
-            renderableEntity.spriteComponent = entity.GetComponent<SpriteComponent>();
-            renderableEntity.transformComponent = entity.GetComponent<TransformComponent>();
+            auto& sprite = registry->GetComponent<SpriteComponent>(Entity(item.entityId));
+            if (!assetManager->IsValid(sprite.texture))
+            {
+                sprite.texture = assetManager->GetTextureHandle(sprite.assetID);
+            }
+
+            TextureHandle& referencedTexture = referencedTextures[item.entityId];
+            if (referencedTexture != sprite.texture)
+            {
+                assetManager->ReleaseTexture(referencedTexture);
+                assetManager->AcquireTexture(sprite.texture);
+                referencedTexture = sprite.texture;
+            }
+
+            const uint64_t sortKey = MakeSortKey(sprite.zIndex, GetPageKey(assetManager, sprite.texture), GetTextureKey(sprite.texture));
+            isQueueDirty = isQueueDirty || sortKey != item.sortKey;
+            item.sortKey = sortKey;
+        }
+
+        // Sort entities by z-index to render in correct order
+        if (isQueueDirty)
+        {
+            GEngine::RadixSortByKey(renderQueue, sortScratch);
+            isQueueDirty = false;
+        }
+
+        const SDL_Rect& camera = snapshot.camera;
+        for (const auto& item : renderQueue)
+        {
+            const Entity entity(item.entityId);
+            const auto& transform = registry->GetComponent<TransformComponent>(entity);
+            const auto& sprite = registry->GetComponent<SpriteComponent>(entity);
 
             // bypass rendering entities if they are outside the camera view
             bool isEntityOutsideCameraView = 
             (
-                renderableEntity.transformComponent.position.x + (renderableEntity.transformComponent.scale.x * renderableEntity.spriteComponent.width) < camera.x ||
-                renderableEntity.transformComponent.position.x > camera.x  + camera.w ||
-                renderableEntity.transformComponent.position.y + (renderableEntity.transformComponent.scale.y * renderableEntity.spriteComponent.height) < camera.y ||
-                renderableEntity.transformComponent.position.y > camera.y + camera.h 
+                transform.position.x + (transform.scale.x * sprite.width) < camera.x ||
+                transform.position.x > camera.x  + camera.w ||
+                transform.position.y + (transform.scale.y * sprite.height) < camera.y ||
+                transform.position.y > camera.y + camera.h 
             );
 
-            if (isEntityOutsideCameraView && !renderableEntity.spriteComponent.isFixed) continue;
+            if (isEntityOutsideCameraView && !sprite.isFixed) continue;
 
-            renderableEntities.emplace_back(renderableEntity);
-        }
+            const TextureRegion& region = assetManager->GetTextureRegion(sprite.texture);
+            if (!region.texture)
+            {
+                // a texture still loading in the background is skipped quietly
+                if (!sprite.texture.IsSet())
+                {
+                    Logger::Err("Error loading texture " + sprite.assetID);
+                }
+                continue;
+            }
 
-        // Sort entities by z-index to render in correct order
-        std::sort(renderableEntities.begin(), renderableEntities.end(), 
-        [](const RenderableEntity& a, const RenderableEntity& b)
-        {
-            return a.spriteComponent.zIndex < b.spriteComponent.zIndex;            
-        });
+            SpriteDraw draw;
+            draw.texture = region.texture;
 
-        // Render each entity
-        for (auto entity : renderableEntities)
-        {
-            const auto transform = entity.transformComponent;
-            const auto sprite = entity.spriteComponent;
+            // the source rectangle is relative to the asset, move it to its place in the atlas page
+            draw.srcRect =
+            {
+                sprite.srcRect.x + region.rect.x,
+                sprite.srcRect.y + region.rect.y,
+                sprite.srcRect.w,
+                sprite.srcRect.h
+            };
+            draw.position = transform.position;
+            draw.size = glm::vec2(sprite.width * transform.scale.x, sprite.height * transform.scale.y);
+            draw.rotation = transform.rotation;
+            draw.flip = sprite.flip;
+            draw.isFixed = sprite.isFixed;
+            snapshot.sprites.push_back(draw);
+        }
+    }
 
-            const SDL_Rect srcRect = sprite.srcRect;
+    /**
+     * Renders the sprites of a snapshot, flushing the batch once per texture run.
+     *
+     * @param renderer Pointer to SDL_Renderer used for rendering entities.
+     * @param snapshot Snapshot filled by Capture.
+     */
+    void Render(SDL_Renderer* renderer, const RenderSnapshot& snapshot)
+    {
+        const SDL_Rect& camera = snapshot.camera;
+        spriteBatcher.Begin(renderer);
 
+        for (const auto& draw : snapshot.sprites)
+        {
             const SDL_Rect dstRect = 
             {
-                static_cast<int>(transform.position.x - (sprite.isFixed ? 0 : camera.x)),
-                static_cast<int>(transform.position.y - (sprite.isFixed ? 0 : camera.y)),
-                static_cast<int>(sprite.width * transform.scale.x),
-                static_cast<int>(sprite.height * transform.scale.y)
+                static_cast<int>(draw.position.x - (draw.isFixed ? 0 : camera.x)),
+                static_cast<int>(draw.position.y - (draw.isFixed ? 0 : camera.y)),
+                static_cast<int>(draw.size.x),
+                static_cast<int>(draw.size.y)
             };
 
-            const auto texture = assetManager->GetTexture(sprite.assetID);
-            if (!texture)
-            {
-                Logger::Err("Error loading texture " + sprite.assetID);
-                continue;
-            }
+            spriteBatcher.Draw(draw.texture, draw.srcRect, dstRect, draw.rotation, draw.flip);
+        }
+
+        spriteBatcher.End();
+    }
+
+    /**
+     * Batches, sprites and vertices submitted by the last Update
+     */
+    const SpriteBatchStats& GetBatchStats() const { return spriteBatcher.GetStats(); }
+
+private:
+    /**
+     * Packs the sort key, the z-index in the high 32 bits (sign bit flipped so negative
+     * values come first), then the key of the texture page and the texture key, so sprites
+     * of the same layer are grouped by page even when they use different packed assets.
+     */
+    static uint64_t MakeSortKey(int zIndex, uint16_t pageKey, uint16_t textureKey)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(zIndex) ^ 0x80000000u) << 32) |
+               (static_cast<uint64_t>(pageKey) << 16) |
+               static_cast<uint64_t>(textureKey);
+    }
 
-            SDL_RenderCopyEx(
-                renderer, 
-                texture,
-                &srcRect,
-                &dstRect,
-                transform.rotation,
-                NULL,
-                sprite.flip);
+    static constexpr uint16_t UNRESOLVED_KEY = 0xFFFF;
+
+    /**
+     * The texture key is the index of the handle, unresolved handles sort last in their layer
+     */
+    static uint16_t GetTextureKey(TextureHandle texture)
+    {
+        return texture.index < UNRESOLVED_KEY ? static_cast<uint16_t>(texture.index) : UNRESOLVED_KEY;
+    }
+
+    /**
+     * Key of the texture holding the asset, only searched again when the asset got a new texture
+     */
+    uint16_t GetPageKey(std::unique_ptr<AssetManager>& assetManager, TextureHandle texture)
+    {
+        const uint16_t textureKey = GetTextureKey(texture);
+        if (textureKey == UNRESOLVED_KEY)
+        {
+            return UNRESOLVED_KEY;
         }
+
+        if (textureKey >= pageKeys.size())
+        {
+            pageKeys.resize(textureKey + 1, UNRESOLVED_KEY);
+            keyedTextures.resize(textureKey + 1, nullptr);
+        }
+
+        SDL_Texture* pageTexture = assetManager->GetTextureRegion(texture).texture;
+        if (keyedTextures[textureKey] != pageTexture)
+        {
+            keyedTextures[textureKey] = pageTexture;
+            pageKeys[textureKey] = pageTexture ? FindPageKey(pageTexture) : UNRESOLVED_KEY;
+        }
+        return pageKeys[textureKey];
+    }
+
+    uint16_t FindPageKey(SDL_Texture* texture)
+    {
+        const auto it = std::find(pageTextures.begin(), pageTextures.end(), texture);
+        if (it != pageTextures.end())
+        {
+            return static_cast<uint16_t>(it - pageTextures.begin());
+        }
+
+        pageTextures.push_back(texture);
+        return static_cast<uint16_t>(pageTextures.size() - 1);
+    }
+
+    /**
+     * Drops the entries of the removed entities, keeping the order of the others
+     */
+    void CompactQueue()
+    {
+        renderQueue.erase(std::remove_if(renderQueue.begin(), renderQueue.end(), [this](const RenderItem& item)
+        {
+            return item.entityId < static_cast<int>(isRemoved.size()) && isRemoved[item.entityId];
+        }), renderQueue.end());
+
+        std::fill(isRemoved.begin(), isRemoved.end(), 0);
+        numRemoved = 0;
     }
 };
 
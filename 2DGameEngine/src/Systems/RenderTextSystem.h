@@ -5,9 +5,18 @@
 #include "../ECS/ECS.h"
 #include "../Components/TextRenderComponent.h"
 #include "../AssetManager/AssetManager.h"
+#include "../Renderer/TextRenderer.h"
+#include "../Renderer/RenderSnapshot.h"
 
 class RenderTextSystem : public System
 {
+    /**
+     * Per entity id, the font the label holds a reference to, and the references of the labels
+     * that left the system, dropped by the next Capture
+     */
+    std::vector<FontHandle> referencedFonts;
+    std::vector<FontHandle> releasedFonts;
+
 public:
     RenderTextSystem()
     {
@@ -15,36 +24,77 @@ public:
     }
 
 
-    void Update(SDL_Renderer* renderer, std::unique_ptr<AssetManager>& assetManager, const SDL_Rect& camera)
+    void RemoveEntityFromSystem(Entity entity) override
     {
-        for (auto entity : GetSystemEntity())
+        System::RemoveEntityFromSystem(entity);
+
+        if (entity.GetID() < static_cast<int>(referencedFonts.size()) && referencedFonts[entity.GetID()].IsSet())
         {
-            const auto textLabel = entity.GetComponent<TextRenderComponent>();
+            releasedFonts.push_back(referencedFonts[entity.GetID()]);
+            referencedFonts[entity.GetID()] = FontHandle();
+        }
+    }
 
-            SDL_Surface* surface = TTF_RenderText_Blended(
-                assetManager->GetFont(textLabel.assetId), 
-                textLabel.text.c_str(),
-                textLabel.color);
+    /**
+     * Copies the text labels into the snapshot, with the font of their handle.
+     */
+    void Capture(const std::unique_ptr<AssetManager>& assetManager, RenderSnapshot& snapshot)
+    {
+        for (const auto& font : releasedFonts)
+        {
+            assetManager->ReleaseFont(font);
+        }
+        releasedFonts.clear();
 
-            SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_FreeSurface(surface);
+        for (auto entity : GetSystemEntity())
+        {
+            auto& textLabel = entity.GetComponent<TextRenderComponent>();
+            if (!assetManager->IsValid(textLabel.font))
+            {
+                textLabel.font = assetManager->GetFontHandle(textLabel.assetId);
+            }
 
-            int labelWidth = 0;
-            int labelHeight = 0;
+            if (entity.GetID() >= static_cast<int>(referencedFonts.size()))
+            {
+                referencedFonts.resize(entity.GetID() + 1);
+            }
+            if (referencedFonts[entity.GetID()] != textLabel.font)
+            {
+                assetManager->ReleaseFont(referencedFonts[entity.GetID()]);
+                assetManager->AcquireFont(textLabel.font);
+                referencedFonts[entity.GetID()] = textLabel.font;
+            }
 
-            SDL_QueryTexture(texture, NULL, NULL, &labelWidth, &labelHeight);
+            TextDraw draw;
+            draw.font = assetManager->GetFont(textLabel.font);
+            draw.text = textLabel.text;
+            draw.position = textLabel.position;
+            draw.color = textLabel.color;
+            draw.isFixed = textLabel.isFixed;
+            snapshot.texts.push_back(std::move(draw));
+        }
+    }
 
-            SDL_Rect dstRect =
-            {
+    /**
+     * Labels rarely change, each one is drawn from the string texture cache of the text renderer,
+     * so a label is only rasterized again when its text, font or color changes.
+     */
+    void Render(SDL_Renderer* renderer, std::unique_ptr<TextRenderer>& textRenderer, const RenderSnapshot& snapshot)
+    {
+        const SDL_Rect& camera = snapshot.camera;
+        textRenderer->Begin(renderer);
+
+        for (const auto& textLabel : snapshot.texts)
+        {
+            textRenderer->DrawCachedText(
+                textLabel.font,
+                textLabel.text,
                 static_cast<int>(textLabel.position.x - (textLabel.isFixed ? 0 : camera.x)),
                 static_cast<int>(textLabel.position.y - (textLabel.isFixed ? 0 : camera.y)),
-                labelWidth,
-                labelHeight
-            };
-
-            SDL_RenderCopy(renderer, texture, NULL, &dstRect);
-            SDL_DestroyTexture(texture);
+                textLabel.color);
         }
+
+        textRenderer->End();
     }
 };
 
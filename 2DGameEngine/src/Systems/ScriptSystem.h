@@ -0,0 +1,447 @@
+#ifndef SCRIPTSYSTEM_H
+#define SCRIPTSYSTEM_H
+
+#include "../ECS/ECS.h"
+#include "../Components/ScriptComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Components/ProjectileEmitterComponent.h"
+#include "../Logger/Logger.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <SDL2/SDL.h>
+#include <sol/sol.hpp>
+
+/**
+ * Script statistics of the last frame.
+ */
+struct ScriptStats
+{
+    int scriptedEntities = 0;   /**< Entities with a script */
+    int updatedEntities = 0;    /**< Script updates run during the frame, over all its steps */
+    int deferredEntities = 0;   /**< Updates pushed to the next frame by the budget */
+    int batches = 0;            /**< Lua calls */
+    int gcSteps = 0;            /**< Incremental collector steps */
+    double scriptMs = 0.0;      /**< Time spent in the scripts */
+    double gcMs = 0.0;          /**< Time spent in the collector */
+    int memoryKB = 0;           /**< Memory of the Lua state */
+};
+
+/**
+ * ScriptSystem runs the Lua update functions of the scripted entities, the on_update_script
+ * functions of the level scripts, once per simulation step.
+ *
+ * Entities are updated in batches of SCRIPT_BATCH_SIZE with one Lua call per batch: the state the
+ * scripts read and write (position, velocity, rotation, projectile velocity) is copied into a flat
+ * Lua array, slot after slot, and a small Lua driver calls the function of every slot. The entity
+ * a script receives is its slot in the batch, get_position, set_velocity and the other accessors
+ * are Lua functions reading and writing the array, so a script never calls back into C++. The
+ * array is copied back to the components once the batch returns.
+ *
+ * The scripts of a frame have a time budget shared by the steps of the frame. Once it is spent the
+ * remaining entities wait for the next frame, which starts where this one stopped, and their next
+ * update gets the time elapsed since their last one. At least one batch runs every frame.
+ *
+ * Lua's automatic collector is stopped, so a collection never starts in the middle of a script,
+ * and the system runs it in steps of GC_STEP_KB with what the scripts left of the budget.
+ */
+class ScriptSystem : public System
+{
+public:
+    static constexpr int SCRIPT_BATCH_SIZE = 64;
+
+    /**
+     * Kilobytes of allocation paid by one incremental collector step
+     */
+    static constexpr int GC_STEP_KB = 16;
+
+    /**
+     * Lua memory, as a multiple of the memory left by the last full cycle, above which the
+     * collector steps until the end of its cycle whatever the budget
+     */
+    static constexpr int GC_MAX_GROWTH = 4;
+
+    ScriptSystem()
+    {
+        RequireComponent<ScriptComponent>();
+        RequireComponent<TransformComponent>();
+    }
+
+    /**
+     * Loads the batch driver and the accessors of the scripts into the state, before the level
+     * adds its scripts.
+     */
+    bool Initialize(sol::state& lua)
+    {
+        luaState = lua.lua_state();
+
+        sol::load_result driver = lua.load(DRIVER_SOURCE, "=ScriptSystem");
+        if (!driver.valid())
+        {
+            sol::error err = driver;
+            Logger::Err("Error loading the script driver: " + std::string(err.what()));
+            return false;
+        }
+
+        sol::protected_function_result result = driver(static_cast<int>(SSF_Count),
+            static_cast<int>(SSF_PositionX), static_cast<int>(SSF_PositionY),
+            static_cast<int>(SSF_VelocityX), static_cast<int>(SSF_VelocityY),
+            static_cast<int>(SSF_Rotation),
+            static_cast<int>(SSF_ProjectileVelocityX), static_cast<int>(SSF_ProjectileVelocityY),
+            static_cast<int>(SSF_DeltaTime), static_cast<int>(SSF_Script));
+        if (!result.valid())
+        {
+            sol::error err = result;
+            Logger::Err("Error running the script driver: " + std::string(err.what()));
+            return false;
+        }
+
+        updateBatch = result.get<sol::protected_function>(0);
+        slots = result.get<sol::table>(1);
+        scripts = result.get<sol::table>(2);
+        failures = result.get<sol::table>(3);
+        numScripts = 0;
+        return true;
+    }
+
+    /**
+     * Registers an update function, called as function(entity, delta_time, elapsed_time) with
+     * the delta time in seconds and the elapsed time in milliseconds.
+     *
+     * @return The script id of the ScriptComponent running it.
+     */
+    int AddScript(const sol::protected_function& function)
+    {
+        if (!luaState)
+        {
+            Logger::Err("The script system is not initialized");
+            return ScriptComponent::INVALID_SCRIPT;
+        }
+        scripts.raw_set(numScripts, function);
+        return numScripts++;
+    }
+
+    /**
+     * Takes over Lua's garbage collector: a full collection gets rid of what loading the level
+     * left, then the collector only runs in the steps of CollectGarbage.
+     */
+    void StopAutomaticGarbageCollection()
+    {
+        if (!luaState) return;
+
+        lua_gc(luaState, LUA_GCCOLLECT, 0);
+        lua_gc(luaState, LUA_GCSTOP, 0);
+        memoryAfterCycleKB = lua_gc(luaState, LUA_GCCOUNT, 0);
+    }
+
+    /**
+     * Starts the budget of a frame, the budget of the last one is reported in the stats.
+     *
+     * @param budgetMs Time the scripts and the collector may take during the frame.
+     */
+    void BeginFrame(double budgetMs)
+    {
+        budgetCounter = static_cast<Uint64>(budgetMs * SDL_GetPerformanceFrequency() / 1000.0);
+        usedCounter = 0;
+        hasRunBatch = false;
+
+        stats.updatedEntities = 0;
+        stats.deferredEntities = 0;
+        stats.batches = 0;
+        stats.gcSteps = 0;
+        stats.scriptMs = 0.0;
+        stats.gcMs = 0.0;
+    }
+
+    /**
+     * Updates the scripted entities, in batches from where the last update stopped, until every
+     * entity is updated or the budget of the frame is spent.
+     *
+     * @param deltaTime The step, in seconds.
+     * @param time Simulation time at the end of the step, in seconds.
+     */
+    void Update(double deltaTime, double time)
+    {
+        const std::vector<Entity> entities = GetSystemEntity();
+        const int numEntities = static_cast<int>(entities.size());
+        stats.scriptedEntities = numEntities;
+        if (!luaState || numEntities == 0) return;
+
+        if (nextEntity >= numEntities) nextEntity = 0;
+
+        int numVisited = 0;
+        while (numVisited < numEntities)
+        {
+            if (hasRunBatch && usedCounter >= budgetCounter)
+            {
+                stats.deferredEntities += numEntities - numVisited;
+                break;
+            }
+
+            const Uint64 start = SDL_GetPerformanceCounter();
+            const int numSlots = std::min(SCRIPT_BATCH_SIZE, numEntities - numVisited);
+            batchEntities.clear();
+            for (int i = 0; i < numSlots; i++)
+            {
+                const Entity& entity = entities[(nextEntity + i) % numEntities];
+                if (entity.GetComponent<ScriptComponent>().scriptId != ScriptComponent::INVALID_SCRIPT)
+                {
+                    batchEntities.push_back(entity);
+                }
+            }
+            numVisited += numSlots;
+            nextEntity = (nextEntity + numSlots) % numEntities;
+
+            RunBatch(deltaTime, time);
+
+            const Uint64 batchCounter = SDL_GetPerformanceCounter() - start;
+            usedCounter += batchCounter;
+            stats.scriptMs += batchCounter * 1000.0 / SDL_GetPerformanceFrequency();
+            hasRunBatch = true;
+        }
+    }
+
+    /**
+     * Runs incremental collector steps with what the scripts left of the budget of the frame, at
+     * least one, and more while the memory grows past GC_MAX_GROWTH times its last low.
+     */
+    void CollectGarbage()
+    {
+        if (!luaState) return;
+
+        const Uint64 start = SDL_GetPerformanceCounter();
+        const Uint64 remainingCounter = budgetCounter > usedCounter ? budgetCounter - usedCounter : 0;
+        const int memoryLimitKB = GC_MAX_GROWTH * std::max(memoryAfterCycleKB, 1024);
+
+        Uint64 elapsedCounter = 0;
+        do
+        {
+            stats.gcSteps++;
+            if (lua_gc(luaState, LUA_GCSTEP, GC_STEP_KB))
+            {
+                // the cycle is over, what is left is alive
+                memoryAfterCycleKB = lua_gc(luaState, LUA_GCCOUNT, 0);
+                elapsedCounter = SDL_GetPerformanceCounter() - start;
+                break;
+            }
+            elapsedCounter = SDL_GetPerformanceCounter() - start;
+        }
+        while (elapsedCounter < remainingCounter || lua_gc(luaState, LUA_GCCOUNT, 0) > memoryLimitKB);
+
+        usedCounter += elapsedCounter;
+        stats.gcMs = elapsedCounter * 1000.0 / SDL_GetPerformanceFrequency();
+        stats.memoryKB = lua_gc(luaState, LUA_GCCOUNT, 0);
+    }
+
+    const ScriptStats& GetStats() const { return stats; }
+
+private:
+    /**
+     * Fields of a slot, 1-based like the Lua array: slot i spans [i * SSF_Count + 1, (i + 1) * SSF_Count]
+     */
+    enum EScriptSlotField
+    {
+        SSF_PositionX = 1,
+        SSF_PositionY,
+        SSF_VelocityX,
+        SSF_VelocityY,
+        SSF_Rotation,
+        SSF_ProjectileVelocityX,
+        SSF_ProjectileVelocityY,
+        SSF_DeltaTime,
+        SSF_Script,
+        SSF_Count = SSF_Script
+    };
+
+    /**
+     * Runs with the slot layout as arguments, returns the batch function, the slot array, the
+     * script table and the failure list
+     */
+    static constexpr const char* DRIVER_SOURCE = R"lua(
+        local STRIDE, POSITION_X, POSITION_Y, VELOCITY_X, VELOCITY_Y, ROTATION,
+            PROJECTILE_VELOCITY_X, PROJECTILE_VELOCITY_Y, DELTA_TIME, SCRIPT = ...
+        local slots, scripts, failures = {}, {}, {}
+        local pcall, tostring = pcall, tostring
+
+        function get_position(entity)
+            local base = entity * STRIDE
+            return slots[base + POSITION_X], slots[base + POSITION_Y]
+        end
+
+        function set_position(entity, x, y)
+            local base = entity * STRIDE
+            slots[base + POSITION_X], slots[base + POSITION_Y] = x, y
+        end
+
+        function get_velocity(entity)
+            local base = entity * STRIDE
+            return slots[base + VELOCITY_X], slots[base + VELOCITY_Y]
+        end
+
+        function set_velocity(entity, x, y)
+            local base = entity * STRIDE
+            slots[base + VELOCITY_X], slots[base + VELOCITY_Y] = x, y
+        end
+
+        function get_rotation(entity)
+            return slots[entity * STRIDE + ROTATION]
+        end
+
+        function set_rotation(entity, angle)
+            slots[entity * STRIDE + ROTATION] = angle
+        end
+
+        function set_projectile_velocity(entity, x, y)
+            local base = entity * STRIDE
+            slots[base + PROJECTILE_VELOCITY_X], slots[base + PROJECTILE_VELOCITY_Y] = x, y
+        end
+
+        local function update_batch(count, elapsed_time)
+            local numFailures = 0
+            for entity = 0, count - 1 do
+                local base = entity * STRIDE
+                local ok, message = pcall(scripts[slots[base + SCRIPT]], entity, slots[base + DELTA_TIME], elapsed_time)
+                if not ok then
+                    failures[numFailures * 2 + 1] = entity
+                    failures[numFailures * 2 + 2] = tostring(message)
+                    numFailures = numFailures + 1
+                end
+            end
+            return numFailures
+        end
+
+        return update_batch, slots, scripts, failures
+    )lua";
+
+    /**
+     * Copies the batch entities to the slots, runs their scripts and copies the slots back
+     */
+    void RunBatch(double deltaTime, double time)
+    {
+        const int numSlots = static_cast<int>(batchEntities.size());
+        if (numSlots == 0) return;
+
+        slots.push();
+        for (int slot = 0; slot < numSlots; slot++)
+        {
+            const Entity& entity = batchEntities[slot];
+            const auto& script = entity.GetComponent<ScriptComponent>();
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const glm::vec2 velocity = entity.HasComponent<RigidBodyComponent>() ? entity.GetComponent<RigidBodyComponent>().velocity : glm::vec2(0);
+            const glm::vec2 projectileVelocity = entity.HasComponent<ProjectileEmitterComponent>() ? entity.GetComponent<ProjectileEmitterComponent>().projectileVelocity : glm::vec2(0);
+
+            // an entity the budget held back gets all the time elapsed since its last update
+            const double scriptDeltaTime = script.lastUpdateTime < 0.0 ? deltaTime : time - script.lastUpdateTime;
+
+            const int base = slot * SSF_Count;
+            SetSlotField(base + SSF_PositionX, transform.position.x);
+            SetSlotField(base + SSF_PositionY, transform.position.y);
+            SetSlotField(base + SSF_VelocityX, velocity.x);
+            SetSlotField(base + SSF_VelocityY, velocity.y);
+            SetSlotField(base + SSF_Rotation, transform.rotation);
+            SetSlotField(base + SSF_ProjectileVelocityX, projectileVelocity.x);
+            SetSlotField(base + SSF_ProjectileVelocityY, projectileVelocity.y);
+            SetSlotField(base + SSF_DeltaTime, scriptDeltaTime);
+            SetSlotField(base + SSF_Script, script.scriptId);
+        }
+        lua_pop(luaState, 1);
+
+        // the scripts see the elapsed time in milliseconds
+        sol::protected_function_result result = updateBatch(numSlots, time * 1000.0);
+        stats.batches++;
+        stats.updatedEntities += numSlots;
+        if (!result.valid())
+        {
+            sol::error err = result;
+            Logger::Err("Error running the entity scripts: " + std::string(err.what()));
+            return;
+        }
+
+        slots.push();
+        for (int slot = 0; slot < numSlots; slot++)
+        {
+            const Entity& entity = batchEntities[slot];
+            auto& transform = entity.GetComponent<TransformComponent>();
+            const int base = slot * SSF_Count;
+
+            transform.position.x = static_cast<float>(GetSlotField(base + SSF_PositionX));
+            transform.position.y = static_cast<float>(GetSlotField(base + SSF_PositionY));
+            transform.rotation = GetSlotField(base + SSF_Rotation);
+            if (entity.HasComponent<RigidBodyComponent>())
+            {
+                auto& rigidBody = entity.GetComponent<RigidBodyComponent>();
+                rigidBody.velocity.x = static_cast<float>(GetSlotField(base + SSF_VelocityX));
+                rigidBody.velocity.y = static_cast<float>(GetSlotField(base + SSF_VelocityY));
+            }
+            if (entity.HasComponent<ProjectileEmitterComponent>())
+            {
+                auto& projectileEmitter = entity.GetComponent<ProjectileEmitterComponent>();
+                projectileEmitter.projectileVelocity.x = static_cast<float>(GetSlotField(base + SSF_ProjectileVelocityX));
+                projectileEmitter.projectileVelocity.y = static_cast<float>(GetSlotField(base + SSF_ProjectileVelocityY));
+            }
+            entity.GetComponent<ScriptComponent>().lastUpdateTime = time;
+        }
+        lua_pop(luaState, 1);
+
+        // a script that failed is reported once and not run again
+        const int numFailures = result;
+        for (int failure = 0; failure < numFailures; failure++)
+        {
+            const int slot = failures.raw_get<int>(failure * 2 + 1);
+            const std::string message = failures.raw_get<std::string>(failure * 2 + 2);
+            if (slot < 0 || slot >= numSlots) continue;
+
+            Entity& entity = batchEntities[slot];
+            Logger::Err("Error running the script of entity " + std::to_string(entity.GetID()) + ", the script is disabled: " + message);
+            entity.GetComponent<ScriptComponent>().scriptId = ScriptComponent::INVALID_SCRIPT;
+        }
+    }
+
+    /**
+     * Slot array accessors, the array is on the top of the stack
+     */
+    void SetSlotField(int index, double value)
+    {
+        lua_pushnumber(luaState, value);
+        lua_rawseti(luaState, -2, index);
+    }
+
+    double GetSlotField(int index)
+    {
+        lua_rawgeti(luaState, -1, index);
+        const double value = lua_tonumber(luaState, -1);
+        lua_pop(luaState, 1);
+        return value;
+    }
+
+    lua_State* luaState = nullptr;
+    sol::protected_function updateBatch;
+    sol::table slots;
+    sol::table scripts;
+    sol::table failures;
+    int numScripts = 0;
+
+    /**
+     * Entities of the batch being run, reused between batches
+     */
+    std::vector<Entity> batchEntities;
+
+    /**
+     * Next entity to update, the following frame starts there when the budget stops one
+     */
+    int nextEntity = 0;
+
+    /**
+     * Budget of the frame and time spent so far, in performance counter ticks
+     */
+    Uint64 budgetCounter = 0;
+    Uint64 usedCounter = 0;
+    bool hasRunBatch = false;
+
+    int memoryAfterCycleKB = 0;
+
+    ScriptStats stats;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TILECOLLISIONSYSTEM_H
+#define TILECOLLISIONSYSTEM_H
+
+#include "../ECS/ECS.h"
+#include "../EventBus/EventBus.h"
+#include "../Events/TileCollisionEvent.h"
+#include "../Components/BoxColliderComponent.h"
+#include "../Components/TransformComponent.h"
+#include "../Components/RigidBodyComponent.h"
+#include "../Collision/TileCollisionGrid.h"
+#include "../Collision/CollisionLayerMatrix.h"
+
+/**
+ * Tests moving colliders against the static tile collision grid of the level.
+ * Only entities with a RigidBodyComponent are tested, each one by looking up the cells
+ * its box covers, and a TileCollisionEvent is emitted when it starts touching a solid tile.
+ */
+class TileCollisionSystem : public System
+{
+    TileCollisionGrid grid;
+
+    /**
+     * Mask of the collision layers the tile grid collides with
+     */
+    uint32_t collidingLayers = 0xFFFFFFFFu;
+
+    /**
+     * Per entity id, set while the entity is touching a solid tile
+     */
+    std::vector<char> isTouchingTile;
+
+public:
+    TileCollisionSystem()
+    {
+        RequireComponent<TransformComponent>();
+        RequireComponent<BoxCollisionComponent>();
+        RequireComponent<RigidBodyComponent>();
+    }
+
+    TileCollisionGrid& GetGrid() { return grid; }
+
+    void SetCollidingLayers(uint32_t layerMask) { collidingLayers = layerMask; }
+
+    void RemoveEntityFromSystem(Entity entity) override
+    {
+        System::RemoveEntityFromSystem(entity);
+
+        if (entity.GetID() < static_cast<int>(isTouchingTile.size()))
+        {
+            isTouchingTile[entity.GetID()] = 0;
+        }
+    }
+
+    void Update(std::unique_ptr<EventBus>& eventBus)
+    {
+        if (grid.IsEmpty()) return;
+
+        for (auto entity : GetSystemEntity())
+        {
+            const auto& collider = entity.GetComponent<BoxCollisionComponent>();
+            if ((collidingLayers & CollisionLayerMatrix::GetLayerBit(collider.layer)) == 0) continue;
+
+            const auto& transform = entity.GetComponent<TransformComponent>();
+            const float x = transform.position.x + collider.offset.x;
+            const float y = transform.position.y + collider.offset.y;
+
+            int tileCol = 0;
+            int tileRow = 0;
+            const bool isTouching = grid.OverlapsSolid(AABB{ x, y, x + collider.width, y + collider.height }, tileCol, tileRow);
+
+            const int entityId = entity.GetID();
+            if (entityId >= static_cast<int>(isTouchingTile.size()))
+            {
+                isTouchingTile.resize(entityId + 1, 0);
+            }
+
+            if (isTouching && !isTouchingTile[entityId])
+            {
+                eventBus->EmitEvent<TileCollisionEvent>(entity, tileCol, tileRow);
+            }
+
+            isTouchingTile[entityId] = isTouching;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TRANSFORMINTERPOLATIONSYSTEM_H
+#define TRANSFORMINTERPOLATIONSYSTEM_H
+
+#include "../ECS/ECS.h"
+#include "../Components/TransformComponent.h"
+#include <vector>
+
+/**
+ * TransformInterpolationSystem smooths the rendering of a fixed-timestep simulation.
+ *
+ * Before every simulation step the current transform is saved as the previous one. Before
+ * rendering, the transforms are moved between the previous and the current state by the
+ * fraction of step left in the accumulator, and put back to the simulated state after the
+ * frame, so the render systems draw interpolated positions without knowing about it.
+ */
+class TransformInterpolationSystem : public System
+{
+    /**
+     * Simulated state of the transforms while the interpolated one is rendered
+     */
+    struct SimulatedState
+    {
+        Entity entity;
+        glm::vec2 position;
+        double rotation;
+    };
+
+    std::vector<SimulatedState> simulatedStates;
+
+public:
+    TransformInterpolationSystem()
+    {
+        RequireComponent<TransformComponent>();
+    }
+
+    /**
+     * Saves the current transforms as the previous state, called before each simulation step.
+     */
+    void StoreStates()
+    {
+        for (auto entity : GetSystemEntity())
+        {
+            auto& transform = entity.GetComponent<TransformComponent>();
+            transform.previousPosition = transform.position;
+            transform.previousRotation = transform.rotation;
+        }
+    }
+
+    /**
+     * Moves the transforms to the blend of their previous and current state.
+     *
+     * @param alpha Fraction of a simulation step elapsed since the last step, in [0, 1].
+     */
+    void Interpolate(double alpha)
+    {
+        simulatedStates.clear();
+
+        for (auto entity : GetSystemEntity())
+        {
+            auto& transform = entity.GetComponent<TransformComponent>();
+            if (transform.position == transform.previousPosition && transform.rotation == transform.previousRotation)
+            {
+                continue;
+            }
+
+            simulatedStates.push_back({ entity, transform.position, transform.rotation });
+            transform.position = glm::mix(transform.previousPosition, transform.position, static_cast<float>(alpha));
+            transform.rotation = transform.previousRotation + (transform.rotation - transform.previousRotation) * alpha;
+        }
+    }
+
+    /**
+     * Puts back the simulated state saved by Interpolate.
+     */
+    void Restore()
+    {
+        for (const auto& state : simulatedStates)
+        {
+            auto& transform = state.entity.GetComponent<TransformComponent>();
+            transform.position = state.position;
+            transform.rotation = state.rotation;
+        }
+        simulatedStates.clear();
+    }
+};
+
+#endif
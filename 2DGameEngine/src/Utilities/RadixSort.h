@@ -0,0 +1,83 @@
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace GEngine
+{
+    /**
+     * @brief Sorts items by their 64 bit `sortKey` member with a stable LSD radix sort.
+     *
+     * Runs one counting pass per key byte and skips the bytes that are equal in every key,
+     * so keys that only use a few bits cost only a few passes. No comparison is done and no
+     * memory is allocated once the scratch buffer has grown to the size of the items.
+     *
+     * @tparam T The item type, must have a `uint64_t sortKey` member and be copy assignable.
+     * @param items The items to sort in place.
+     * @param scratch A buffer reused between calls to avoid allocations.
+     */
+    template<typename T>
+    void RadixSortByKey(std::vector<T>& items, std::vector<T>& scratch)
+    {
+        const size_t count = items.size();
+        if (count < 2) return;
+
+        if (scratch.size() < count)
+        {
+            scratch.resize(count);
+        }
+
+        // Bits that differ between at least two keys, used to skip useless passes
+        uint64_t allOnes = ~uint64_t(0);
+        uint64_t allZeros = 0;
+        for (const auto& item : items)
+        {
+            allOnes &= item.sortKey;
+            allZeros |= item.sortKey;
+        }
+        const uint64_t varyingBits = allOnes ^ allZeros;
+
+        T* source = items.data();
+        T* destination = scratch.data();
+
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            if (((varyingBits >> shift) & 0xFF) == 0) continue;
+
+            size_t offsets[256] = {0};
+            for (size_t i = 0; i < count; i++)
+            {
+                offsets[(source[i].sortKey >> shift) & 0xFF]++;
+            }
+
+            size_t total = 0;
+            for (size_t bucket = 0; bucket < 256; bucket++)
+            {
+                const size_t bucketCount = offsets[bucket];
+                offsets[bucket] = total;
+                total += bucketCount;
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                destination[offsets[(source[i].sortKey >> shift) & 0xFF]++] = source[i];
+            }
+
+            T* swap = source;
+            source = destination;
+            destination = swap;
+        }
+
+        if (source != items.data())
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                items[i] = source[i];
+            }
+        }
+    }
+}
+
+#endif
@@ -6,7 +6,13 @@
 #if defined(_WIN32)
     int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nShowCmd)
     {		
-		Game game;
+		GameSettings settings;
+		if (!GameSettings::ParseCommandLine(__argc, __argv, settings))
+		{
+			return 1;
+		}
+
+		Game game(settings);
 	
 		game.Initialize();
 		game.Run();
@@ -30,11 +36,13 @@ void TestLua()
 #if defined(__linux__) || defined(__APPLE__)
     int main(int argc, char* argv[])
     {
-		// unused params 
-		(void)argc;
-		(void)argv;
+		GameSettings settings;
+		if (!GameSettings::ParseCommandLine(argc, argv, settings))
+		{
+			return 1;
+		}
 
-		Game game;
+		Game game(settings);
 	
 		game.Initialize();
 		game.Run();
@@ -0,0 +1,186 @@
+#include "../src/AssetManager/AssetArchive.h"
+#include "../src/Logger/Logger.h"
+#include "SDL2/SDL_image.h"
+#include <lua/lua.hpp>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/**
+ * Offline packer of the asset archive read by the game (see AssetArchive).
+ *
+ *   assetpacker [--format argb8888|abgr8888|rgba8888] [--strip] ASSETS_DIR ARCHIVE
+ *
+ * Images are decoded and converted to the texture format, ARGB8888 by default, the native
+ * format of the OpenGL, Direct3D and software renderers. Fonts, tilemaps and compiled levels
+ * are copied as they are, Lua scripts are compiled to bytecode, without debug information with
+ * --strip. Other files, such as sounds, are left out.
+ */
+namespace
+{
+    bool ReadFile(const std::string& path, std::vector<char>& outBytes)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        outBytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    int WriteChunk(lua_State*, const void* bytes, size_t size, void* userData)
+    {
+        std::vector<char>* chunk = static_cast<std::vector<char>*>(userData);
+        const char* begin = static_cast<const char*>(bytes);
+        chunk->insert(chunk->end(), begin, begin + size);
+        return 0;
+    }
+
+    /**
+     * Compiles the script without running it
+     */
+    bool CompileScript(const std::string& path, bool isStripped, std::vector<char>& outChunk)
+    {
+        lua_State* state = luaL_newstate();
+        bool isCompiled = luaL_loadfile(state, path.c_str()) == LUA_OK;
+        if (isCompiled)
+        {
+            outChunk.clear();
+            isCompiled = lua_dump(state, WriteChunk, &outChunk, isStripped ? 1 : 0) == 0;
+        }
+        else
+        {
+            Logger::Err(lua_tostring(state, -1));
+        }
+        lua_close(state);
+        return isCompiled;
+    }
+
+    bool ParseFormat(const std::string& name, Uint32& outFormat)
+    {
+        if (name == "argb8888") outFormat = SDL_PIXELFORMAT_ARGB8888;
+        else if (name == "abgr8888") outFormat = SDL_PIXELFORMAT_ABGR8888;
+        else if (name == "rgba8888") outFormat = SDL_PIXELFORMAT_RGBA8888;
+        else return false;
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Uint32 pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+    bool isStripped = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--format" && i + 1 < argc)
+        {
+            if (!ParseFormat(argv[++i], pixelFormat))
+            {
+                Logger::Err("Unknown pixel format: " + std::string(argv[i]));
+                return 1;
+            }
+        }
+        else if (argument == "--strip")
+        {
+            isStripped = true;
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    if (paths.size() != 2)
+    {
+        Logger::Err("Usage: assetpacker [--format argb8888|abgr8888|rgba8888] [--strip] ASSETS_DIR ARCHIVE");
+        return 1;
+    }
+
+    std::error_code error;
+    std::vector<std::filesystem::path> files;
+    for (const auto& file : std::filesystem::recursive_directory_iterator(paths[0], error))
+    {
+        if (file.is_regular_file())
+        {
+            files.push_back(file.path());
+        }
+    }
+    if (error)
+    {
+        Logger::Err("Error reading the asset directory " + paths[0] + ": " + error.message());
+        return 1;
+    }
+
+    // same input, same archive
+    std::sort(files.begin(), files.end());
+
+    IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+
+    AssetArchiveWriter writer;
+    int numFailed = 0;
+    std::vector<char> bytes;
+
+    for (const auto& file : files)
+    {
+        const std::string path = file.generic_string();
+        std::string extension = file.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        bool isPacked = true;
+        if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp")
+        {
+            SDL_Surface* surface = IMG_Load(path.c_str());
+            isPacked = surface && writer.AddTexture(path, surface, pixelFormat);
+            SDL_FreeSurface(surface);
+        }
+        else if (extension == ".ttf" || extension == ".otf")
+        {
+            isPacked = ReadFile(path, bytes);
+            if (isPacked) writer.AddBlob(path, AET_Font, bytes.data(), bytes.size());
+        }
+        else if (extension == ".map")
+        {
+            isPacked = ReadFile(path, bytes);
+            if (isPacked) writer.AddBlob(path, AET_Tilemap, bytes.data(), bytes.size());
+        }
+        else if (extension == ".level")
+        {
+            isPacked = ReadFile(path, bytes);
+            if (isPacked) writer.AddBlob(path, AET_Level, bytes.data(), bytes.size());
+        }
+        else if (extension == ".lua")
+        {
+            isPacked = CompileScript(path, isStripped, bytes);
+            if (isPacked) writer.AddBlob(path, AET_Script, bytes.data(), bytes.size());
+        }
+        else
+        {
+            Logger::Log("Skipped " + path);
+            continue;
+        }
+
+        if (!isPacked)
+        {
+            Logger::Err("Error packing " + path);
+            numFailed++;
+        }
+    }
+
+    IMG_Quit();
+
+    if (!writer.Save(paths[1]))
+    {
+        return 1;
+    }
+
+    Logger::Log("Packed " + std::to_string(writer.GetNumEntries()) + " assets in " + paths[1] + " as " + SDL_GetPixelFormatName(pixelFormat));
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,88 @@
+#include "../src/Game/LevelData.h"
+#include "../src/Logger/Logger.h"
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <sol/sol.hpp>
+
+/**
+ * Offline compiler of the level scripts into compiled levels (see LevelData).
+ *
+ *   levelcompiler SCRIPT [COMPILED_LEVEL]
+ *
+ * The script runs once, with the libraries the game opens, and the Level table it builds is
+ * saved with its tiles next to the script, Level1.lua giving Level1.level. Whatever the script
+ * computes while running, such as a tileset picked by the time of day or random values, is
+ * frozen in the compiled level: leave such levels uncompiled to keep them dynamic.
+ *
+ * Entity scripts (on_update_script) are Lua functions, the compiled level only keeps where they
+ * are in the Level table. The game runs the level script to look them up again when it loads such
+ * a level, so the script has to ship with it.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        Logger::Err("Usage: levelcompiler SCRIPT [COMPILED_LEVEL]");
+        return 1;
+    }
+
+    const std::string scriptPath = argv[1];
+    std::string compiledPath = argc == 3 ? argv[2] : scriptPath;
+    if (argc == 2)
+    {
+        const size_t extension = compiledPath.rfind(".lua");
+        if (extension != std::string::npos)
+        {
+            compiledPath.erase(extension);
+        }
+        compiledPath += ".level";
+    }
+
+    sol::state lua;
+    lua.open_libraries(sol::lib::base, sol::lib::math, sol::lib::os);
+
+    sol::load_result script = lua.load_file(scriptPath);
+    if (!script.valid())
+    {
+        sol::error err = script;
+        Logger::Err("Error loading the lua script: " + std::string(err.what()));
+        return 1;
+    }
+
+    sol::protected_function_result scriptResult = script();
+    if (!scriptResult.valid())
+    {
+        sol::error err = scriptResult;
+        Logger::Err("Error running the lua script: " + std::string(err.what()));
+        return 1;
+    }
+
+    LevelData level;
+    if (!level.ReadTable(lua["Level"]))
+    {
+        return 1;
+    }
+
+    std::ifstream mapFile(level.GetMapFile(), std::ios::binary);
+    if (!mapFile)
+    {
+        Logger::Err("Error opening the map file " + level.GetMapFile());
+        return 1;
+    }
+    const std::string mapText((std::istreambuf_iterator<char>(mapFile)), std::istreambuf_iterator<char>());
+    if (!level.ReadTiles(mapText.data(), mapText.size()))
+    {
+        return 1;
+    }
+
+    if (!level.Save(compiledPath))
+    {
+        return 1;
+    }
+
+    Logger::Log("Compiled " + scriptPath + " into " + compiledPath + ": " + std::to_string(level.assets.size()) + " assets, " +
+        std::to_string(level.tiles.size()) + " tiles, " + std::to_string(level.decorations.size()) + " decorations, " +
+        std::to_string(level.numEntities) + " entities, " + std::to_string(level.scriptReferences.size()) + " entity scripts");
+    return 0;
+}